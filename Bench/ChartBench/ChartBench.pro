@@ -0,0 +1,32 @@
+QT = core gui widgets charts testlib
+
+TARGET = ChartBench
+TEMPLATE = app
+
+CONFIG += c++20
+CONFIG += static
+CONFIG += testcase
+
+INCLUDEPATH += $$PWD/../../Src
+
+HEADERS += \
+    ../../Src/candlestickchart.h \
+    ../../Src/indicatorengine.h \
+    ../../Src/interntable.h \
+    ../../Src/klinebuffer.h \
+    ../../Src/profiler.h
+
+SOURCES += \
+    chartbench.cpp \
+    ../../Src/candlestickchart.cpp \
+    ../../Src/indicatorengine.cpp \
+    ../../Src/interntable.cpp \
+    ../../Src/klinebuffer.cpp \
+    ../../Src/profiler.cpp
+
+QMAKE_CXXFLAGS += -O2 -fexceptions
+QMAKE_LFLAGS += -fexceptions
+
+#inlude addition library
+include($$PWD/../../../../Common/Common/Common.pri)
+include($$PWD/../../../TradingCatCommon/TradingCatCommon.pri)
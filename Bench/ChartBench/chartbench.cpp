@@ -0,0 +1,350 @@
+//STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+
+//Qt
+#include <QtTest>
+#include <QPixmap>
+#include <QDateTime>
+#include <QChart>
+#include <QChartView>
+#include <QCandlestickSeries>
+#include <QCandlestickSet>
+#include <QDateTimeAxis>
+#include <QValueAxis>
+
+//My
+#include <TradingCatCommon/kline.h>
+
+#include "klinebuffer.h"
+#include "candlestickchart.h"
+
+using namespace TradingCatCommon;
+
+static const QSize CHART_SIZE(800, 400);
+constexpr static const qint64 KLINE_DURATION = static_cast<qint64>(KLineType::MIN1);
+
+/*!
+    Сравнение отрисовки графика свечей CandlestickChart с прежней отрисовкой через QtCharts
+    (две серии QCandlestickSeries: цена и объем) на 30, 120 и максимальном количестве свечей.
+    Для каждого способа замеряется полная перестройка графика под новое событие и обновление
+    последней свечи. Время включает подготовку данных и отрисовку в QPixmap
+*/
+class ChartBench
+    : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void customRebuild_data();
+    void customRebuild();
+    void customUpdate_data();
+    void customUpdate();
+
+    void qtChartsRebuild_data();
+    void qtChartsRebuild();
+    void qtChartsUpdate_data();
+    void qtChartsUpdate();
+
+private:
+    static void addCountRows();
+
+    /*!
+        @param count - количество свечей
+        @param seed - начальное значение генератора цен
+        @return свечи MIN1 со случайным блужданием цены. Первая - самая новая
+    */
+    static PKLinesList makeKLines(qsizetype count, unsigned int seed);
+
+    /*!
+        @return копия свечей с измененной самой новой свечой, как при поступлении новых данных
+    */
+    static PKLinesList updateLast(const PKLinesList& klines, float delta);
+
+    static PKLineBuffer makeBuffer(const PKLinesList& klines, const CandlestickChart& chart);
+
+    static QChartView* makeChartView();
+    static void showQtCharts(QChartView* chartView, const PKLinesList& klines);
+};
+
+void ChartBench::addCountRows()
+{
+    QTest::addColumn<qsizetype>("count");
+
+    QTest::newRow("30") << qsizetype(30);
+    QTest::newRow("120") << qsizetype(120);
+    QTest::newRow("max") << static_cast<qsizetype>(KLINES_COUNT_HISTORY);
+}
+
+PKLinesList ChartBench::makeKLines(qsizetype count, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::normal_distribution<float> step(0.0f, 0.002f);
+    std::uniform_real_distribution<float> volume(10.0f, 1000.0f);
+
+    const KLineID klineId(Symbol("BTCUSDT"), KLineType::MIN1);
+    const auto lastTime = QDateTime::currentMSecsSinceEpoch() / KLINE_DURATION * KLINE_DURATION;
+
+    auto klines = std::make_shared<KLinesList>();
+    auto price = 100.0f;
+    for (qsizetype index = 0; index < count; ++index)
+    {
+        auto kline = std::make_shared<KLine>();
+        kline->id = klineId;
+        kline->closeTime = lastTime - index * KLINE_DURATION;
+        kline->close = price;
+        kline->open = price * (1.0f + step(generator));
+        kline->high = std::max(kline->open, kline->close) * (1.0f + std::abs(step(generator)));
+        kline->low = std::min(kline->open, kline->close) * (1.0f - std::abs(step(generator)));
+        kline->volume = volume(generator);
+
+        price = kline->open;
+
+        klines->push_back(std::move(kline));
+    }
+
+    return klines;
+}
+
+PKLinesList ChartBench::updateLast(const PKLinesList &klines, float delta)
+{
+    auto result = std::make_shared<KLinesList>(*klines);
+
+    auto kline = std::make_shared<KLine>(*result->front());
+    kline->close += delta;
+    kline->high = std::max(kline->high, kline->close);
+    kline->low = std::min(kline->low, kline->close);
+    kline->volume += 1.0f;
+    result->front() = std::move(kline);
+
+    return result;
+}
+
+PKLineBuffer ChartBench::makeBuffer(const PKLinesList &klines, const CandlestickChart &chart)
+{
+    return std::make_shared<const KLineBuffer>(KLineBuffer::fromKLines(klines, static_cast<qsizetype>(klines->size())).downsample(chart.maxKLinesCount()));
+}
+
+void ChartBench::customRebuild_data()
+{
+    addCountRows();
+}
+
+void ChartBench::customRebuild()
+{
+    QFETCH(qsizetype, count);
+
+    CandlestickChart chart;
+    chart.resize(CHART_SIZE);
+
+    //два разных события, чтобы каждый шаг перестраивал оси и оба слоя
+    const std::array<PKLinesList, 2> klines = {makeKLines(count, 1), makeKLines(count, 2)};
+    qsizetype step = 0;
+
+    QBENCHMARK
+    {
+        chart.setTitle(QString("Event %1").arg(step));
+        chart.setKLines(makeBuffer(klines[step % 2], chart));
+        chart.grab();
+
+        ++step;
+    }
+}
+
+void ChartBench::customUpdate_data()
+{
+    addCountRows();
+}
+
+void ChartBench::customUpdate()
+{
+    QFETCH(qsizetype, count);
+
+    CandlestickChart chart;
+    chart.resize(CHART_SIZE);
+
+    //изменения не выходят за диапазоны осей, поэтому перерисовывается только столбец последней свечи
+    const auto klines = makeKLines(count, 1);
+    const std::array<PKLinesList, 2> updated = {updateLast(klines, 0.0001f), updateLast(klines, -0.0001f)};
+
+    chart.setKLines(makeBuffer(klines, chart));
+    chart.grab();
+
+    qsizetype step = 0;
+
+    QBENCHMARK
+    {
+        chart.setKLines(makeBuffer(updated[step % 2], chart));
+        chart.grab();
+
+        ++step;
+    }
+}
+
+QChartView *ChartBench::makeChartView()
+{
+    //настройки повторяют прежний график на QtCharts
+    auto series = new QCandlestickSeries;
+    series->setIncreasingColor(QColor(Qt::green));
+    series->setDecreasingColor(QColor(Qt::red));
+    series->setBodyOutlineVisible(true);
+    series->setBodyWidth(0.7);
+    series->setCapsVisible(true);
+    series->setCapsWidth(0.5);
+    series->setMinimumColumnWidth(-1.0);
+    series->setMaximumColumnWidth(50.0);
+    auto pen = series->pen();
+    pen.setColor(Qt::white);
+    series->setPen(pen);
+
+    auto volumeSeries = new QCandlestickSeries;
+    volumeSeries->setIncreasingColor(QColor(61, 56, 70));
+    volumeSeries->setDecreasingColor(QColor(61, 56, 70));
+    volumeSeries->setBodyOutlineVisible(true);
+    volumeSeries->setCapsVisible(true);
+    volumeSeries->setMinimumColumnWidth(-1.0);
+    volumeSeries->setMaximumColumnWidth(50.0);
+    volumeSeries->setCapsWidth(0.3);
+    volumeSeries->setBodyWidth(0.5);
+    volumeSeries->setPen(pen);
+
+    auto chart = new QChart;
+    chart->addSeries(volumeSeries);
+    chart->addSeries(series);
+    chart->setBackgroundBrush(QBrush(QColor(36, 31, 49)));
+    auto titleFont = chart->titleFont();
+    titleFont.setPointSize(20);
+    chart->setTitleFont(titleFont);
+    chart->legend()->setVisible(false);
+    chart->setMargins({0, 0, 0, 0});
+
+    auto axisX = new QDateTimeAxis;
+    axisX->setTickCount(5);
+    axisX->setFormat("hh:mm");
+    axisX->setGridLineVisible(false);
+    axisX->setLabelsColor(Qt::white);
+    chart->addAxis(axisX, Qt::AlignBottom);
+    series->attachAxis(axisX);
+    volumeSeries->attachAxis(axisX);
+
+    auto axisY = new QValueAxis;
+    axisY->setGridLineVisible(true);
+    axisY->setGridLineColor(QColor(94, 92, 100));
+    axisY->setLabelsColor(Qt::white);
+    chart->addAxis(axisY, Qt::AlignRight);
+    series->attachAxis(axisY);
+
+    auto axisY2 = new QValueAxis;
+    axisY2->setGridLineVisible(false);
+    axisY2->setLabelsVisible(false);
+    chart->addAxis(axisY2, Qt::AlignLeft);
+    volumeSeries->attachAxis(axisY2);
+
+    auto chartView = new QChartView(chart);
+    chartView->resize(CHART_SIZE);
+
+    return chartView;
+}
+
+void ChartBench::showQtCharts(QChartView *chartView, const PKLinesList &klines)
+{
+    auto chart = chartView->chart();
+    auto volumeSeries = static_cast<QCandlestickSeries*>(chart->series().at(0));
+    auto series = static_cast<QCandlestickSeries*>(chart->series().at(1));
+
+    float priceMin = std::numeric_limits<float>::max();
+    float priceMax = std::numeric_limits<float>::lowest();
+    float volumeMax = 0.0f;
+
+    //прежний график заменял все наборы при каждом отображении
+    QList<QCandlestickSet*> sets;
+    QList<QCandlestickSet*> volumeSets;
+    sets.reserve(static_cast<qsizetype>(klines->size()));
+    volumeSets.reserve(static_cast<qsizetype>(klines->size()));
+    for (const auto& kline: *klines)
+    {
+        sets.append(new QCandlestickSet(kline->open, kline->high, kline->low, kline->close, static_cast<qreal>(kline->closeTime)));
+        volumeSets.append(new QCandlestickSet(0.0, kline->volume, 0.0, kline->volume, static_cast<qreal>(kline->closeTime)));
+
+        priceMin = std::min(priceMin, kline->low);
+        priceMax = std::max(priceMax, kline->high);
+        volumeMax = std::max(volumeMax, kline->volume);
+    }
+
+    series->clear();
+    volumeSeries->clear();
+    series->append(sets);
+    volumeSeries->append(volumeSets);
+
+    chart->setTitle(QString("BINANCE: %1 1m").arg(klines->front()->id.symbol.name));
+
+    auto axisX = static_cast<QDateTimeAxis*>(chart->axes(Qt::Horizontal).at(0));
+    axisX->setMax(QDateTime::fromMSecsSinceEpoch(klines->front()->closeTime + KLINE_DURATION * 5));
+    axisX->setMin(QDateTime::fromMSecsSinceEpoch(klines->back()->closeTime - KLINE_DURATION));
+
+    const auto padding = (priceMax - priceMin) / 3.0f;
+    auto axisY = static_cast<QValueAxis*>(chart->axes(Qt::Vertical).at(0));
+    axisY->setRange(priceMin - padding, priceMax + padding);
+
+    auto axisY2 = static_cast<QValueAxis*>(chart->axes(Qt::Vertical).at(1));
+    axisY2->setRange(-0.01, volumeMax * 2.0f);
+}
+
+void ChartBench::qtChartsRebuild_data()
+{
+    addCountRows();
+}
+
+void ChartBench::qtChartsRebuild()
+{
+    QFETCH(qsizetype, count);
+
+    std::unique_ptr<QChartView> chartView(makeChartView());
+
+    const std::array<PKLinesList, 2> klines = {makeKLines(count, 1), makeKLines(count, 2)};
+    qsizetype step = 0;
+
+    QBENCHMARK
+    {
+        showQtCharts(chartView.get(), klines[step % 2]);
+        chartView->grab();
+
+        ++step;
+    }
+}
+
+void ChartBench::qtChartsUpdate_data()
+{
+    addCountRows();
+}
+
+void ChartBench::qtChartsUpdate()
+{
+    QFETCH(qsizetype, count);
+
+    std::unique_ptr<QChartView> chartView(makeChartView());
+
+    const auto klines = makeKLines(count, 1);
+    const std::array<PKLinesList, 2> updated = {updateLast(klines, 0.0001f), updateLast(klines, -0.0001f)};
+
+    showQtCharts(chartView.get(), klines);
+    chartView->grab();
+
+    qsizetype step = 0;
+
+    QBENCHMARK
+    {
+        showQtCharts(chartView.get(), updated[step % 2]);
+        chartView->grab();
+
+        ++step;
+    }
+}
+
+QTEST_MAIN(ChartBench)
+
+#include "chartbench.moc"
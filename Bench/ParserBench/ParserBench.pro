@@ -0,0 +1,34 @@
+QT = core network gui widgets testlib
+
+TARGET = ParserBench
+TEMPLATE = app
+
+CONFIG += c++20
+CONFIG += static
+CONFIG += testcase
+
+INCLUDEPATH += $$PWD/../../Src
+
+HEADERS += \
+    ../../Src/localconfig.h \
+    ../../Src/networkcore.h
+
+SOURCES += \
+    parserbench.cpp \
+    ../../Src/localconfig.cpp \
+    ../../Src/networkcore.cpp
+
+#valid server answers as corpus/<type>_<name>.json, for example corpus/detect_burst.json.
+#KLinesIDList answers are named after the requested stock exchange: corpus/klinesidlist_BINANCE.json.
+#Answers recorded from the browser (Network tab) can be added or replace the generated ones
+corpus.files = $$files($$PWD/corpus/*.json)
+corpus.base = $$PWD/corpus
+corpus.prefix = /corpus
+RESOURCES += corpus
+
+QMAKE_CXXFLAGS += -O2 -fexceptions
+QMAKE_LFLAGS += -fexceptions
+
+#inlude addition library
+include($$PWD/../../../../Common/Common/Common.pri)
+include($$PWD/../../../TradingCatCommon/TradingCatCommon.pri)
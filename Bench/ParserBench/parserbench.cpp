@@ -0,0 +1,684 @@
+//STL
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+//Qt
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+
+//My
+#include <TradingCatCommon/appserverprotocol.h>
+
+#include "localconfig.h"
+#include "networkcore.h"
+
+using namespace TradingCatCommon;
+
+struct PackageTypeInfo
+{
+    PackageType type = PackageType::LOGIN;
+    const char* name = nullptr;  ///< имя типа в именах файлов корпуса
+};
+
+static const std::array<PackageTypeInfo, 6> PACKAGE_TYPES = {{
+    {PackageType::LOGIN, "login"},
+    {PackageType::STOCKEXCHANGES, "stockexchanges"},
+    {PackageType::KLINESIDLIST, "klinesidlist"},
+    {PackageType::CONFIG, "config"},
+    {PackageType::LOGOUT, "logout"},
+    {PackageType::DETECT, "detect"}
+}};
+
+constexpr static const char* CORPUS_PATH = ":/corpus";
+constexpr static const char* SYNTHETIC_STOCK_EXCHANGE = "SYNTHETIC";  ///< биржа запрошенного списка свечей для синтетических ответов
+constexpr static const int MUTATIONS_COUNT = 64;                   ///< количество мутаций каждого вида для одного ответа
+constexpr static const int WRONG_VALUES_COUNT = 8;
+constexpr static const qint64 PARSE_TIME_BASE = 50;                ///< допустимое время разбора ответа без учета размера, мс
+constexpr static const qint64 PARSE_TIME_PER_MB = 200;             ///< допустимое время разбора каждого МБ ответа, мс
+constexpr static const int GROWTH_STEPS = 4;                       ///< ответ увеличивается в 1, 2, 4 и 8 раз
+constexpr static const double SUPERLINEAR_RATIO = 3.0;             ///< допустимое превышение роста времени разбора над ростом размера
+constexpr static const qint64 NOISE_FLOOR = 1000000;               ///< замеры короче 1 мс не используются для проверки роста, нс
+constexpr static const qsizetype MAX_OVERSIZE = 32 * 1024 * 1024;  ///< ответы больше этого размера для проверки ограничения не создаются
+constexpr static const int REPEAT_COUNT = 3;                       ///< количество замеров одного ответа. Используется лучший
+
+/*!
+    Проверка разбора ответов сервера NetworkCore::parseX() на поврежденных данных и замер скорости разбора.
+    Исходные ответы - корректные ответы сервера из ресурса :/corpus (файлы <тип>_<имя>.json, тип - имя из PACKAGE_TYPES,
+    для списка свечей имя - биржа запрошенного списка: klinesidlist_BINANCE.json) и синтетические ответы, не зависящие
+    от формата пакета. Синтетические ответы отклоняются еще при разборе пакета, поэтому разбор данных пакета
+    проверяется только на ответах корпуса.
+    corpus - каждый ответ корпуса без изменений должен разбираться успешно, иначе мутации не доходят до разбора данных.
+    fuzz - каждый ответ обрезается, в нем меняются случайные байты, значения JSON заменяются значениями другого типа,
+    ответ увеличивается сверх NetworkCore::maxAnswerSize(). Разбор не должен падать или бросать исключения,
+    время разбора должно укладываться в PARSE_TIME_BASE + PARSE_TIME_PER_MB на МБ.
+    throughput - скорость разбора в МБ/с по каждому типу ответа корпуса. Самый большой массив ответа повторяется в 2, 4 и 8 раз,
+    время разбора не должно расти быстрее размера больше чем в SUPERLINEAR_RATIO раз
+*/
+class ParserBench
+    : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void corpus_data();
+    void corpus();
+
+    void fuzz_data();
+    void fuzz();
+
+    void throughput_data();
+    void throughput();
+
+private:
+    struct Seed
+    {
+        PackageType type = PackageType::LOGIN;
+        QString name;
+        QByteArray answer;
+        QString stockExchange;      ///< биржа запрошенного списка свечей. Используется для KLINESIDLIST
+        bool isRecorded = false;    ///< true - ответ из корпуса
+    };
+
+    struct Mutation
+    {
+        QString name;
+        QByteArray answer;
+        bool isRejected = false;  ///< ответ должен быть отклонен
+    };
+
+    static const char* typeName(PackageType type);
+    static std::vector<Seed> loadCorpus();
+    static std::vector<Seed> syntheticSeeds(PackageType type);
+    static std::vector<Mutation> mutate(PackageType type, const QByteArray& answer);
+
+    /*!
+        @param answer - ответ
+        @param factor - во сколько раз увеличить самый большой массив ответа
+        @return увеличенный ответ или пустой массив, если в ответе нет массивов
+    */
+    static QByteArray grow(const QByteArray& answer, int factor);
+
+    /*!
+        Разбирает ответ так же, как NetworkCore::getAnswerHttp(), но без отправки следующих запросов
+        @param seed - исходный ответ. Задает тип ответа и биржу запрошенного списка свечей
+        @param answer - разбираемый ответ
+        @return true - ответ разобран успешно
+    */
+    bool parse(const Seed& seed, const QByteArray& answer);
+
+    /*!
+        @return лучшее время разбора из REPEAT_COUNT замеров, нс
+    */
+    qint64 parseTime(const Seed& seed, const QByteArray& answer);
+
+private:
+    std::unique_ptr<LocalConfig> _cfg;
+    std::unique_ptr<NetworkCore> _networkCore;
+
+    std::vector<Seed> _seeds;
+};
+
+static qsizetype countValues(const QJsonValue& value)
+{
+    qsizetype count = 1;
+    if (value.isObject())
+    {
+        for (const auto& item: value.toObject())
+        {
+            count += countValues(item);
+        }
+    }
+    else if (value.isArray())
+    {
+        for (const auto& item: value.toArray())
+        {
+            count += countValues(item);
+        }
+    }
+
+    return count;
+}
+
+static QJsonValue wrongValue(const QJsonValue& original, int variant)
+{
+    for (int shift = 0; shift < WRONG_VALUES_COUNT; ++shift)
+    {
+        QJsonValue candidate;
+        switch ((variant + shift) % WRONG_VALUES_COUNT)
+        {
+        case 0: candidate = QJsonValue(); break;
+        case 1: candidate = true; break;
+        case 2: candidate = -1; break;
+        case 3: candidate = 1e308; break;
+        case 4: candidate = ""; break;
+        case 5: candidate = QString(1024, 'x'); break;
+        case 6: candidate = QJsonArray(); break;
+        case 7: candidate = QJsonObject(); break;
+        default:
+            Q_ASSERT(false);
+        }
+
+        if (candidate.type() != original.type())
+        {
+            return candidate;
+        }
+    }
+
+    return QJsonValue();
+}
+
+//заменяет значение с номером target при обходе дерева в прямом порядке
+static QJsonValue replaceValue(const QJsonValue& value, qsizetype& position, qsizetype target, int variant)
+{
+    if (position++ == target)
+    {
+        return wrongValue(value, variant);
+    }
+
+    if (value.isObject())
+    {
+        auto object = value.toObject();
+        for (auto it_object = object.begin(); it_object != object.end() && position <= target; ++it_object)
+        {
+            *it_object = replaceValue(it_object.value(), position, target, variant);
+        }
+
+        return object;
+    }
+
+    if (value.isArray())
+    {
+        auto array = value.toArray();
+        for (qsizetype index = 0; index < array.size() && position <= target; ++index)
+        {
+            array[index] = replaceValue(array.at(index), position, target, variant);
+        }
+
+        return array;
+    }
+
+    return value;
+}
+
+static qsizetype largestArraySize(const QJsonValue& value)
+{
+    qsizetype result = 0;
+    if (value.isObject())
+    {
+        for (const auto& item: value.toObject())
+        {
+            result = std::max(result, largestArraySize(item));
+        }
+    }
+    else if (value.isArray())
+    {
+        const auto array = value.toArray();
+        result = array.size();
+        for (const auto& item: array)
+        {
+            result = std::max(result, largestArraySize(item));
+        }
+    }
+
+    return result;
+}
+
+static QJsonValue growArray(const QJsonValue& value, qsizetype size, int factor, bool& isGrown)
+{
+    if (isGrown)
+    {
+        return value;
+    }
+
+    if (value.isObject())
+    {
+        auto object = value.toObject();
+        for (auto it_object = object.begin(); it_object != object.end() && !isGrown; ++it_object)
+        {
+            *it_object = growArray(it_object.value(), size, factor, isGrown);
+        }
+
+        return object;
+    }
+
+    if (value.isArray())
+    {
+        const auto array = value.toArray();
+        if (array.size() == size)
+        {
+            isGrown = true;
+
+            QJsonArray result;
+            for (int repeat = 0; repeat < factor; ++repeat)
+            {
+                for (const auto& item: array)
+                {
+                    result.append(item);
+                }
+            }
+
+            return result;
+        }
+
+        QJsonArray result;
+        for (const auto& item: array)
+        {
+            result.append(growArray(item, size, factor, isGrown));
+        }
+
+        return result;
+    }
+
+    return value;
+}
+
+const char* ParserBench::typeName(PackageType type)
+{
+    const auto it_packageTypes = std::find_if(PACKAGE_TYPES.begin(), PACKAGE_TYPES.end(),
+                                              [type](const PackageTypeInfo& info)
+                                              {
+                                                  return info.type == type;
+                                              });
+    Q_ASSERT(it_packageTypes != PACKAGE_TYPES.end());
+
+    return it_packageTypes->name;
+}
+
+std::vector<ParserBench::Seed> ParserBench::loadCorpus()
+{
+    std::vector<Seed> result;
+
+    const auto files = QDir(CORPUS_PATH).entryInfoList({"*.json"}, QDir::Files, QDir::Name);
+    for (const auto& fileInfo: files)
+    {
+        const auto name = fileInfo.completeBaseName().section('_', 0, 0).toLower();
+        const auto it_packageTypes = std::find_if(PACKAGE_TYPES.begin(), PACKAGE_TYPES.end(),
+                                                  [&name](const PackageTypeInfo& info)
+                                                  {
+                                                      return name == info.name;
+                                                  });
+        if (it_packageTypes == PACKAGE_TYPES.end())
+        {
+            qWarning() << "Corpus: unknown answer type:" << fileInfo.fileName();
+
+            continue;
+        }
+
+        QFile file(fileInfo.filePath());
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            qWarning() << "Corpus: file is not read:" << fileInfo.fileName() << file.errorString();
+
+            continue;
+        }
+
+        Seed seed{it_packageTypes->type, fileInfo.completeBaseName(), file.readAll()};
+        seed.isRecorded = true;
+
+        if (seed.type == PackageType::KLINESIDLIST)
+        {
+            seed.stockExchange = seed.name.section('_', 1, 1);
+            if (seed.stockExchange.isEmpty())
+            {
+                qWarning() << "Corpus: stock exchange is missing in the file name:" << fileInfo.fileName();
+
+                continue;
+            }
+        }
+
+        result.push_back(std::move(seed));
+    }
+
+    return result;
+}
+
+std::vector<ParserBench::Seed> ParserBench::syntheticSeeds(PackageType type)
+{
+    std::vector<Seed> result;
+
+    result.push_back({type, "empty_object", "{}"});
+
+    //разбор не должен уходить в глубокую рекурсию на вложенных массивах
+    constexpr qsizetype nesting = 100000;
+    result.push_back({type, "deep_nesting", "{\"data\":" + QByteArray(nesting, '[') + QByteArray(nesting, ']') + "}"});
+
+    const auto stringSize = std::min<qsizetype>(NetworkCore::maxAnswerSize(type) / 2, 4 * 1024 * 1024);
+    result.push_back({type, "long_string", "{\"data\":\"" + QByteArray(stringSize, 'x') + "\"}"});
+
+    QJsonArray numbers;
+    for (int number = 0; number < 100000; ++number)
+    {
+        numbers.append(number);
+    }
+    result.push_back({type, "number_array", QJsonDocument(QJsonObject{{"data", numbers}}).toJson(QJsonDocument::Compact)});
+
+    QJsonArray objects;
+    for (int number = 0; number < 10000; ++number)
+    {
+        objects.append(QJsonObject{{"id", number}, {"name", QString("SYMBOL%1").arg(number)}, {"values", QJsonArray{1.5, 2.5, 3.5}}});
+    }
+    result.push_back({type, "object_array", QJsonDocument(QJsonObject{{"data", objects}}).toJson(QJsonDocument::Compact)});
+
+    for (auto& seed: result)
+    {
+        seed.stockExchange = SYNTHETIC_STOCK_EXCHANGE;
+    }
+
+    return result;
+}
+
+std::vector<ParserBench::Mutation> ParserBench::mutate(PackageType type, const QByteArray &answer)
+{
+    std::vector<Mutation> result;
+
+    std::mt19937 generator(static_cast<unsigned int>(qHash(answer)));
+
+    //Truncate
+    if (!answer.isEmpty())
+    {
+        std::uniform_int_distribution<qsizetype> position(0, answer.size() - 1);
+        for (int mutation = 0; mutation < MUTATIONS_COUNT; ++mutation)
+        {
+            const auto size = mutation < 8 ? answer.size() * mutation / 8 : position(generator);
+            result.push_back({QString("truncate %1").arg(size), answer.first(size)});
+        }
+    }
+
+    //Flip bytes
+    if (!answer.isEmpty())
+    {
+        std::uniform_int_distribution<qsizetype> position(0, answer.size() - 1);
+        std::uniform_int_distribution<int> flipCount(1, 8);
+        std::uniform_int_distribution<int> mask(1, 255);
+        for (int mutation = 0; mutation < MUTATIONS_COUNT; ++mutation)
+        {
+            auto flipped = answer;
+            const auto count = flipCount(generator);
+            for (int flip = 0; flip < count; ++flip)
+            {
+                flipped[position(generator)] ^= static_cast<char>(mask(generator));
+            }
+            result.push_back({QString("flip %1").arg(mutation), flipped});
+        }
+    }
+
+    //Wrong types
+    const auto document = QJsonDocument::fromJson(answer);
+    if (document.isObject())
+    {
+        const QJsonValue root(document.object());
+        const auto count = countValues(root);
+        const auto step = std::max<qsizetype>(1, count / MUTATIONS_COUNT);
+
+        //корень не заменяется - ответ не объект отбрасывается до разбора
+        for (qsizetype target = 1; target < count; target += step)
+        {
+            qsizetype position = 0;
+            const auto mutated = replaceValue(root, position, target, static_cast<int>(target % WRONG_VALUES_COUNT));
+            result.push_back({QString("wrong type %1").arg(target), QJsonDocument(mutated.toObject()).toJson(QJsonDocument::Compact)});
+        }
+    }
+
+    //Oversize
+    const auto maxSize = NetworkCore::maxAnswerSize(type);
+    if (maxSize < MAX_OVERSIZE)
+    {
+        result.push_back({"oversize", answer + QByteArray(maxSize + 1 - std::min(maxSize, answer.size()), ' '), true});
+    }
+
+    return result;
+}
+
+QByteArray ParserBench::grow(const QByteArray &answer, int factor)
+{
+    const auto document = QJsonDocument::fromJson(answer);
+    if (!document.isObject())
+    {
+        return QByteArray();
+    }
+
+    const QJsonValue root(document.object());
+    const auto size = largestArraySize(root);
+    if (size == 0)
+    {
+        return QByteArray();
+    }
+
+    bool isGrown = false;
+    const auto grown = growArray(root, size, factor, isGrown);
+
+    return QJsonDocument(grown.toObject()).toJson(QJsonDocument::Compact);
+}
+
+bool ParserBench::parse(const Seed &seed, const QByteArray &answer)
+{
+    if (!_networkCore->checkAnswer(seed.type, answer))
+    {
+        return false;
+    }
+
+    switch (seed.type)
+    {
+    case PackageType::LOGIN:
+        return _networkCore->parseLogin(answer);
+    case PackageType::STOCKEXCHANGES:
+        return _networkCore->parseStockExchanges(answer);
+    case PackageType::KLINESIDLIST:
+        //список свечей разбирается только для запрошенной биржи
+        _networkCore->_unGetKLinesId.clear();
+        _networkCore->_unGetKLinesId.insert(StockExchangeID(seed.stockExchange));
+        return _networkCore->parseKLinesIdList(answer);
+    case PackageType::CONFIG:
+        return _networkCore->parseConfig(answer);
+    case PackageType::LOGOUT:
+        return _networkCore->parseLogout(answer);
+    case PackageType::DETECT:
+        return _networkCore->parseDetect(answer);
+    default:
+        Q_ASSERT(false);
+    }
+
+    return false;
+}
+
+qint64 ParserBench::parseTime(const Seed &seed, const QByteArray &answer)
+{
+    qint64 result = std::numeric_limits<qint64>::max();
+    for (int repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        parse(seed, answer);
+
+        result = std::min(result, timer.nsecsElapsed());
+    }
+
+    return result;
+}
+
+void ParserBench::initTestCase()
+{
+    _cfg = std::make_unique<LocalConfig>();
+    _networkCore = std::make_unique<NetworkCore>(*_cfg);
+
+    _seeds = loadCorpus();
+    QVERIFY2(!_seeds.empty(), qPrintable(QString("Corpus: no answers in %1").arg(CORPUS_PATH)));
+
+    qInfo() << "Corpus:" << _seeds.size() << "answer(s)";
+
+    for (const auto& info: PACKAGE_TYPES)
+    {
+        auto seeds = syntheticSeeds(info.type);
+        std::move(seeds.begin(), seeds.end(), std::back_inserter(_seeds));
+    }
+}
+
+void ParserBench::cleanupTestCase()
+{
+    _networkCore.reset();
+    _cfg.reset();
+}
+
+void ParserBench::corpus_data()
+{
+    QTest::addColumn<qsizetype>("seed");
+
+    for (qsizetype seed = 0; seed < static_cast<qsizetype>(_seeds.size()); ++seed)
+    {
+        const auto& current = _seeds[seed];
+        if (current.isRecorded)
+        {
+            QTest::newRow(qPrintable(current.name)) << seed;
+        }
+    }
+}
+
+void ParserBench::corpus()
+{
+    QFETCH(qsizetype, seed);
+
+    const auto& current = _seeds[seed];
+    QVERIFY2(parse(current, current.answer), qPrintable(QString("%1: answer is rejected. Mutations do not reach data parsing").arg(current.name)));
+}
+
+void ParserBench::fuzz_data()
+{
+    QTest::addColumn<qsizetype>("seed");
+
+    for (qsizetype seed = 0; seed < static_cast<qsizetype>(_seeds.size()); ++seed)
+    {
+        const auto& current = _seeds[seed];
+        QTest::newRow(qPrintable(QString("%1/%2").arg(typeName(current.type)).arg(current.name))) << seed;
+    }
+}
+
+void ParserBench::fuzz()
+{
+    QFETCH(qsizetype, seed);
+
+    const auto& current = _seeds[seed];
+    for (const auto& mutation: mutate(current.type, current.answer))
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        bool isParsed = false;
+        try
+        {
+            isParsed = parse(current, mutation.answer);
+        }
+        catch (const std::exception& err)
+        {
+            QFAIL(qPrintable(QString("%1: exception: %2").arg(mutation.name).arg(err.what())));
+        }
+        catch (...)
+        {
+            QFAIL(qPrintable(QString("%1: unknown exception").arg(mutation.name)));
+        }
+
+        const auto elapsed = timer.elapsed();
+        const auto limit = PARSE_TIME_BASE + PARSE_TIME_PER_MB * mutation.answer.size() / (1024 * 1024);
+        QVERIFY2(elapsed <= limit, qPrintable(QString("%1: parse time %2 ms exceeds %3 ms. Size: %4 bytes")
+                                                  .arg(mutation.name)
+                                                  .arg(elapsed)
+                                                  .arg(limit)
+                                                  .arg(mutation.answer.size())));
+
+        QVERIFY2(!mutation.isRejected || !isParsed, qPrintable(QString("%1: answer is not rejected").arg(mutation.name)));
+    }
+}
+
+void ParserBench::throughput_data()
+{
+    QTest::addColumn<int>("type");
+
+    for (const auto& info: PACKAGE_TYPES)
+    {
+        QTest::newRow(info.name) << static_cast<int>(info.type);
+    }
+}
+
+void ParserBench::throughput()
+{
+    QFETCH(int, type);
+
+    const auto packageType = static_cast<PackageType>(type);
+
+    qint64 totalBytes = 0;
+    qint64 totalNsecs = 0;
+    //синтетические ответы отклоняются при разборе пакета и измеряли бы скорость отказа, а не разбора
+    for (const auto& seed: _seeds)
+    {
+        if (seed.type != packageType || !seed.isRecorded)
+        {
+            continue;
+        }
+
+        qint64 firstNsecs = 0;
+        qsizetype firstSize = 0;
+        for (int step = 0; step < GROWTH_STEPS; ++step)
+        {
+            const auto answer = step == 0 ? seed.answer : grow(seed.answer, 1 << step);
+            if (answer.isEmpty())
+            {
+                break;
+            }
+
+            const auto nsecs = parseTime(seed, answer);
+            totalBytes += answer.size();
+            totalNsecs += nsecs;
+
+            if (step == 0)
+            {
+                firstNsecs = nsecs;
+                firstSize = answer.size();
+
+                continue;
+            }
+
+            //рост времени сравнивается с ростом размера, а не с количеством повторов массива
+            if (firstNsecs >= NOISE_FLOOR && firstSize > 0)
+            {
+                const auto ratio = (static_cast<double>(nsecs) / static_cast<double>(firstNsecs))
+                                   / (static_cast<double>(answer.size()) / static_cast<double>(firstSize));
+                QVERIFY2(ratio <= SUPERLINEAR_RATIO, qPrintable(QString("%1: parse time grows %2 times faster than size. Size: %3 -> %4 bytes")
+                                                                    .arg(seed.name)
+                                                                    .arg(ratio, 0, 'f', 1)
+                                                                    .arg(firstSize)
+                                                                    .arg(answer.size())));
+            }
+        }
+    }
+
+    if (totalNsecs == 0)
+    {
+        QSKIP("No corpus answers of this type");
+    }
+
+    const auto bytesPerSecond = static_cast<double>(totalBytes) / (static_cast<double>(totalNsecs) / 1000000000.0);
+
+    qInfo() << typeName(packageType) << "throughput:" << QString::number(bytesPerSecond / 1024.0 / 1024.0, 'f', 1) << "MB/s";
+
+    QTest::setBenchmarkResult(bytesPerSecond, QTest::BytesPerSecond);
+}
+
+QTEST_MAIN(ParserBench)
+
+#include "parserbench.moc"
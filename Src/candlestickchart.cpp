@@ -0,0 +1,556 @@
+//STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+//Qt
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QDateTime>
+
+#include "profiler.h"
+#include "indicatorengine.h"
+#include "candlestickchart.h"
+
+using namespace TradingCatCommon;
+
+static const QColor BACKGROUND_COLOR(36, 31, 49);
+static const QColor GRID_COLOR(94, 92, 100);
+static const QColor LABEL_COLOR(Qt::white);
+static const QColor INCREASE_COLOR(Qt::green);
+static const QColor DECREASE_COLOR(Qt::red);
+static const QColor VOLUME_COLOR(61, 56, 70);
+static const QColor EMA_COLOR(255, 190, 0);
+static const QColor VWAP_COLOR(0, 190, 255);
+static const QColor RSI_COLOR(220, 120, 255);
+static const QColor ATR_COLOR(255, 120, 80);
+static const std::array<QColor, 4> OVERLAY_COLORS = {QColor(255, 255, 255), QColor(255, 105, 180), QColor(120, 200, 255), QColor(255, 230, 120)};
+
+constexpr static const qreal TITLE_HEIGHT = 36.0;
+constexpr static const qreal LEFT_MARGIN = 4.0;
+constexpr static const qreal PRICE_AXIS_WIDTH = 70.0;
+constexpr static const qreal TIME_AXIS_HEIGHT = 20.0;
+constexpr static const int TICK_COUNT = 5;
+constexpr static const int TITLE_POINT_SIZE = 20;
+constexpr static const int LABEL_PIXEL_SIZE = 12;
+constexpr static const qreal VOLUME_BODY_WIDTH = 0.5;
+constexpr static const qreal MIN_CANDLE_WIDTH = 3.0;   ///< минимальная ширина столбца свечи, пикс
+constexpr static const qreal OSCILLATOR_HEIGHT = 60.0; ///< высота полосы RSI и ATR, пикс
+constexpr static const float RSI_LOW = 30.0f;
+constexpr static const float RSI_HIGH = 70.0f;
+
+CandlestickChart::CandlestickChart(QWidget *parent /* = nullptr */)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void CandlestickChart::setTitle(const QString &title)
+{
+    if (_title == title)
+    {
+        return;
+    }
+
+    _title = title;
+    _isStaticLayerValid = false;
+
+    update(0, 0, width(), static_cast<int>(TITLE_HEIGHT));
+}
+
+void CandlestickChart::setBodyWidth(qreal bodyWidth)
+{
+    Q_ASSERT(bodyWidth > 0.0 && bodyWidth <= 1.0);
+
+    _bodyWidth = bodyWidth;
+    _isDataLayerValid = false;
+
+    update();
+}
+
+void CandlestickChart::setIndicators(const Indicators &indicators)
+{
+    _indicators = indicators;
+    _isStaticLayerValid = false;
+    _isDataLayerValid = false;
+
+    update();
+}
+
+void CandlestickChart::setOverlays(std::vector<Overlay> &&overlays)
+{
+    if (_overlays.empty() && overlays.empty())
+    {
+        return;
+    }
+
+    _overlays = std::move(overlays);
+    _isStaticLayerValid = false;
+    _isDataLayerValid = false;
+
+    update();
+}
+
+void CandlestickChart::setKLines(const PKLineBuffer &klines)
+{
+    Q_CHECK_PTR(klines);
+    Q_ASSERT(!klines->isEmpty());
+
+    const auto previous = std::move(_klines);
+    _klines = klines;
+
+    const auto count = _klines->size();
+
+    Axis axis;
+    axis.timeMin = _klines->time.front() - _klines->duration;
+    axis.timeMax = _klines->time.back() + _klines->duration * 5;
+    const auto padding = (_klines->priceMax - _klines->priceMin) / 3.0f;
+    axis.priceMin = _klines->priceMin - padding;
+    axis.priceMax = _klines->priceMax + padding;
+    axis.volumeMax = _klines->volumeMax * 2.0f;
+    axis.atrMax = _klines->hasIndicators() ? *std::max_element(_klines->atr.begin(), _klines->atr.end()) : 0.0f;
+
+    //полоса осцилляторов меняет разметку графика
+    const auto isLayoutChanged = !previous || previous->hasIndicators() != _klines->hasIndicators();
+
+    if (axis != _axis || isLayoutChanged)
+    {
+        _axis = axis;
+        _isStaticLayerValid = false;
+        _isDataLayerValid = false;
+    }
+
+    //линии индикаторов проходят через соседние столбцы, поэтому с индикаторами слой свечей перерисовывается целиком
+    if (!previous || previous->size() != count || previous->duration != _klines->duration || isIndicatorsVisible() || !_overlays.empty())
+    {
+        _isDataLayerValid = false;
+    }
+
+    if (!_isDataLayerValid)
+    {
+        update();
+
+        return;
+    }
+
+    if (previous == _klines)
+    {
+        return;
+    }
+
+    //оси не изменились - перерисовываем только столбцы изменившихся свечей
+    QPainter painter(&_dataLayer);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
+    QRectF dirtyRect;
+    for (qsizetype index = 0; index < count; ++index)
+    {
+        if (previous->time[index] == _klines->time[index] && previous->open[index] == _klines->open[index]
+            && previous->high[index] == _klines->high[index] && previous->low[index] == _klines->low[index]
+            && previous->close[index] == _klines->close[index] && previous->volume[index] == _klines->volume[index])
+        {
+            continue;
+        }
+
+        const auto column = candleColumn(index);
+
+        painter.setCompositionMode(QPainter::CompositionMode_Clear);
+        painter.fillRect(column, Qt::transparent);
+        painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+        drawCandle(painter, index);
+
+        dirtyRect = dirtyRect.united(column);
+    }
+
+    if (!dirtyRect.isEmpty())
+    {
+        update(dirtyRect.toAlignedRect());
+    }
+}
+
+qsizetype CandlestickChart::maxKLinesCount() const
+{
+    return std::max<qsizetype>(1, static_cast<qsizetype>(plotRect().width() / MIN_CANDLE_WIDTH));
+}
+
+void CandlestickChart::paintEvent(QPaintEvent *event)
+{
+    Profiler::Scope profilerScope(Profiler::ESection::CHART_PAINT);
+
+    if (!_isStaticLayerValid)
+    {
+        rebuildStaticLayer();
+    }
+
+    if (!_isDataLayerValid)
+    {
+        rebuildDataLayer();
+    }
+
+    QPainter painter(this);
+    painter.setClipRect(event->rect());
+    painter.drawPixmap(0, 0, _staticLayer);
+    painter.drawPixmap(0, 0, _dataLayer);
+}
+
+void CandlestickChart::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+
+    _isStaticLayerValid = false;
+    _isDataLayerValid = false;
+
+    //при перетаскивании границы ширина меняется на каждый пиксель, а количество свечей - гораздо реже
+    const auto maxCount = maxKLinesCount();
+    if (maxCount != _maxKLinesCount)
+    {
+        _maxKLinesCount = maxCount;
+
+        emit maxKLinesCountChanged();
+    }
+}
+
+QRectF CandlestickChart::plotRect() const
+{
+    return QRectF(LEFT_MARGIN, TITLE_HEIGHT,
+                  std::max(1.0, width() - LEFT_MARGIN - PRICE_AXIS_WIDTH),
+                  std::max(1.0, height() - TITLE_HEIGHT - TIME_AXIS_HEIGHT - oscillatorHeight()));
+}
+
+QRectF CandlestickChart::oscillatorRect() const
+{
+    const auto rect = plotRect();
+
+    return QRectF(rect.left(), rect.bottom(), rect.width(), oscillatorHeight());
+}
+
+qreal CandlestickChart::oscillatorHeight() const
+{
+    return _indicators.isOscillators() && isIndicatorsVisible() ? OSCILLATOR_HEIGHT : 0.0;
+}
+
+bool CandlestickChart::isIndicatorsVisible() const
+{
+    return _klines && _klines->hasIndicators()
+           && (_indicators.isEMA || _indicators.isVWAP || _indicators.isRSI || _indicators.isATR);
+}
+
+qreal CandlestickChart::timeToX(qint64 time) const
+{
+    const auto rect = plotRect();
+    const auto range = std::max<qint64>(1, _axis.timeMax - _axis.timeMin);
+
+    return rect.left() + static_cast<qreal>(time - _axis.timeMin) * rect.width() / static_cast<qreal>(range);
+}
+
+qreal CandlestickChart::priceToY(float price) const
+{
+    const auto rect = plotRect();
+    const auto range = _axis.priceMax - _axis.priceMin;
+    if (range <= 0.0f)
+    {
+        return rect.center().y();
+    }
+
+    return rect.bottom() - static_cast<qreal>(price - _axis.priceMin) * rect.height() / static_cast<qreal>(range);
+}
+
+qreal CandlestickChart::volumeToY(float volume) const
+{
+    const auto rect = plotRect();
+    if (_axis.volumeMax <= 0.0f)
+    {
+        return rect.bottom();
+    }
+
+    return rect.bottom() - static_cast<qreal>(volume) * rect.height() / static_cast<qreal>(_axis.volumeMax);
+}
+
+qreal CandlestickChart::candleStep() const
+{
+    const auto range = std::max<qint64>(1, _axis.timeMax - _axis.timeMin);
+
+    return plotRect().width() * static_cast<qreal>(_klines ? _klines->duration : 0) / static_cast<qreal>(range);
+}
+
+QRectF CandlestickChart::candleColumn(qsizetype index) const
+{
+    const auto rect = plotRect();
+    const auto step = candleStep();
+    const auto x = timeToX(_klines->time[index]);
+
+    return QRectF(x - step / 2.0, rect.top(), step, rect.height());
+}
+
+void CandlestickChart::rebuildStaticLayer()
+{
+    _staticLayer = makeLayer();
+    _staticLayer.fill(BACKGROUND_COLOR);
+
+    QPainter painter(&_staticLayer);
+
+    //Title
+    auto titleFont = font();
+    titleFont.setPointSize(TITLE_POINT_SIZE);
+    painter.setFont(titleFont);
+    painter.setPen(LABEL_COLOR);
+    painter.drawText(QRectF(0.0, 0.0, width(), TITLE_HEIGHT), Qt::AlignCenter, _title);
+
+    if (!_klines)
+    {
+        _isStaticLayerValid = true;
+
+        return;
+    }
+
+    const auto rect = plotRect();
+
+    auto labelFont = font();
+    labelFont.setPixelSize(LABEL_PIXEL_SIZE);
+    painter.setFont(labelFont);
+
+    //Price axis
+    QPen gridPen(GRID_COLOR);
+    gridPen.setStyle(Qt::DotLine);
+    for (int tick = 0; tick < TICK_COUNT; ++tick)
+    {
+        const auto price = _axis.priceMin + (_axis.priceMax - _axis.priceMin) * static_cast<float>(tick) / static_cast<float>(TICK_COUNT - 1);
+        const auto y = priceToY(price);
+
+        painter.setPen(gridPen);
+        painter.drawLine(QPointF(rect.left(), y), QPointF(rect.right(), y));
+
+        painter.setPen(LABEL_COLOR);
+        painter.drawText(QRectF(rect.right() + 4.0, y - LABEL_PIXEL_SIZE, PRICE_AXIS_WIDTH - 4.0, LABEL_PIXEL_SIZE * 2),
+                         Qt::AlignLeft | Qt::AlignVCenter, QString::number(price, 'g', 6));
+    }
+
+    //Time axis
+    for (int tick = 0; tick < TICK_COUNT; ++tick)
+    {
+        const auto time = _axis.timeMin + (_axis.timeMax - _axis.timeMin) * tick / (TICK_COUNT - 1);
+        const auto x = timeToX(time);
+
+        painter.drawText(QRectF(x - 30.0, rect.bottom() + oscillatorHeight(), 60.0, TIME_AXIS_HEIGHT),
+                         Qt::AlignCenter, QDateTime::fromMSecsSinceEpoch(time).toString("hh:mm"));
+    }
+
+    //Oscillators
+    if (oscillatorHeight() > 0.0)
+    {
+        const auto oscillator = oscillatorRect();
+
+        painter.setPen(GRID_COLOR);
+        painter.drawLine(oscillator.topLeft(), oscillator.topRight());
+
+        if (_indicators.isRSI)
+        {
+            painter.setPen(gridPen);
+            for (const auto level: {RSI_LOW, RSI_HIGH})
+            {
+                const auto y = oscillator.bottom() - static_cast<qreal>(level) * oscillator.height() / 100.0;
+                painter.drawLine(QPointF(oscillator.left(), y), QPointF(oscillator.right(), y));
+            }
+        }
+    }
+
+    //Legend
+    const auto drawLegend = [&painter](qreal x, qreal y, const QString& text, const QColor& color)
+    {
+        painter.setPen(color);
+        painter.drawText(QPointF(x, y), text);
+
+        return x + painter.fontMetrics().horizontalAdvance(text) + 8.0;
+    };
+
+    if (isIndicatorsVisible())
+    {
+        auto x = rect.left() + 4.0;
+        const auto priceLegendY = rect.top() + LABEL_PIXEL_SIZE;
+        if (_indicators.isEMA)
+        {
+            x = drawLegend(x, priceLegendY, QString("EMA%1").arg(IndicatorEngine::EMA_PERIOD), EMA_COLOR);
+        }
+        if (_indicators.isVWAP)
+        {
+            drawLegend(x, priceLegendY, QString("VWAP%1").arg(IndicatorEngine::VWAP_PERIOD), VWAP_COLOR);
+        }
+
+        x = rect.left() + 4.0;
+        const auto oscillatorLegendY = oscillatorRect().top() + LABEL_PIXEL_SIZE;
+        if (_indicators.isRSI && oscillatorHeight() > 0.0)
+        {
+            x = drawLegend(x, oscillatorLegendY, QString("RSI%1").arg(IndicatorEngine::RSI_PERIOD), RSI_COLOR);
+        }
+        if (_indicators.isATR && oscillatorHeight() > 0.0)
+        {
+            drawLegend(x, oscillatorLegendY, QString("ATR%1 %2").arg(IndicatorEngine::ATR_PERIOD).arg(_axis.atrMax, 0, 'g', 4), ATR_COLOR);
+        }
+    }
+
+    if (!_overlays.empty())
+    {
+        auto x = rect.left() + 4.0;
+        const auto overlayLegendY = rect.top() + LABEL_PIXEL_SIZE * 2 + 4.0;
+        for (size_t overlay = 0; overlay < _overlays.size(); ++overlay)
+        {
+            x = drawLegend(x, overlayLegendY, _overlays[overlay].name, OVERLAY_COLORS[overlay % OVERLAY_COLORS.size()]);
+        }
+    }
+
+    _isStaticLayerValid = true;
+}
+
+void CandlestickChart::rebuildDataLayer()
+{
+    _dataLayer = makeLayer();
+
+    QPainter painter(&_dataLayer);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
+    if (_klines)
+    {
+        for (qsizetype index = 0; index < _klines->size(); ++index)
+        {
+            drawCandle(painter, index);
+        }
+
+        if (isIndicatorsVisible())
+        {
+            drawIndicators(painter);
+        }
+
+        if (!_overlays.empty())
+        {
+            drawOverlays(painter);
+        }
+    }
+
+    _isDataLayerValid = true;
+}
+
+void CandlestickChart::drawIndicators(QPainter &painter) const
+{
+    painter.setRenderHint(QPainter::Antialiasing, true);
+
+    if (_indicators.isEMA)
+    {
+        drawLine(painter, _klines->ema, EMA_COLOR, [this](float value){ return priceToY(value); });
+    }
+
+    if (_indicators.isVWAP)
+    {
+        drawLine(painter, _klines->vwap, VWAP_COLOR, [this](float value){ return priceToY(value); });
+    }
+
+    if (oscillatorHeight() > 0.0)
+    {
+        const auto oscillator = oscillatorRect();
+
+        if (_indicators.isRSI)
+        {
+            drawLine(painter, _klines->rsi, RSI_COLOR,
+                     [&oscillator](float value)
+                     {
+                         return oscillator.bottom() - static_cast<qreal>(value) * oscillator.height() / 100.0;
+                     });
+        }
+
+        if (_indicators.isATR && _axis.atrMax > 0.0f)
+        {
+            const auto atrMax = _axis.atrMax;
+            drawLine(painter, _klines->atr, ATR_COLOR,
+                     [&oscillator, atrMax](float value)
+                     {
+                         return oscillator.bottom() - static_cast<qreal>(value / atrMax) * oscillator.height();
+                     });
+        }
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing, false);
+}
+
+void CandlestickChart::drawOverlays(QPainter &painter) const
+{
+    painter.save();
+    painter.setClipRect(plotRect());
+    painter.setRenderHint(QPainter::Antialiasing, true);
+
+    const auto lastClose = _klines->close.back();
+    for (size_t overlay = 0; overlay < _overlays.size(); ++overlay)
+    {
+        const auto& klines = _overlays[overlay].klines;
+        if (!klines || klines->isEmpty() || klines->close.back() <= 0.0f)
+        {
+            continue;
+        }
+
+        //ряды разных бирж сравниваются по относительному движению, поэтому приводятся к последней цене основных свечей
+        const auto scale = lastClose / klines->close.back();
+
+        QPolygonF line;
+        line.reserve(klines->size());
+        for (qsizetype index = 0; index < klines->size(); ++index)
+        {
+            line.append(QPointF(timeToX(klines->time[index]), priceToY(klines->close[index] * scale)));
+        }
+
+        painter.setPen(QPen(OVERLAY_COLORS[overlay % OVERLAY_COLORS.size()], 1.0, Qt::DashLine));
+        painter.drawPolyline(line);
+    }
+
+    painter.restore();
+}
+
+void CandlestickChart::drawLine(QPainter &painter, const std::vector<float> &values, const QColor &color, const std::function<qreal(float)> &toY) const
+{
+    Q_ASSERT(static_cast<qsizetype>(values.size()) == _klines->size());
+
+    QPolygonF line;
+    line.reserve(static_cast<qsizetype>(values.size()));
+    for (qsizetype index = 0; index < _klines->size(); ++index)
+    {
+        line.append(QPointF(timeToX(_klines->time[index]), toY(values[index])));
+    }
+
+    painter.setPen(QPen(color, 1.0));
+    painter.drawPolyline(line);
+}
+
+void CandlestickChart::drawCandle(QPainter &painter, qsizetype index) const
+{
+    const auto step = candleStep();
+    const auto x = timeToX(_klines->time[index]);
+
+    //Volume
+    {
+        const auto halfWidth = std::max(0.5, step * VOLUME_BODY_WIDTH / 2.0);
+        const auto top = volumeToY(_klines->volume[index]);
+        painter.fillRect(QRectF(x - halfWidth, top, halfWidth * 2.0, std::max(1.0, volumeToY(0.0f) - top)), VOLUME_COLOR);
+    }
+
+    //Price
+    {
+        const auto& color = _klines->open[index] <= _klines->close[index] ? INCREASE_COLOR : DECREASE_COLOR;
+        const auto halfWidth = std::max(0.5, step * _bodyWidth / 2.0);
+        const auto openY = priceToY(_klines->open[index]);
+        const auto closeY = priceToY(_klines->close[index]);
+
+        painter.setPen(color);
+        painter.drawLine(QPointF(x, priceToY(_klines->high[index])), QPointF(x, priceToY(_klines->low[index])));
+        painter.fillRect(QRectF(x - halfWidth, std::min(openY, closeY), halfWidth * 2.0, std::max(1.0, std::abs(closeY - openY))), color);
+    }
+}
+
+QPixmap CandlestickChart::makeLayer() const
+{
+    const auto ratio = devicePixelRatioF();
+
+    QPixmap layer(size() * ratio);
+    layer.setDevicePixelRatio(ratio);
+    layer.fill(Qt::transparent);
+
+    return layer;
+}
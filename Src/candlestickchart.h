@@ -0,0 +1,144 @@
+#pragma once
+
+//STL
+#include <functional>
+#include <vector>
+
+//Qt
+#include <QWidget>
+#include <QPixmap>
+#include <QPainter>
+#include <QString>
+
+//My
+#include "klinebuffer.h"
+
+/*!
+    График свечей с объемами. Рисуется напрямую через QPainter из непрерывных массивов значений.
+    Фон, сетка и подписи осей кэшируются в отдельном слое и перерисовываются только при изменении размера
+    или диапазонов осей. Слой свечей при неизменных осях перерисовывается только в столбцах изменившихся свечей.
+    Индикаторы EMA и VWAP рисуются поверх свечей, RSI и ATR - в отдельной полосе под свечами.
+    Дополнительные ряды (например, тот же символ на других биржах) рисуются линиями цен закрытия,
+    приведенными к последней цене закрытия основных свечей
+*/
+class CandlestickChart
+    : public QWidget
+{
+    Q_OBJECT
+
+public:
+    struct Indicators
+    {
+        bool isEMA = false;
+        bool isVWAP = false;
+        bool isRSI = false;
+        bool isATR = false;
+
+        bool isOscillators() const noexcept { return isRSI || isATR; }
+    };
+
+    struct Overlay
+    {
+        QString name;          ///< подпись ряда
+        PKLineBuffer klines;   ///< свечи ряда
+    };
+
+public:
+    explicit CandlestickChart(QWidget* parent = nullptr);
+
+    /*!
+        Устанавливает заголовок графика
+        @param title - заголовок
+    */
+    void setTitle(const QString& title);
+
+    /*!
+        Устанавливает ширину тела свечи
+        @param bodyWidth - ширина тела свечи относительно шага между свечами (0..1]
+    */
+    void setBodyWidth(qreal bodyWidth);
+
+    /*!
+        Устанавливает отображаемые индикаторы. Индикаторы рисуются, только если они рассчитаны в буфере свечей
+        @param indicators - индикаторы
+    */
+    void setIndicators(const Indicators& indicators);
+
+    /*!
+        Устанавливает дополнительные ряды поверх свечей
+        @param overlays - ряды. Пустой список убирает ряды
+    */
+    void setOverlays(std::vector<Overlay>&& overlays);
+
+    /*!
+        Отображает свечи
+        @param klines - свечи. Количество не должно превышать maxKLinesCount()
+    */
+    void setKLines(const PKLineBuffer& klines);
+
+    /*!
+        @return максимальное количество свечей, которое можно различить при текущей ширине графика
+    */
+    qsizetype maxKLinesCount() const;
+
+signals:
+    /*!
+        Изменилось maxKLinesCount() после изменения ширины графика
+    */
+    void maxKLinesCountChanged();
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    Q_DISABLE_COPY_MOVE(CandlestickChart);
+
+    struct Axis
+    {
+        qint64 timeMin = 0;
+        qint64 timeMax = 0;
+        float priceMin = 0.0f;
+        float priceMax = 0.0f;
+        float volumeMax = 0.0f;
+        float atrMax = 0.0f;
+
+        bool operator==(const Axis& other) const noexcept = default;
+    };
+
+    QRectF plotRect() const;
+    QRectF oscillatorRect() const;
+    qreal oscillatorHeight() const;
+    qreal timeToX(qint64 time) const;
+    qreal priceToY(float price) const;
+    qreal volumeToY(float volume) const;
+    qreal candleStep() const;
+    QRectF candleColumn(qsizetype index) const;
+
+    void rebuildStaticLayer();
+    void rebuildDataLayer();
+    void drawCandle(QPainter& painter, qsizetype index) const;
+    void drawIndicators(QPainter& painter) const;
+    void drawOverlays(QPainter& painter) const;
+    void drawLine(QPainter& painter, const std::vector<float>& values, const QColor& color, const std::function<qreal(float)>& toY) const;
+    bool isIndicatorsVisible() const;
+
+    QPixmap makeLayer() const;
+
+private:
+    QString _title = "No data";
+    qreal _bodyWidth = 0.7;
+    Indicators _indicators;
+    std::vector<Overlay> _overlays;
+
+    PKLineBuffer _klines;        ///< отображаемые свечи
+
+    Axis _axis;
+    qsizetype _maxKLinesCount = 0;  ///< maxKLinesCount() при последнем изменении размера
+
+    QPixmap _staticLayer;        ///< фон, сетка, подписи осей и заголовок
+    QPixmap _dataLayer;          ///< свечи и объемы
+    bool _isStaticLayerValid = false;
+    bool _isDataLayerValid = false;
+
+};
@@ -0,0 +1,134 @@
+//Qt
+#include <QHashFunctions>
+
+#include "chartdatacache.h"
+
+ChartDataCache::ChartDataCache(qsizetype capacity)
+    : _capacity(capacity)
+    , _indicatorEngine(capacity)
+{
+    Q_ASSERT(_capacity > 0);
+}
+
+PKLineBuffer ChartDataCache::get(quint64 eventIndex, ESource source, InternTable::ID stockExchangeId, const TradingCatCommon::PKLinesList &klines,
+                                 qint64 duration, qsizetype count, qsizetype maxCount)
+{
+    Q_CHECK_PTR(klines);
+    Q_ASSERT(maxCount > 0);
+
+    const auto history = rollup(eventIndex, source, stockExchangeId, klines, duration);
+
+    //количество задано в свечах графика: окно большего интервала охватывает больше времени, а не меньше свечей.
+    //ключ - результат объединения, а не ширина графика, чтобы не хранить одинаковые окна для разных ширин
+    const auto windowCount = std::min(count, history->size());
+    const Key key{eventIndex, source, duration, windowCount, KLineBuffer::downsampleBucketSize(windowCount, maxCount)};
+
+    const auto it_index = _index.find(key);
+    if (it_index != _index.end())
+    {
+        _entries.splice(_entries.begin(), _entries, it_index->second);
+
+        return it_index->second->second;
+    }
+
+    auto buffer = std::make_shared<const KLineBuffer>(history->tail(windowCount).downsample(maxCount));
+
+    _entries.emplace_front(key, buffer);
+    _index.emplace(key, _entries.begin());
+
+    if (static_cast<qsizetype>(_entries.size()) > _capacity)
+    {
+        _index.erase(_entries.back().first);
+        _entries.pop_back();
+    }
+
+    return buffer;
+}
+
+PKLineBuffer ChartDataCache::rollup(quint64 eventIndex, ESource source, InternTable::ID stockExchangeId, const TradingCatCommon::PKLinesList &klines,
+                                    qint64 duration)
+{
+    const RollupKey key{eventIndex, source, duration};
+
+    const auto it_rollupIndex = _rollupIndex.find(key);
+    if (it_rollupIndex != _rollupIndex.end())
+    {
+        _rollups.splice(_rollups.begin(), _rollups, it_rollupIndex->second);
+
+        return it_rollupIndex->second->second;
+    }
+
+    auto history = KLineBuffer::fromKLines(klines, static_cast<qsizetype>(klines->size()));
+    if (!history.isEmpty())
+    {
+        if (duration > history.duration && duration % history.duration == 0)
+        {
+            history = history.resample(duration);
+        }
+
+        //индикаторы считаются по всей истории, чтобы значения в окне не зависели от количества отображаемых свечей
+        const auto symbolId = InternTable::instance().symbol(klines->front()->id.symbol);
+        _indicatorEngine.compute(stockExchangeId, symbolId, history)->fill(history);
+    }
+
+    auto buffer = std::make_shared<const KLineBuffer>(std::move(history));
+
+    _rollups.emplace_front(key, buffer);
+    _rollupIndex.emplace(key, _rollups.begin());
+
+    if (static_cast<qsizetype>(_rollups.size()) > _capacity)
+    {
+        _rollupIndex.erase(_rollups.back().first);
+        _rollups.pop_back();
+    }
+
+    return buffer;
+}
+
+void ChartDataCache::remove(quint64 eventIndex)
+{
+    for (auto it_entries = _entries.begin(); it_entries != _entries.end(); )
+    {
+        if (it_entries->first.eventIndex == eventIndex)
+        {
+            _index.erase(it_entries->first);
+            it_entries = _entries.erase(it_entries);
+        }
+        else
+        {
+            ++it_entries;
+        }
+    }
+
+    for (auto it_rollups = _rollups.begin(); it_rollups != _rollups.end(); )
+    {
+        if (it_rollups->first.eventIndex == eventIndex)
+        {
+            _rollupIndex.erase(it_rollups->first);
+            it_rollups = _rollups.erase(it_rollups);
+        }
+        else
+        {
+            ++it_rollups;
+        }
+    }
+}
+
+void ChartDataCache::clear()
+{
+    _index.clear();
+    _entries.clear();
+    _rollupIndex.clear();
+    _rollups.clear();
+    _indicatorEngine.clear();
+}
+
+size_t ChartDataCache::KeyHash::operator()(const Key &key) const noexcept
+{
+    return qHashMulti(0, key.eventIndex, static_cast<quint8>(key.source), key.duration, key.count, key.bucketSize);
+}
+
+size_t ChartDataCache::KeyHash::operator()(const RollupKey &key) const noexcept
+{
+    return qHashMulti(0, key.eventIndex, static_cast<quint8>(key.source), key.duration);
+}
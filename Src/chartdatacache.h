@@ -0,0 +1,114 @@
+#pragma once
+
+//STL
+#include <list>
+#include <unordered_map>
+
+//Qt
+#include <QtGlobal>
+
+//My
+#include <TradingCatCommon/kline.h>
+
+#include "klinebuffer.h"
+#include "interntable.h"
+#include "indicatorengine.h"
+
+/*!
+    LRU кэш подготовленных для графиков данных. Ключ - событие детектирования, источник свечей, интервал свечей,
+    количество отображаемых свечей и количество свечей, объединяемых в одну по ширине графика. Поэтому графики
+    разной ширины с одинаковым результатом объединения используют одну запись.
+    История события детектирования не меняется, поэтому записи инвалидируются только вытеснением
+    или удалением события. Подготовленные данные включают индикаторы, рассчитанные по всей истории события.
+    Вся история события, переведенная в свечи большего интервала, хранится отдельно, поэтому при смене
+    количества отображаемых свечей из нее только вырезается окно
+*/
+class ChartDataCache
+{
+public:
+    enum class ESource: quint8
+    {
+        HISTORY = 0,  ///< история свечей детектирования
+        REVIEW = 1    ///< история свечей обзора
+    };
+
+public:
+    /*!
+        Конструктор
+        @param capacity - максимальное количество записей в кэше
+    */
+    explicit ChartDataCache(qsizetype capacity);
+
+    /*!
+        Возвращает данные для графика, при необходимости подготавливая их
+        @param eventIndex - ИД события детектирования
+        @param source - источник свечей
+        @param stockExchangeId - ИД биржи события
+        @param klines - история свечей события. Первая - самая новая
+        @param duration - интервал свечей графика, мс. Если не больше интервала истории - свечи истории
+        @param count - количество отображаемых свечей интервала duration
+        @param maxCount - максимальное количество свечей, помещающееся по ширине графика
+        @return данные для графика
+    */
+    PKLineBuffer get(quint64 eventIndex, ESource source, InternTable::ID stockExchangeId, const TradingCatCommon::PKLinesList& klines,
+                     qint64 duration, qsizetype count, qsizetype maxCount);
+
+    /*!
+        Удаляет все записи события
+        @param eventIndex - ИД события детектирования
+    */
+    void remove(quint64 eventIndex);
+
+    void clear();
+
+private:
+    ChartDataCache() = delete;
+    Q_DISABLE_COPY_MOVE(ChartDataCache);
+
+    struct Key
+    {
+        quint64 eventIndex = 0;
+        ESource source = ESource::HISTORY;
+        qint64 duration = 0;
+        qsizetype count = 0;       ///< количество свечей окна
+        qsizetype bucketSize = 1;  ///< количество свечей окна, объединяемых в одну свечу графика
+
+        bool operator==(const Key& other) const noexcept = default;
+    };
+
+    struct RollupKey
+    {
+        quint64 eventIndex = 0;
+        ESource source = ESource::HISTORY;
+        qint64 duration = 0;
+
+        bool operator==(const RollupKey& other) const noexcept = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const noexcept;
+        size_t operator()(const RollupKey& key) const noexcept;
+    };
+
+    using Entry = std::pair<Key, PKLineBuffer>;
+    using RollupEntry = std::pair<RollupKey, PKLineBuffer>;
+
+    /*!
+        Возвращает всю историю события в свечах интервала duration с рассчитанными индикаторами
+    */
+    PKLineBuffer rollup(quint64 eventIndex, ESource source, InternTable::ID stockExchangeId, const TradingCatCommon::PKLinesList& klines,
+                        qint64 duration);
+
+private:
+    const qsizetype _capacity = 0;
+
+    IndicatorEngine _indicatorEngine;  ///< индикаторы по символам. Общие для всех событий одного символа
+
+    std::list<Entry> _entries;  ///< записи. В начале - последние использованные
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _index;
+
+    std::list<RollupEntry> _rollups;  ///< история событий в свечах графика. В начале - последние использованные
+    std::unordered_map<RollupKey, std::list<RollupEntry>::iterator, KeyHash> _rollupIndex;
+
+};
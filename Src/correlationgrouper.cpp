@@ -0,0 +1,117 @@
+//STL
+#include <algorithm>
+#include <array>
+
+#include "correlationgrouper.h"
+
+//котируемые валюты в порядке проверки: более длинные раньше, чтобы FDUSD не распознавался как USD
+static const std::array<QString, 11> QUOTE_SYMBOLS = {"FDUSD", "USDT", "USDC", "BUSD", "TUSD", "USD", "EUR", "TRY", "BTC", "ETH", "BNB"};
+
+//static
+QString CorrelationGrouper::baseSymbolName(const QString &symbol)
+{
+    const auto name = symbol.toUpper();
+
+    //у бирж с разделителем базовая монета - первая часть имени
+    const auto separator = std::find_if(name.begin(), name.end(),
+                                        [](QChar ch)
+                                        {
+                                            return ch == '_' || ch == '-' || ch == '/';
+                                        });
+    if (separator != name.end() && separator != name.begin())
+    {
+        return name.left(std::distance(name.begin(), separator));
+    }
+
+    for (const auto& quote: QUOTE_SYMBOLS)
+    {
+        if (name.size() > quote.size() && name.endsWith(quote))
+        {
+            return name.left(name.size() - quote.size());
+        }
+    }
+
+    return name;
+}
+
+quint64 CorrelationGrouper::add(quint64 eventIndex, InternTable::ID stockExchangeId, InternTable::ID symbolId, qint64 time)
+{
+    Q_ASSERT(eventIndex != 0);
+
+    expire(time);
+
+    const auto base = baseSymbol(symbolId);
+
+    const auto it_groups = _groups.find(base);
+    if (it_groups == _groups.end() || time - it_groups->second.firstTime > WINDOW)
+    {
+        auto& group = _groups[base];
+        group.leaderIndex = eventIndex;
+        group.firstTime = time;
+        group.stockExchanges.assign(1, stockExchangeId);
+
+        _expiration.emplace_back(time, base);
+
+        return 0;
+    }
+
+    //повторы на той же бирже не объединяются с другими биржами
+    auto& group = it_groups->second;
+    if (std::find(group.stockExchanges.begin(), group.stockExchanges.end(), stockExchangeId) != group.stockExchanges.end())
+    {
+        return 0;
+    }
+
+    group.stockExchanges.push_back(stockExchangeId);
+
+    return group.leaderIndex;
+}
+
+void CorrelationGrouper::clear()
+{
+    _groups.clear();
+    _expiration.clear();
+}
+
+CorrelationGrouper::BaseID CorrelationGrouper::baseSymbol(InternTable::ID symbolId)
+{
+    if (symbolId >= _symbolBases.size())
+    {
+        _symbolBases.resize(symbolId + 1, 0);
+    }
+
+    auto& symbolBase = _symbolBases[symbolId];
+    if (symbolBase == 0)
+    {
+        const auto name = baseSymbolName(InternTable::instance().symbolName(symbolId));
+        const auto it_baseIds = _baseIds.find(name);
+        if (it_baseIds != _baseIds.end())
+        {
+            symbolBase = it_baseIds.value() + 1;
+        }
+        else
+        {
+            const auto baseId = static_cast<BaseID>(_baseIds.size());
+            _baseIds.insert(name, baseId);
+            symbolBase = baseId + 1;
+        }
+    }
+
+    return symbolBase - 1;
+}
+
+void CorrelationGrouper::expire(qint64 time)
+{
+    while (!_expiration.empty() && time - _expiration.front().first > WINDOW)
+    {
+        const auto [firstTime, base] = _expiration.front();
+        _expiration.pop_front();
+
+        //группа могла быть открыта заново - удаляем только ту, к которой относится запись очереди
+        const auto it_groups = _groups.find(base);
+        if (it_groups != _groups.end() && it_groups->second.firstTime == firstTime)
+        {
+            _groups.erase(it_groups);
+        }
+    }
+}
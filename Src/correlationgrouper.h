@@ -0,0 +1,71 @@
+#pragma once
+
+//STL
+#include <deque>
+#include <vector>
+#include <unordered_map>
+
+//Qt
+#include <QtGlobal>
+#include <QString>
+#include <QHash>
+
+//My
+#include "interntable.h"
+
+/*!
+    Объединение одновременных детектирований одного базового символа на разных биржах.
+    Открытые группы хранятся в хэш-таблице по базовому символу, поэтому новое детектирование сопоставляется
+    с группой за O(1) без просмотра ранее полученных событий. Группа открыта WINDOW после первого детектирования,
+    устаревшие группы удаляются из очереди по времени открытия
+*/
+class CorrelationGrouper
+{
+public:
+    static constexpr qint64 WINDOW = 60 * 1000;  ///< максимальный интервал от первого детектирования группы, мс
+
+    /*!
+        @param symbol - имя символа биржи, например BTCUSDT, BTC_USDT или BTC-USDT
+        @return имя базовой монеты символа
+    */
+    static QString baseSymbolName(const QString& symbol);
+
+public:
+    CorrelationGrouper() = default;
+
+    /*!
+        Сопоставляет детектирование с открытой группой того же базового символа
+        @param eventIndex - ИД события
+        @param stockExchangeId - ИД биржи
+        @param symbolId - ИД символа
+        @param time - время детектирования, мс
+        @return ИД первого события группы, к которой присоединено детектирование. 0 - детектирование
+            открыло новую группу или повторяет биржу, уже входящую в группу
+    */
+    quint64 add(quint64 eventIndex, InternTable::ID stockExchangeId, InternTable::ID symbolId, qint64 time);
+
+    void clear();
+
+private:
+    Q_DISABLE_COPY_MOVE(CorrelationGrouper);
+
+    using BaseID = quint32;
+
+    struct Group
+    {
+        quint64 leaderIndex = 0;                          ///< ИД первого события группы
+        qint64 firstTime = 0;                             ///< время первого детектирования, мс
+        std::vector<InternTable::ID> stockExchanges;      ///< биржи группы
+    };
+
+    BaseID baseSymbol(InternTable::ID symbolId);
+    void expire(qint64 time);
+
+private:
+    std::unordered_map<BaseID, Group> _groups;            ///< открытые группы по базовому символу
+    std::deque<std::pair<qint64, BaseID>> _expiration;    ///< время открытия групп в порядке поступления
+
+    QHash<QString, BaseID> _baseIds;         ///< ИД базовых символов по имени
+    std::vector<BaseID> _symbolBases;        ///< ИД базового символа + 1. Индекс - ИД символа в InternTable. 0 - еще не вычислен
+
+};
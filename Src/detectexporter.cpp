@@ -0,0 +1,272 @@
+//STL
+#include <algorithm>
+#include <utility>
+
+//Qt
+#include <QDataStream>
+#include <QDateTime>
+#include <QHash>
+#include <QStringList>
+#include <QDebug>
+
+//EM
+#include <emscripten.h>
+
+#include "detectexporter.h"
+
+using namespace TradingCatCommon;
+
+// Части файла копируются из памяти WASM в отдельные Blob, поэтому файл целиком в памяти приложения не собирается
+EM_JS(void, detectExporterBegin, (), {
+    Module.detectExporterParts = [];
+});
+
+EM_JS(void, detectExporterAppend, (const char* data, int size), {
+    Module.detectExporterParts.push(new Blob([HEAPU8.slice(data, data + size)]));
+});
+
+EM_JS(void, detectExporterFinish, (const char* fileName, const char* mimeType), {
+    const blob = new Blob(Module.detectExporterParts, { type: UTF8ToString(mimeType) });
+    Module.detectExporterParts = [];
+
+    const url = URL.createObjectURL(blob);
+    const link = document.createElement("a");
+    link.href = url;
+    link.download = UTF8ToString(fileName);
+    document.body.appendChild(link);
+    link.click();
+    document.body.removeChild(link);
+
+    setTimeout(() => URL.revokeObjectURL(url), 60000);
+});
+
+static QByteArray csvField(const QString& value)
+{
+    if (!value.contains(',') && !value.contains('"') && !value.contains('\n'))
+    {
+        return value.toUtf8();
+    }
+
+    return '"' + QString(value).replace('"', "\"\"").toUtf8() + '"';
+}
+
+//class
+DetectExporter::DetectExporter(QObject* parent /* = nullptr */)
+    : QObject{parent}
+{
+    _exportTimer = new QTimer(this);
+    _exportTimer->setInterval(0);
+
+    QObject::connect(_exportTimer, SIGNAL(timeout()), SLOT(exportTimerTimeout()));
+}
+
+bool DetectExporter::start(EFormat format, DetectList &&detected)
+{
+    if (isRunning())
+    {
+        return false;
+    }
+
+    _format = format;
+    _detected = std::move(detected);
+    _position = 0;
+    _fileName = QString("detections_%1.%2")
+                    .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"))
+                    .arg(_format == EFormat::CSV ? "csv" : "tccol");
+
+    detectExporterBegin();
+
+    QByteArray header;
+    if (_format == EFormat::CSV)
+    {
+        header = "event,newest_close_time,stock_exchange,symbol,delta,volume,source,interval,close_time,open,high,low,close,kline_volume\n";
+    }
+    else
+    {
+        header = MAGIC;
+    }
+    detectExporterAppend(header.constData(), static_cast<int>(header.size()));
+
+    _exportTimer->start();
+
+    return true;
+}
+
+bool DetectExporter::isRunning() const noexcept
+{
+    return _exportTimer->isActive();
+}
+
+void DetectExporter::exportTimerTimeout()
+{
+    const auto total = static_cast<qsizetype>(_detected.size());
+    if (_position < total)
+    {
+        const auto last = std::min(_position + BLOCK_SIZE, total);
+        const auto block = _format == EFormat::CSV ? encodeCsvBlock(_position, last) : encodeColumnarBlock(_position, last);
+        detectExporterAppend(block.constData(), static_cast<int>(block.size()));
+
+        _position = last;
+
+        return;
+    }
+
+    _exportTimer->stop();
+
+    const auto fileName = _fileName.toStdString();
+    detectExporterFinish(fileName.c_str(), _format == EFormat::CSV ? "text/csv" : "application/octet-stream");
+
+    qInfo() << "Export:" << total << "event(s) to" << _fileName;
+
+    _detected.clear();
+    _detected.shrink_to_fit();
+
+    emit finished(_fileName, total);
+}
+
+QByteArray DetectExporter::encodeCsvBlock(qsizetype first, qsizetype last) const
+{
+    QByteArray block;
+
+    for (auto position = first; position < last; ++position)
+    {
+        const auto& detectData = _detected[position];
+        const auto& kline = detectData->history->front();
+
+        //данные события повторяются в каждой строке свечи, чтобы файл читался как одна таблица
+        const auto eventFields = QByteArray::number(position + 1) + ','
+                                 + QByteArray::number(kline->closeTime) + ','
+                                 + csvField(detectData->stockExchangeId.name) + ','
+                                 + csvField(kline->id.symbol.name) + ','
+                                 + QByteArray::number(detectData->delta, 'g', 10) + ','
+                                 + QByteArray::number(detectData->volume, 'g', 10) + ',';
+
+        for (const auto& [source, klines]: {std::pair{"history", &detectData->history}, std::pair{"review", &detectData->reviewHistory}})
+        {
+            const auto interval = QByteArray::number(static_cast<qint64>((*klines)->front()->id.type));
+            for (auto it_klines = (*klines)->rbegin(); it_klines != (*klines)->rend(); ++it_klines)
+            {
+                const auto& item = *it_klines;
+
+                block += eventFields;
+                block += source;
+                block += ',' + interval;
+                block += ',' + QByteArray::number(item->closeTime);
+                block += ',' + QByteArray::number(item->open, 'g', 10);
+                block += ',' + QByteArray::number(item->high, 'g', 10);
+                block += ',' + QByteArray::number(item->low, 'g', 10);
+                block += ',' + QByteArray::number(item->close, 'g', 10);
+                block += ',' + QByteArray::number(item->volume, 'g', 10);
+                block += '\n';
+            }
+        }
+    }
+
+    return block;
+}
+
+QByteArray DetectExporter::encodeColumnarBlock(qsizetype first, qsizetype last) const
+{
+    QByteArray block;
+
+    QDataStream stream(&block, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    //имена бирж и символов блока записываются один раз в словарь
+    QStringList dictionary;
+    QHash<QString, quint16> dictionaryIndex;
+    const auto dictionaryId = [&dictionary, &dictionaryIndex](const QString& value)
+    {
+        const auto it_dictionaryIndex = dictionaryIndex.constFind(value);
+        if (it_dictionaryIndex != dictionaryIndex.constEnd())
+        {
+            return it_dictionaryIndex.value();
+        }
+
+        const auto id = static_cast<quint16>(dictionary.size());
+        dictionary.push_back(value);
+        dictionaryIndex.insert(value, id);
+
+        return id;
+    };
+
+    std::vector<quint16> stockExchanges;
+    std::vector<quint16> symbols;
+    for (auto position = first; position < last; ++position)
+    {
+        const auto& detectData = _detected[position];
+        stockExchanges.push_back(dictionaryId(detectData->stockExchangeId.name));
+        symbols.push_back(dictionaryId(detectData->history->front()->id.symbol.name));
+    }
+
+    stream << static_cast<quint32>(last - first);
+
+    stream << static_cast<quint16>(dictionary.size());
+    for (const auto& value: dictionary)
+    {
+        const auto utf8 = value.toUtf8();
+        stream << static_cast<quint16>(utf8.size());
+        stream.writeRawData(utf8.constData(), static_cast<int>(utf8.size()));
+    }
+
+    for (const auto id: stockExchanges)
+    {
+        stream << id;
+    }
+    for (const auto id: symbols)
+    {
+        stream << id;
+    }
+
+    for (auto position = first; position < last; ++position)
+    {
+        stream << static_cast<qint64>(_detected[position]->history->front()->closeTime);
+    }
+    for (auto position = first; position < last; ++position)
+    {
+        stream << static_cast<double>(_detected[position]->delta);
+    }
+    for (auto position = first; position < last; ++position)
+    {
+        stream << static_cast<double>(_detected[position]->volume);
+    }
+
+    for (const auto isHistory: {true, false})
+    {
+        const auto klinesOf = [this, isHistory](qsizetype position) -> const PKLinesList&
+        {
+            return isHistory ? _detected[position]->history : _detected[position]->reviewHistory;
+        };
+
+        for (auto position = first; position < last; ++position)
+        {
+            stream << static_cast<qint64>(klinesOf(position)->front()->id.type);
+        }
+        for (auto position = first; position < last; ++position)
+        {
+            stream << static_cast<quint32>(klinesOf(position)->size());
+        }
+
+        //колонки свечей: значения одного поля всех свечей блока подряд
+        const auto writeColumn = [&](const auto& value)
+        {
+            for (auto position = first; position < last; ++position)
+            {
+                const auto& klines = klinesOf(position);
+                for (auto it_klines = klines->rbegin(); it_klines != klines->rend(); ++it_klines)
+                {
+                    stream << value(**it_klines);
+                }
+            }
+        };
+
+        writeColumn([](const KLine& kline) { return static_cast<qint64>(kline.closeTime); });
+        writeColumn([](const KLine& kline) { return static_cast<double>(kline.open); });
+        writeColumn([](const KLine& kline) { return static_cast<double>(kline.high); });
+        writeColumn([](const KLine& kline) { return static_cast<double>(kline.low); });
+        writeColumn([](const KLine& kline) { return static_cast<double>(kline.close); });
+        writeColumn([](const KLine& kline) { return static_cast<double>(kline.volume); });
+    }
+
+    return block;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+//STL
+#include <vector>
+
+//Qt
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QTimer>
+
+//My
+#include <TradingCatCommon/detector.h>
+
+/*!
+    Потоковая выгрузка событий детектирования вместе с историей свечей в файл CSV или в компактный колоночный
+    двоичный файл. События обрабатываются по таймеру блоками по BLOCK_SIZE, каждый закодированный блок сразу
+    передается браузеру как часть Blob, поэтому интерфейс не блокируется, а в памяти приложения находится
+    только текущий блок. По завершении браузер сохраняет собранный Blob как файл.
+
+    Колоночный формат (little-endian): заголовок MAGIC, далее блоки до конца файла. Блок:
+        quint32 eventCount
+        quint16 dictionarySize, строки словаря: quint16 длина + UTF-8
+        quint16 stockExchange[eventCount], quint16 symbol[eventCount] - номера строк словаря
+        qint64 newestCloseTime[eventCount], double delta[eventCount], double volume[eventCount]
+        для истории и истории просмотра:
+            qint64 interval[eventCount], quint32 klineCount[eventCount]
+            qint64 closeTime[N], double open[N], high[N], low[N], close[N], volume[N], N - сумма klineCount
+    newestCloseTime - время закрытия самой новой свечи истории события. Свечи каждого события записываются
+    от старых к новым. В CSV то же время - колонка newest_close_time
+*/
+class DetectExporter
+    : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class EFormat: quint8
+    {
+        CSV = 0,
+        COLUMNAR = 1
+    };
+
+    using DetectList = std::vector<TradingCatCommon::Detector::PKLineDetectData>;
+
+    static constexpr qsizetype BLOCK_SIZE = 32;   ///< количество событий, кодируемых за один шаг таймера
+    static constexpr const char* MAGIC = "TCCOL002";  ///< 002 - значения с плавающей точкой записываются как double
+
+public:
+    explicit DetectExporter(QObject* parent = nullptr);
+
+    /*!
+        Начинает выгрузку. Во время выгрузки повторный запуск игнорируется
+        @param format - формат файла
+        @param detected - выгружаемые события в порядке поступления
+        @return true - выгрузка начата
+    */
+    bool start(EFormat format, DetectList&& detected);
+    bool isRunning() const noexcept;
+
+signals:
+    /*!
+        Выгрузка завершена, файл передан браузеру
+        @param fileName - имя файла
+        @param count - количество выгруженных событий
+    */
+    void finished(const QString& fileName, qsizetype count);
+
+private slots:
+    void exportTimerTimeout();
+
+private:
+    Q_DISABLE_COPY_MOVE(DetectExporter);
+
+    QByteArray encodeCsvBlock(qsizetype first, qsizetype last) const;
+    QByteArray encodeColumnarBlock(qsizetype first, qsizetype last) const;
+
+private:
+    QTimer* _exportTimer = nullptr;   ///< таймер кодирования очередного блока
+
+    EFormat _format = EFormat::CSV;
+    DetectList _detected;             ///< выгружаемые события
+    qsizetype _position = 0;          ///< номер первого еще не выгруженного события
+    QString _fileName;
+
+};
@@ -0,0 +1,528 @@
+//STL
+#include <algorithm>
+
+//Qt
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QDebug>
+
+//EM
+#include <emscripten.h>
+#include <emscripten/bind.h>
+
+//My
+#include "sessionstore.h"
+
+#include "detectjournal.h"
+
+using namespace TradingCatCommon;
+
+constexpr static const int FLUSH_DELAY = 5000;          //ms
+constexpr static const quint64 MAX_CHUNKS = 5000;       ///< максимальное количество хранимых блоков
+constexpr static const char RECORD_SEPARATOR = ';';
+
+static DetectJournal* journalInstance = nullptr;        ///< журнал, которому передаются ответы IndexedDB
+
+// Все функции отвечают асинхронно через Module.detectJournalReply(), в том числе при ошибке вызова
+EM_JS(void, detectJournalOpen, (int requestId), {
+    const reply = (isSuccess, data) => Module.detectJournalReply(requestId, isSuccess, data);
+    try
+    {
+        const request = indexedDB.open("TradingCatJournal", 1);
+        request.onupgradeneeded = () =>
+        {
+            const db = request.result;
+            db.createObjectStore("chunks");
+            db.createObjectStore("index");
+        };
+        request.onsuccess = () =>
+        {
+            Module.detectJournalDb = request.result;
+
+            const index = Module.detectJournalDb.transaction("index", "readonly").objectStore("index").getAll();
+            index.onsuccess = () => reply(true, JSON.stringify(index.result));
+            index.onerror = () => reply(false, index.error ? index.error.name : "");
+        };
+        request.onerror = () => reply(false, request.error ? request.error.name : "");
+    }
+    catch (e)
+    {
+        setTimeout(() => reply(false, e.name), 0);
+    }
+});
+
+EM_JS(void, detectJournalPut, (int requestId, double number, const char* meta, const char* data), {
+    const reply = (isSuccess, data) => Module.detectJournalReply(requestId, isSuccess, data);
+    try
+    {
+        const transaction = Module.detectJournalDb.transaction(["chunks", "index"], "readwrite");
+        transaction.objectStore("chunks").put(UTF8ToString(data), number);
+        transaction.objectStore("index").put(JSON.parse(UTF8ToString(meta)), number);
+        transaction.oncomplete = () => reply(true, "");
+        transaction.onabort = () => reply(false, transaction.error ? transaction.error.name : "");
+    }
+    catch (e)
+    {
+        setTimeout(() => reply(false, e.name), 0);
+    }
+});
+
+EM_JS(void, detectJournalGet, (int requestId, double number), {
+    const reply = (isSuccess, data) => Module.detectJournalReply(requestId, isSuccess, data);
+    try
+    {
+        const request = Module.detectJournalDb.transaction("chunks", "readonly").objectStore("chunks").get(number);
+        request.onsuccess = () => reply(request.result !== undefined, request.result !== undefined ? request.result : "");
+        request.onerror = () => reply(false, request.error ? request.error.name : "");
+    }
+    catch (e)
+    {
+        setTimeout(() => reply(false, e.name), 0);
+    }
+});
+
+EM_JS(void, detectJournalRemove, (int requestId, double number), {
+    const reply = (isSuccess, data) => Module.detectJournalReply(requestId, isSuccess, data);
+    try
+    {
+        const transaction = Module.detectJournalDb.transaction(["chunks", "index"], "readwrite");
+        transaction.objectStore("chunks").delete(number);
+        transaction.objectStore("index").delete(number);
+        transaction.oncomplete = () => reply(true, "");
+        transaction.onabort = () => reply(false, transaction.error ? transaction.error.name : "");
+    }
+    catch (e)
+    {
+        setTimeout(() => reply(false, e.name), 0);
+    }
+});
+
+EMSCRIPTEN_BINDINGS(detectJournal)
+{
+    emscripten::function("detectJournalReply", &DetectJournal::reply);
+}
+
+//static
+void DetectJournal::reply(int requestId, bool isSuccess, const std::string &data)
+{
+    if (journalInstance != nullptr)
+    {
+        journalInstance->replyRequest(requestId, isSuccess, QString::fromStdString(data));
+    }
+}
+
+//static
+const char* DetectJournal::beforeUnload(int eventType, const void *reserved, void *userData)
+{
+    Q_UNUSED(eventType);
+    Q_UNUSED(reserved);
+    Q_UNUSED(userData);
+
+    //запись блока начинается синхронно в обработчике, и браузер завершает начатую транзакцию IndexedDB
+    if (journalInstance != nullptr)
+    {
+        journalInstance->saveTail();
+    }
+
+    return nullptr;
+}
+
+//static
+EM_BOOL DetectJournal::visibilityChange(int eventType, const EmscriptenVisibilityChangeEvent *visibilityChangeEvent, void *userData)
+{
+    Q_UNUSED(eventType);
+    Q_UNUSED(userData);
+
+    //мобильные браузеры закрывают скрытую вкладку без beforeunload, поэтому блок записывается при скрытии
+    if (journalInstance != nullptr && visibilityChangeEvent->hidden)
+    {
+        journalInstance->saveTail();
+    }
+
+    return EM_FALSE;
+}
+
+//class
+DetectJournal::DetectJournal(QObject* parent /* = nullptr */)
+    : QObject{parent}
+{
+    Q_ASSERT(journalInstance == nullptr);
+
+    journalInstance = this;
+
+    //до открытия базы события копятся в текущем блоке
+    _chunks.emplace_back();
+
+    _flushTimer = new QTimer(this);
+    _flushTimer->setSingleShot(true);
+    _flushTimer->setInterval(FLUSH_DELAY);
+
+    QObject::connect(_flushTimer, SIGNAL(timeout()), SLOT(flushTimerTimeout()));
+
+    //обработчики работают через journalInstance и не снимаются: снятие beforeunload удалило бы обработчик SessionStore
+    emscripten_set_beforeunload_callback(nullptr, DetectJournal::beforeUnload);
+    emscripten_set_visibilitychange_callback(nullptr, EM_FALSE, DetectJournal::visibilityChange);
+}
+
+DetectJournal::~DetectJournal()
+{
+    saveTail();
+
+    journalInstance = nullptr;
+}
+
+void DetectJournal::open()
+{
+    if (_isOpened || _isFailed)
+    {
+        return;
+    }
+
+    detectJournalOpen(addRequest({ERequestType::OPEN}));
+}
+
+bool DetectJournal::isOpened() const noexcept
+{
+    return _isOpened;
+}
+
+void DetectJournal::append(const TradingCatCommon::Detector::PKLineDetectData &detectData, const QByteArray &record)
+{
+    Q_CHECK_PTR(detectData);
+    Q_ASSERT(!record.isEmpty());
+    Q_ASSERT(!_chunks.empty());
+
+    if (_isFailed)
+    {
+        return;
+    }
+
+    //заполненный блок записывается окончательно, дальше события пишутся в следующий блок.
+    //до открытия базы заполненные блоки ждут записи в памяти, поэтому размер блока не зависит от скорости открытия
+    if (static_cast<quint64>(_tailRecords.size()) >= CHUNK_SIZE)
+    {
+        if (_isOpened)
+        {
+            saveTail();
+        }
+        else
+        {
+            _pendingRecords.push_back(_tailRecords);
+        }
+
+        _tailRecords.clear();
+
+        Chunk chunk;
+        chunk.lastTime = _chunks.back().lastTime;
+        _chunks.push_back(chunk);
+
+        while (_chunks.size() > MAX_CHUNKS)
+        {
+            if (_isOpened)
+            {
+                removeHead();
+            }
+            else
+            {
+                _chunks.pop_front();
+                _pendingRecords.pop_front();
+            }
+        }
+    }
+
+    const auto time = detectData->history->front()->closeTime;
+
+    auto& tail = _chunks.back();
+    if (tail.count == 0)
+    {
+        tail.firstTime = time;
+    }
+    tail.lastTime = std::max(tail.lastTime, time);
+    ++tail.count;
+
+    _tailRecords.push_back(QString::fromLatin1(record));
+
+    if (!_flushTimer->isActive())
+    {
+        _flushTimer->start();
+    }
+}
+
+quint64 DetectJournal::firstChunk() const noexcept
+{
+    return _isOpened ? _head : NO_CHUNK;
+}
+
+quint64 DetectJournal::lastChunk() const noexcept
+{
+    return _isOpened ? _head + _chunks.size() - 1 : NO_CHUNK;
+}
+
+quint64 DetectJournal::findChunk(qint64 time) const
+{
+    if (!_isOpened)
+    {
+        return NO_CHUNK;
+    }
+
+    //lastTime не убывает от блока к блоку, поэтому индекс упорядочен по нему
+    const auto it_chunks = std::lower_bound(_chunks.begin(), _chunks.end(), time,
+                                            [](const Chunk& chunk, qint64 time)
+                                            {
+                                                return chunk.lastTime < time;
+                                            });
+    if (it_chunks == _chunks.end())
+    {
+        return lastChunk();
+    }
+
+    return _head + static_cast<quint64>(std::distance(_chunks.begin(), it_chunks));
+}
+
+void DetectJournal::load(quint64 number)
+{
+    Q_ASSERT(_isOpened);
+    Q_ASSERT(number >= _head && number <= lastChunk());
+
+    //текущий блок уже в памяти
+    if (number == lastChunk())
+    {
+        QTimer::singleShot(0, this,
+                           [this, number, records = _tailRecords]()
+                           {
+                               emit chunkLoaded(number, decodeRecords(records));
+                           });
+
+        return;
+    }
+
+    detectJournalGet(addRequest({ERequestType::GET, number}), static_cast<double>(number));
+}
+
+void DetectJournal::flushTimerTimeout()
+{
+    saveTail();
+}
+
+void DetectJournal::replyRequest(int requestId, bool isSuccess, const QString &data)
+{
+    const auto it_requests = _requests.find(requestId);
+    if (it_requests == _requests.end())
+    {
+        return;
+    }
+
+    const auto request = std::move(it_requests->second);
+    _requests.erase(it_requests);
+
+    switch (request.type)
+    {
+    case ERequestType::OPEN:
+        opening(isSuccess, data);
+        break;
+    case ERequestType::PUT:
+        putting(request, isSuccess, data);
+        break;
+    case ERequestType::GET:
+        getting(request, isSuccess, data);
+        break;
+    case ERequestType::REMOVE:
+        if (!isSuccess)
+        {
+            qWarning() << "Detect journal: chunk" << request.number << "is not removed:" << data;
+        }
+        break;
+    default:
+        Q_ASSERT(false);
+    }
+}
+
+void DetectJournal::opening(bool isSuccess, const QString &data)
+{
+    if (!isSuccess)
+    {
+        qWarning() << "Detect journal: IndexedDB is not available:" << data;
+
+        _isFailed = true;
+        _tailRecords.clear();
+        _pendingRecords.clear();
+
+        return;
+    }
+
+    const auto pending = std::move(_chunks);
+    _chunks.clear();
+
+    //индекс приходит в порядке номеров блоков. Пропуски заполняются пустыми блоками
+    const auto index = QJsonDocument::fromJson(data.toUtf8()).array();
+    for (const auto& value: index)
+    {
+        const auto meta = value.toObject();
+        const auto number = static_cast<quint64>(meta["number"].toDouble());
+        if (_chunks.empty())
+        {
+            _head = number;
+        }
+        else if (number < _head + _chunks.size())
+        {
+            continue;
+        }
+
+        const auto lastTime = _chunks.empty() ? 0 : _chunks.back().lastTime;
+        while (_head + _chunks.size() < number)
+        {
+            auto& gap = _chunks.emplace_back();
+            gap.lastTime = lastTime;
+        }
+
+        auto& chunk = _chunks.emplace_back();
+        chunk.firstTime = static_cast<qint64>(meta["firstTime"].toDouble());
+        chunk.lastTime = std::max(lastTime, static_cast<qint64>(meta["lastTime"].toDouble()));
+        chunk.count = static_cast<quint64>(meta["count"].toDouble());
+    }
+
+    //события, полученные до открытия базы, начинают новые блоки. Последний из них - текущий блок
+    for (const auto& chunk: pending)
+    {
+        auto& newChunk = _chunks.emplace_back(chunk);
+        if (_chunks.size() > 1)
+        {
+            newChunk.lastTime = std::max(newChunk.lastTime, _chunks[_chunks.size() - 2].lastTime);
+        }
+    }
+
+    _isOpened = true;
+
+    const auto firstPending = lastChunk() + 1 - pending.size();
+
+    while (_chunks.size() > MAX_CHUNKS)
+    {
+        removeHead();
+    }
+
+    //заполненные до открытия блоки записываются, если не вытеснены ограничением MAX_CHUNKS
+    for (quint64 position = 0; position < _pendingRecords.size(); ++position)
+    {
+        const auto number = firstPending + position;
+        if (number >= _head)
+        {
+            put(number, _pendingRecords[position].join(RECORD_SEPARATOR));
+        }
+    }
+    _pendingRecords.clear();
+
+    qInfo() << "Detect journal: opened" << _chunks.size() - 1 << "chunk(s)";
+
+    saveTail();
+
+    emit opened();
+}
+
+void DetectJournal::putting(const Request &request, bool isSuccess, const QString &data)
+{
+    if (isSuccess)
+    {
+        return;
+    }
+
+    //при переполнении квоты освобождаем место за счет самых старых блоков и повторяем запись
+    if (data == "QuotaExceededError" && request.number > _head && request.number <= lastChunk())
+    {
+        removeHead();
+
+        //текущий блок мог измениться после неудачной записи - записываем его актуальное содержимое
+        if (request.number == lastChunk())
+        {
+            saveTail();
+        }
+        else
+        {
+            put(request.number, request.data);
+        }
+
+        return;
+    }
+
+    qWarning() << "Detect journal: chunk" << request.number << "is not saved:" << data;
+}
+
+void DetectJournal::getting(const Request &request, bool isSuccess, const QString &data)
+{
+    if (!isSuccess)
+    {
+        qWarning() << "Detect journal: chunk" << request.number << "is not loaded:" << data;
+    }
+
+    emit chunkLoaded(request.number, isSuccess ? decodeRecords(data.split(RECORD_SEPARATOR, Qt::SkipEmptyParts)) : DetectList());
+}
+
+int DetectJournal::addRequest(Request &&request)
+{
+    const auto requestId = ++_lastRequestId;
+    _requests.emplace(requestId, std::move(request));
+
+    return requestId;
+}
+
+void DetectJournal::saveTail()
+{
+    _flushTimer->stop();
+
+    if (!_isOpened || _tailRecords.empty())
+    {
+        return;
+    }
+
+    put(lastChunk(), _tailRecords.join(RECORD_SEPARATOR));
+}
+
+void DetectJournal::put(quint64 number, const QString &data)
+{
+    Q_ASSERT(_isOpened);
+
+    const auto requestId = addRequest({ERequestType::PUT, number, data});
+
+    detectJournalPut(requestId, static_cast<double>(number), chunkMeta(number).toUtf8().constData(), data.toLatin1().constData());
+}
+
+void DetectJournal::removeHead()
+{
+    Q_ASSERT(_isOpened);
+    Q_ASSERT(_chunks.size() > 1);
+
+    detectJournalRemove(addRequest({ERequestType::REMOVE, _head}), static_cast<double>(_head));
+
+    _chunks.pop_front();
+    ++_head;
+}
+
+QString DetectJournal::chunkMeta(quint64 number) const
+{
+    Q_ASSERT(number >= _head && number <= lastChunk());
+
+    const auto& chunk = _chunks[number - _head];
+
+    return QString("{\"number\":%1,\"firstTime\":%2,\"lastTime\":%3,\"count\":%4}")
+        .arg(number)
+        .arg(chunk.firstTime)
+        .arg(chunk.lastTime)
+        .arg(chunk.count);
+}
+
+//static
+DetectJournal::DetectList DetectJournal::decodeRecords(const QStringList &records)
+{
+    DetectList detected;
+    detected.reserve(records.size());
+    for (const auto& record: records)
+    {
+        auto detectData = SessionStore::decode(record.toLatin1());
+        if (detectData)
+        {
+            detected.push_back(std::move(detectData));
+        }
+    }
+
+    return detected;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+//STL
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <limits>
+
+//Qt
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+//EM
+#include <emscripten/html5.h>
+
+//My
+#include <TradingCatCommon/detector.h>
+
+/*!
+    Постоянный журнал всех событий детектирования в IndexedDB браузера. События дописываются в конец журнала
+    блоками (chunk) по CHUNK_SIZE событий: заполненный блок больше не изменяется, текущий блок перезаписывается
+    не чаще FLUSH_DELAY, а при закрытии или скрытии вкладки - сразу. Для каждого блока хранится интервал времени его событий, заголовки всех блоков
+    держатся в памяти и образуют индекс по времени, а сами события загружаются с диска по одному блоку по запросу.
+    IndexedDB работает асинхронно, поэтому результаты загрузки передаются сигналами
+*/
+class DetectJournal
+    : public QObject
+{
+    Q_OBJECT
+
+public:
+    using DetectList = std::vector<TradingCatCommon::Detector::PKLineDetectData>;
+
+    static constexpr quint64 CHUNK_SIZE = 100;                                 ///< количество событий в одном блоке
+    static constexpr quint64 NO_CHUNK = std::numeric_limits<quint64>::max();   ///< номер несуществующего блока
+
+    /*!
+        Обработчик ответа IndexedDB. Вызывается из JS
+        @param requestId - ИД запроса
+        @param isSuccess - true - запрос выполнен успешно
+        @param data - данные ответа или имя ошибки
+    */
+    static void reply(int requestId, bool isSuccess, const std::string& data);
+
+private:
+    static const char* beforeUnload(int eventType, const void* reserved, void* userData);
+    static EM_BOOL visibilityChange(int eventType, const EmscriptenVisibilityChangeEvent* visibilityChangeEvent, void* userData);
+
+public:
+    explicit DetectJournal(QObject* parent = nullptr);
+    ~DetectJournal();
+
+    /*!
+        Открывает базу и загружает индекс блоков. По завершении испускается opened()
+    */
+    void open();
+    bool isOpened() const noexcept;
+
+    /*!
+        Дописывает событие в конец журнала
+        @param detectData - событие
+        @param record - запись события, полученная SessionStore::encode()
+    */
+    void append(const TradingCatCommon::Detector::PKLineDetectData& detectData, const QByteArray& record);
+
+    /*!
+        @return номер самого старого блока или NO_CHUNK если журнал пуст
+    */
+    quint64 firstChunk() const noexcept;
+
+    /*!
+        @return номер текущего (дописываемого) блока или NO_CHUNK если журнал пуст
+    */
+    quint64 lastChunk() const noexcept;
+
+    /*!
+        Ищет блок по времени двоичным поиском по индексу
+        @param time - время, мс
+        @return номер первого блока, содержащего события не раньше time, или последний блок, если таких нет
+    */
+    quint64 findChunk(qint64 time) const;
+
+    /*!
+        Запускает загрузку блока. По завершении испускается chunkLoaded()
+        @param number - номер блока
+    */
+    void load(quint64 number);
+
+signals:
+    void opened();
+
+    /*!
+        Блок загружен
+        @param number - номер блока
+        @param detected - события блока в порядке поступления. Пусто, если блок не удалось прочитать
+    */
+    void chunkLoaded(quint64 number, const DetectJournal::DetectList& detected);
+
+private slots:
+    void flushTimerTimeout();
+
+private:
+    Q_DISABLE_COPY_MOVE(DetectJournal);
+
+    enum class ERequestType: quint8
+    {
+        OPEN = 0,
+        PUT,
+        GET,
+        REMOVE
+    };
+
+    struct Request
+    {
+        ERequestType type = ERequestType::OPEN;
+        quint64 number = NO_CHUNK;   ///< номер блока
+        QString data;                ///< данные записываемого блока для повторной записи
+    };
+
+    struct Chunk
+    {
+        qint64 firstTime = 0;   ///< время первого события блока, мс
+        qint64 lastTime = 0;    ///< наибольшее время событий блока и всех предыдущих блоков, мс
+        quint64 count = 0;      ///< количество событий блока
+    };
+
+    void replyRequest(int requestId, bool isSuccess, const QString& data);
+    void opening(bool isSuccess, const QString& data);
+    void putting(const Request& request, bool isSuccess, const QString& data);
+    void getting(const Request& request, bool isSuccess, const QString& data);
+
+    int addRequest(Request&& request);
+    void saveTail();
+    void put(quint64 number, const QString& data);
+    void removeHead();
+
+    QString chunkMeta(quint64 number) const;
+
+    static DetectList decodeRecords(const QStringList& records);
+
+private:
+    bool _isOpened = false;
+    bool _isFailed = false;             ///< IndexedDB недоступна, журнал не ведется
+
+    quint64 _head = 0;                  ///< номер самого старого блока
+    std::deque<Chunk> _chunks;          ///< индекс блоков от _head до текущего блока включительно
+    QStringList _tailRecords;           ///< записи текущего блока
+    std::deque<QStringList> _pendingRecords;  ///< записи заполненных блоков, полученных до открытия базы. Идут перед текущим блоком
+
+    std::unordered_map<int, Request> _requests;  ///< запросы, ожидающие ответа IndexedDB
+    int _lastRequestId = 0;
+
+    QTimer* _flushTimer = nullptr;      ///< таймер отложенной записи текущего блока
+
+};
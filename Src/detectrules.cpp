@@ -0,0 +1,144 @@
+//STL
+#include <algorithm>
+
+#include "detectrules.h"
+
+using namespace TradingCatCommon;
+
+DetectRules::DetectRules(const TradingCatCommon::UserConfig &config)
+{
+    auto& internTable = InternTable::instance();
+
+    const auto& filter = config.filter();
+
+    for (const auto& filterData: filter.klineFilter())
+    {
+        _hasThresholds = true;
+
+        const Threshold threshold{filterData.delta().value_or(KLineFilterData::MinDelta), filterData.volume().value_or(KLineFilterData::MinVolume)};
+
+        const auto o_stockExchangeId = filterData.stockExchangeID();
+        if (!o_stockExchangeId.has_value() || o_stockExchangeId.value().isEmpty())
+        {
+            addThreshold(_anyStockExchange, threshold);
+
+            continue;
+        }
+
+        const auto stockExchangeId = internTable.stockExchange(o_stockExchangeId.value());
+        if (stockExchangeId >= _byStockExchange.size())
+        {
+            _byStockExchange.resize(stockExchangeId + 1);
+        }
+
+        addThreshold(_byStockExchange[stockExchangeId], threshold);
+    }
+
+    //пороги для всех бирж добавляются к порогам каждой биржи, поэтому проверка события смотрит только одну таблицу
+    _byStockExchange.resize(std::max<qsizetype>(_byStockExchange.size(), internTable.stockExchangesCount()));
+    for (auto& thresholds: _byStockExchange)
+    {
+        for (const auto& threshold: _anyStockExchange)
+        {
+            addThreshold(thresholds, threshold);
+        }
+    }
+
+    for (const auto& blackListData: filter.blackList())
+    {
+        const auto o_stockExchangeId = blackListData.stockExchangeID();
+        const auto stockExchangeId = o_stockExchangeId.has_value() && !o_stockExchangeId.value().isEmpty() ? internTable.stockExchange(o_stockExchangeId.value()) : ANY;
+
+        const auto o_klineId = blackListData.klineID();
+        const auto symbolId = o_klineId.has_value() && !o_klineId.value().isEmpty() ? internTable.symbol(o_klineId.value().symbol) : ANY;
+
+        //строка без биржи и без символа не задает ограничений
+        if (stockExchangeId == ANY && symbolId == ANY)
+        {
+            continue;
+        }
+
+        _blackList.insert(blackListKey(stockExchangeId, symbolId));
+    }
+}
+
+bool DetectRules::isEmpty() const noexcept
+{
+    return !_hasThresholds && _blackList.empty();
+}
+
+bool DetectRules::match(const EventListModel::EventRecord &record) const
+{
+    if (record.type != EventListModel::EEventType::DETECT)
+    {
+        return true;
+    }
+
+    if (!_blackList.empty()
+        && (_blackList.contains(blackListKey(record.stockExchangeId, record.symbolId))
+            || _blackList.contains(blackListKey(ANY, record.symbolId))
+            || _blackList.contains(blackListKey(record.stockExchangeId, ANY))))
+    {
+        return false;
+    }
+
+    if (!_hasThresholds)
+    {
+        return true;
+    }
+
+    const auto& thresholds = record.stockExchangeId < _byStockExchange.size() ? _byStockExchange[record.stockExchangeId] : _anyStockExchange;
+
+    return matchThresholds(thresholds, record);
+}
+
+void DetectRules::addThreshold(Thresholds &thresholds, const Threshold &threshold)
+{
+    //порог лишний, если есть порог не строже и по дельте, и по объему
+    const auto isCovered = std::any_of(thresholds.begin(), thresholds.end(),
+                                       [&threshold](const auto& item)
+                                       {
+                                           return item.delta <= threshold.delta && item.volume <= threshold.volume;
+                                       });
+    if (isCovered)
+    {
+        return;
+    }
+
+    std::erase_if(thresholds,
+                  [&threshold](const auto& item)
+                  {
+                      return threshold.delta <= item.delta && threshold.volume <= item.volume;
+                  });
+
+    const auto it_thresholds = std::lower_bound(thresholds.begin(), thresholds.end(), threshold.delta,
+                                                [](const auto& item, double delta)
+                                                {
+                                                    return item.delta < delta;
+                                                });
+    thresholds.insert(it_thresholds, threshold);
+}
+
+bool DetectRules::matchThresholds(const Thresholds &thresholds, const EventListModel::EventRecord &record) noexcept
+{
+    //пороги отсортированы по возрастанию дельты и, следовательно, по убыванию объема
+    for (const auto& threshold: thresholds)
+    {
+        if (threshold.delta > record.delta)
+        {
+            return false;
+        }
+
+        if (threshold.volume <= record.volume)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+quint64 DetectRules::blackListKey(InternTable::ID stockExchangeId, InternTable::ID symbolId) noexcept
+{
+    return (static_cast<quint64>(stockExchangeId) << 32) | symbolId;
+}
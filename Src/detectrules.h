@@ -0,0 +1,63 @@
+#pragma once
+
+//STL
+#include <vector>
+#include <unordered_set>
+#include <limits>
+
+//My
+#include <TradingCatCommon/transmitdata.h>
+
+#include "interntable.h"
+#include "eventlistmodel.h"
+
+/*!
+    Правила фильтрации событий детектирования пользователя, скомпилированные для быстрой проверки на клиенте:
+    таблица порогов дельты и объема по ИД биржи и хэш-множество черного списка пар биржа/символ.
+    Позволяет сразу применить изменения таблиц фильтров к уже полученным событиям, не дожидаясь ответа сервера
+*/
+class DetectRules
+{
+public:
+    DetectRules() = default;
+
+    /*!
+        Компилирует правила из настроек пользователя
+        @param config - настройки пользователя
+    */
+    explicit DetectRules(const TradingCatCommon::UserConfig& config);
+
+    /*!
+        @return true - правила пропускают все события
+    */
+    bool isEmpty() const noexcept;
+
+    /*!
+        @param record - событие
+        @return true - событие удовлетворяет правилам. Сообщения всегда удовлетворяют правилам
+    */
+    bool match(const EventListModel::EventRecord& record) const;
+
+private:
+    static constexpr InternTable::ID ANY = std::numeric_limits<InternTable::ID>::max();  ///< любая биржа или любой символ
+
+    struct Threshold
+    {
+        double delta = 0.0;
+        double volume = 0.0;
+    };
+
+    using Thresholds = std::vector<Threshold>; ///< пороги в порядке возрастания дельты. Ни один порог не перекрывает другой
+
+    static void addThreshold(Thresholds& thresholds, const Threshold& threshold);
+    static bool matchThresholds(const Thresholds& thresholds, const EventListModel::EventRecord& record) noexcept;
+    static quint64 blackListKey(InternTable::ID stockExchangeId, InternTable::ID symbolId) noexcept;
+
+private:
+    bool _hasThresholds = false;                    ///< true - задана хотя бы одна строка фильтра
+    Thresholds _anyStockExchange;                   ///< пороги для всех бирж
+    std::vector<Thresholds> _byStockExchange;       ///< пороги по ИД биржи, включая пороги для всех бирж
+
+    std::unordered_set<quint64> _blackList;         ///< ключи blackListKey() пар биржа/символ черного списка
+
+};
@@ -0,0 +1,345 @@
+//STL
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "detectstatistics.h"
+
+//верхние границы корзин гистограмм. Последняя корзина не ограничена сверху
+static const std::array<double, DetectStatistics::DELTA_BUCKETS - 1> DELTA_BOUNDS = {1.0, 2.0, 3.0, 5.0, 7.5, 10.0, 15.0, 20.0, 50.0};
+static const std::array<double, DetectStatistics::VOLUME_BUCKETS - 1> VOLUME_BOUNDS = {1e3, 3e3, 1e4, 3e4, 1e5, 3e5, 1e6, 3e6, 1e7};
+
+//длительность слота и количество слотов окон
+static const std::array<std::pair<qint64, qsizetype>, static_cast<size_t>(DetectStatistics::EWindow::COUNT)> WINDOW_SLOTS =
+{{
+    {60 * 1000, 5},            //5 минут по минуте
+    {5 * 60 * 1000, 12},       //час по 5 минут
+    {60 * 60 * 1000, 24}       //сутки по часу
+}};
+
+//static
+const char* DetectStatistics::windowName(EWindow window) noexcept
+{
+    switch (window)
+    {
+    case EWindow::MIN5: return "5 m";
+    case EWindow::H1: return "1 h";
+    case EWindow::H24: return "24 h";
+    case EWindow::COUNT:
+    default:
+        Q_ASSERT(false);
+    }
+
+    return "";
+}
+
+QString DetectStatistics::deltaBucketName(qsizetype bucket)
+{
+    Q_ASSERT(bucket >= 0 && bucket < DELTA_BUCKETS);
+
+    if (bucket == DELTA_BUCKETS - 1)
+    {
+        return QString(">%1%").arg(DELTA_BOUNDS.back());
+    }
+
+    return QString("<%1%").arg(DELTA_BOUNDS[bucket]);
+}
+
+QString DetectStatistics::volumeBucketName(qsizetype bucket)
+{
+    Q_ASSERT(bucket >= 0 && bucket < VOLUME_BUCKETS);
+
+    if (bucket == VOLUME_BUCKETS - 1)
+    {
+        return QString(">%1").arg(VOLUME_BOUNDS.back(), 0, 'g', 3);
+    }
+
+    return QString("<%1").arg(VOLUME_BOUNDS[bucket], 0, 'g', 3);
+}
+
+//Counters
+void DetectStatistics::Counters::add(InternTable::ID stockExchangeId, Key key, qsizetype deltaBucket, qsizetype volumeBucket)
+{
+    ++total;
+
+    if (stockExchangeId >= stockExchanges.size())
+    {
+        stockExchanges.resize(stockExchangeId + 1, 0);
+    }
+    ++stockExchanges[stockExchangeId];
+
+    ++delta[deltaBucket];
+    ++volume[volumeBucket];
+
+    for (qsizetype row = 0; row < SKETCH_DEPTH; ++row)
+    {
+        ++sketch[sketchIndex(key, row)];
+    }
+}
+
+void DetectStatistics::Counters::subtract(const Counters &other)
+{
+    Q_ASSERT(stockExchanges.size() >= other.stockExchanges.size());
+
+    total -= other.total;
+
+    for (size_t index = 0; index < other.stockExchanges.size(); ++index)
+    {
+        stockExchanges[index] -= other.stockExchanges[index];
+    }
+
+    for (qsizetype bucket = 0; bucket < DELTA_BUCKETS; ++bucket)
+    {
+        delta[bucket] -= other.delta[bucket];
+    }
+
+    for (qsizetype bucket = 0; bucket < VOLUME_BUCKETS; ++bucket)
+    {
+        volume[bucket] -= other.volume[bucket];
+    }
+
+    for (size_t index = 0; index < sketch.size(); ++index)
+    {
+        sketch[index] -= other.sketch[index];
+    }
+}
+
+void DetectStatistics::Counters::clear()
+{
+    total = 0;
+    std::fill(stockExchanges.begin(), stockExchanges.end(), 0);
+    delta.fill(0);
+    volume.fill(0);
+    std::fill(sketch.begin(), sketch.end(), 0);
+}
+
+quint32 DetectStatistics::Counters::estimate(Key key) const
+{
+    auto result = std::numeric_limits<quint32>::max();
+    for (qsizetype row = 0; row < SKETCH_DEPTH; ++row)
+    {
+        result = std::min(result, sketch[sketchIndex(key, row)]);
+    }
+
+    return result;
+}
+
+//class
+DetectStatistics::DetectStatistics()
+{
+    for (size_t window = 0; window < _windows.size(); ++window)
+    {
+        _windows[window].slotDuration = WINDOW_SLOTS[window].first;
+        _windows[window].slots.resize(WINDOW_SLOTS[window].second);
+        _windows[window].top.reserve(TOP_CAPACITY);
+    }
+}
+
+void DetectStatistics::add(InternTable::ID stockExchangeId, InternTable::ID symbolId, double delta, double volume, qint64 time)
+{
+    const auto key = makeKey(stockExchangeId, symbolId);
+    const auto currentDeltaBucket = deltaBucket(delta);
+    const auto currentVolumeBucket = volumeBucket(volume);
+
+    for (auto& window: _windows)
+    {
+        const auto slot = time / window.slotDuration;
+        const auto slotsCount = static_cast<qint64>(window.slots.size());
+
+        //слишком старое детектирование уже вышло за пределы окна
+        if (window.slot != 0 && slot + slotsCount <= window.slot)
+        {
+            continue;
+        }
+
+        advanceWindow(window, slot);
+
+        window.slots[slot % slotsCount].add(stockExchangeId, key, currentDeltaBucket, currentVolumeBucket);
+        window.sum.add(stockExchangeId, key, currentDeltaBucket, currentVolumeBucket);
+
+        updateTop(window, key, window.sum.estimate(key));
+    }
+}
+
+void DetectStatistics::advance(qint64 time)
+{
+    for (auto& window: _windows)
+    {
+        if (window.slot != 0)
+        {
+            advanceWindow(window, time / window.slotDuration);
+        }
+    }
+}
+
+DetectStatistics::Statistic DetectStatistics::statistic(EWindow window) const
+{
+    Q_ASSERT(window != EWindow::COUNT);
+
+    const auto& currentWindow = _windows[static_cast<size_t>(window)];
+
+    Statistic result;
+    result.total = currentWindow.sum.total;
+    result.stockExchanges = currentWindow.sum.stockExchanges;
+    result.delta = currentWindow.sum.delta;
+    result.volume = currentWindow.sum.volume;
+
+    auto top = currentWindow.top;
+    std::sort(top.begin(), top.end(),
+              [](const auto& entry1, const auto& entry2)
+              {
+                  return entry1.count > entry2.count;
+              });
+
+    const auto count = std::min<qsizetype>(TOP_COUNT, static_cast<qsizetype>(top.size()));
+    result.top.reserve(count);
+    for (qsizetype index = 0; index < count; ++index)
+    {
+        result.top.push_back({static_cast<InternTable::ID>(top[index].key >> 32), static_cast<InternTable::ID>(top[index].key), top[index].count});
+    }
+
+    return result;
+}
+
+void DetectStatistics::clear()
+{
+    for (auto& window: _windows)
+    {
+        for (auto& slot: window.slots)
+        {
+            slot.clear();
+        }
+
+        window.sum.clear();
+        window.top.clear();
+        window.slot = 0;
+    }
+}
+
+DetectStatistics::Key DetectStatistics::makeKey(InternTable::ID stockExchangeId, InternTable::ID symbolId) noexcept
+{
+    return (static_cast<Key>(stockExchangeId) << 32) | symbolId;
+}
+
+qsizetype DetectStatistics::sketchIndex(Key key, qsizetype row) noexcept
+{
+    //splitmix64 с разным начальным значением для каждой строки
+    auto hash = key + 0x9E3779B97F4A7C15ull * static_cast<quint64>(row + 1);
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+    hash = hash ^ (hash >> 31);
+
+    return row * SKETCH_WIDTH + static_cast<qsizetype>(hash % SKETCH_WIDTH);
+}
+
+qsizetype DetectStatistics::deltaBucket(double delta) noexcept
+{
+    return std::upper_bound(DELTA_BOUNDS.begin(), DELTA_BOUNDS.end(), std::abs(delta)) - DELTA_BOUNDS.begin();
+}
+
+qsizetype DetectStatistics::volumeBucket(double volume) noexcept
+{
+    return std::upper_bound(VOLUME_BOUNDS.begin(), VOLUME_BOUNDS.end(), volume) - VOLUME_BOUNDS.begin();
+}
+
+void DetectStatistics::advanceWindow(Window &window, qint64 slot)
+{
+    if (window.slot == 0)
+    {
+        window.slot = slot;
+
+        return;
+    }
+
+    if (slot <= window.slot)
+    {
+        return;
+    }
+
+    //вычитаем слоты, которые будут заняты новыми интервалами
+    const auto slotsCount = static_cast<qint64>(window.slots.size());
+    const auto steps = std::min<qint64>(slot - window.slot, slotsCount);
+
+    bool isExpired = false;
+    for (qint64 step = 1; step <= steps; ++step)
+    {
+        auto& expired = window.slots[(window.slot + step) % slotsCount];
+        if (expired.total == 0)
+        {
+            continue;
+        }
+
+        window.sum.subtract(expired);
+        expired.clear();
+        isExpired = true;
+    }
+
+    window.slot = slot;
+
+    if (isExpired)
+    {
+        refreshTop(window);
+    }
+}
+
+void DetectStatistics::updateTop(Window &window, Key key, quint32 count)
+{
+    const auto compare = [](const TopEntry& entry1, const TopEntry& entry2)
+    {
+        return entry1.count > entry2.count;
+    };
+
+    auto& top = window.top;
+
+    const auto it_top = std::find_if(top.begin(), top.end(),
+                                     [key](const auto& entry)
+                                     {
+                                         return entry.key == key;
+                                     });
+    if (it_top != top.end())
+    {
+        it_top->count = count;
+        std::make_heap(top.begin(), top.end(), compare);
+
+        return;
+    }
+
+    if (static_cast<qsizetype>(top.size()) < TOP_CAPACITY)
+    {
+        top.push_back({key, count});
+        std::push_heap(top.begin(), top.end(), compare);
+
+        return;
+    }
+
+    //вытесняем пару с наименьшей оценкой
+    if (count <= top.front().count)
+    {
+        return;
+    }
+
+    std::pop_heap(top.begin(), top.end(), compare);
+    top.back() = {key, count};
+    std::push_heap(top.begin(), top.end(), compare);
+}
+
+void DetectStatistics::refreshTop(Window &window)
+{
+    auto& top = window.top;
+    for (auto& entry: top)
+    {
+        entry.count = window.sum.estimate(entry.key);
+    }
+
+    std::erase_if(top,
+                  [](const auto& entry)
+                  {
+                      return entry.count == 0;
+                  });
+
+    std::make_heap(top.begin(), top.end(),
+                   [](const TopEntry& entry1, const TopEntry& entry2)
+                   {
+                       return entry1.count > entry2.count;
+                   });
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+//STL
+#include <array>
+#include <vector>
+
+//Qt
+#include <QtGlobal>
+#include <QString>
+
+//My
+#include "interntable.h"
+
+/*!
+    Скользящая статистика детектирований за последние 5 минут, час и сутки: количество детектирований по биржам,
+    самые часто детектируемые символы и распределения дельты и объема.
+    Каждое окно разбито на слоты фиксированной длительности. Слот хранит счетчики бирж, гистограммы с фиксированными
+    границами корзин и count-min sketch частот пар (биржа, символ). Счетчики окна - сумма счетчиков его слотов:
+    при добавлении детектирования увеличиваются счетчики слота и окна, при выходе слота за пределы окна его счетчики
+    вычитаются из счетчиков окна. Самые частые пары хранятся в куче ограниченного размера с оценками из sketch.
+    Объем памяти не зависит от количества детектирований и количества символов
+*/
+class DetectStatistics
+{
+public:
+    enum class EWindow: quint8
+    {
+        MIN5 = 0,
+        H1,
+        H24,
+        COUNT
+    };
+
+    static const char* windowName(EWindow window) noexcept;
+
+    static constexpr qsizetype TOP_COUNT = 10;      ///< количество самых частых символов в статистике
+    static constexpr qsizetype DELTA_BUCKETS = 10;  ///< количество корзин гистограммы дельты
+    static constexpr qsizetype VOLUME_BUCKETS = 10; ///< количество корзин гистограммы объема
+
+    struct TopSymbol
+    {
+        InternTable::ID stockExchangeId = 0;
+        InternTable::ID symbolId = 0;
+        quint32 count = 0;  ///< оценка количества детектирований сверху
+    };
+
+    struct Statistic
+    {
+        quint32 total = 0;                             ///< количество детектирований
+        std::vector<quint32> stockExchanges;           ///< количество детектирований. Индекс - ИД биржи в InternTable
+        std::vector<TopSymbol> top;                    ///< самые частые символы по убыванию количества
+        std::array<quint32, DELTA_BUCKETS> delta = {};   ///< гистограмма дельты
+        std::array<quint32, VOLUME_BUCKETS> volume = {}; ///< гистограмма объема
+    };
+
+    /*!
+        @param bucket - номер корзины гистограммы дельты
+        @return подпись корзины
+    */
+    static QString deltaBucketName(qsizetype bucket);
+
+    /*!
+        @param bucket - номер корзины гистограммы объема
+        @return подпись корзины
+    */
+    static QString volumeBucketName(qsizetype bucket);
+
+public:
+    DetectStatistics();
+
+    /*!
+        Учитывает детектирование во всех окнах
+        @param stockExchangeId - ИД биржи
+        @param symbolId - ИД символа
+        @param delta - дельта, %
+        @param volume - объем
+        @param time - время детектирования, мс
+    */
+    void add(InternTable::ID stockExchangeId, InternTable::ID symbolId, double delta, double volume, qint64 time);
+
+    /*!
+        Сдвигает окна к текущему времени, исключая устаревшие слоты. Вызывается перед чтением статистики,
+        чтобы окна сдвигались и без новых детектирований
+        @param time - текущее время, мс
+    */
+    void advance(qint64 time);
+
+    /*!
+        @param window - окно
+        @return статистика окна
+    */
+    Statistic statistic(EWindow window) const;
+
+    void clear();
+
+private:
+    Q_DISABLE_COPY_MOVE(DetectStatistics);
+
+    using Key = quint64;
+
+    static constexpr qsizetype SKETCH_DEPTH = 4;     ///< количество хэш функций count-min sketch
+    static constexpr qsizetype SKETCH_WIDTH = 1024;  ///< количество счетчиков на одну хэш функцию
+    static constexpr qsizetype TOP_CAPACITY = TOP_COUNT * 4; ///< размер кучи кандидатов в самые частые пары
+
+    struct Counters
+    {
+        quint32 total = 0;
+        std::vector<quint32> stockExchanges;
+        std::array<quint32, DELTA_BUCKETS> delta = {};
+        std::array<quint32, VOLUME_BUCKETS> volume = {};
+        std::vector<quint32> sketch = std::vector<quint32>(SKETCH_DEPTH * SKETCH_WIDTH, 0);
+
+        void add(InternTable::ID stockExchangeId, Key key, qsizetype deltaBucket, qsizetype volumeBucket);
+        void subtract(const Counters& other);
+        void clear();
+
+        /*!
+            @return оценка количества детектирований пары сверху
+        */
+        quint32 estimate(Key key) const;
+    };
+
+    struct TopEntry
+    {
+        Key key = 0;
+        quint32 count = 0;
+    };
+
+    struct Window
+    {
+        qint64 slotDuration = 0;       ///< длительность слота, мс
+        std::vector<Counters> slots;   ///< слоты. Индекс - абсолютный номер слота % количество слотов
+        qint64 slot = 0;               ///< абсолютный номер текущего слота. 0 - окно еще не использовалось
+        Counters sum;                  ///< сумма счетчиков всех слотов
+        std::vector<TopEntry> top;     ///< куча кандидатов. В начале - пара с наименьшей оценкой
+    };
+
+    static Key makeKey(InternTable::ID stockExchangeId, InternTable::ID symbolId) noexcept;
+    static qsizetype sketchIndex(Key key, qsizetype row) noexcept;
+    static qsizetype deltaBucket(double delta) noexcept;
+    static qsizetype volumeBucket(double volume) noexcept;
+
+    static void advanceWindow(Window& window, qint64 slot);
+    static void updateTop(Window& window, Key key, quint32 count);
+    static void refreshTop(Window& window);
+
+private:
+    std::array<Window, static_cast<size_t>(EWindow::COUNT)> _windows;
+
+};
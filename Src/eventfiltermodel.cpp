@@ -0,0 +1,430 @@
+//STL
+#include <algorithm>
+
+#include "eventfiltermodel.h"
+
+EventFilterModel::EventFilterModel(EventListModel *eventListModel, QObject *parent /* = nullptr */)
+    : QAbstractProxyModel(parent)
+    , _eventListModel(eventListModel)
+{
+    Q_CHECK_PTR(_eventListModel);
+
+    setSourceModel(_eventListModel);
+
+    for (int row = 0; row < _eventListModel->rowCount(); ++row)
+    {
+        _searchIndex.add(_eventListModel->record(row));
+    }
+
+    connect(_eventListModel, SIGNAL(rowsAboutToBeInserted(const QModelIndex&, int, int)), SLOT(sourceRowsAboutToBeInserted(const QModelIndex&, int, int)));
+    connect(_eventListModel, SIGNAL(rowsInserted(const QModelIndex&, int, int)), SLOT(sourceRowsInserted(const QModelIndex&, int, int)));
+    connect(_eventListModel, SIGNAL(rowsAboutToBeRemoved(const QModelIndex&, int, int)), SLOT(sourceRowsAboutToBeRemoved(const QModelIndex&, int, int)));
+    connect(_eventListModel, SIGNAL(rowsRemoved(const QModelIndex&, int, int)), SLOT(sourceRowsRemoved(const QModelIndex&, int, int)));
+    connect(_eventListModel, SIGNAL(modelAboutToBeReset()), SLOT(sourceModelAboutToBeReset()));
+    connect(_eventListModel, SIGNAL(modelReset()), SLOT(sourceModelReset()));
+    connect(_eventListModel, SIGNAL(dataChanged(const QModelIndex&, const QModelIndex&, const QList<int>&)),
+            SLOT(sourceDataChanged(const QModelIndex&, const QModelIndex&, const QList<int>&)));
+    connect(_eventListModel, SIGNAL(recordAboutToBeChanged(int)), SLOT(sourceRecordAboutToBeChanged(int)));
+    connect(_eventListModel, SIGNAL(recordChanged(int)), SLOT(sourceRecordChanged(int)));
+}
+
+QModelIndex EventFilterModel::index(int row, int column, const QModelIndex &parent /* = QModelIndex() */) const
+{
+    if (parent.isValid() || column != 0 || row < 0 || row >= rowCount())
+    {
+        return QModelIndex();
+    }
+
+    return createIndex(row, column);
+}
+
+QModelIndex EventFilterModel::parent(const QModelIndex &child) const
+{
+    Q_UNUSED(child);
+
+    return QModelIndex();
+}
+
+int EventFilterModel::rowCount(const QModelIndex &parent /* = QModelIndex() */) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+
+    return _isFiltered ? static_cast<int>(_matches.size()) : _eventListModel->rowCount();
+}
+
+int EventFilterModel::columnCount(const QModelIndex &parent /* = QModelIndex() */) const
+{
+    return parent.isValid() ? 0 : 1;
+}
+
+QModelIndex EventFilterModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid())
+    {
+        return QModelIndex();
+    }
+
+    const auto row = sourceRow(proxyIndex.row());
+    if (row < 0)
+    {
+        return QModelIndex();
+    }
+
+    return _eventListModel->index(row);
+}
+
+QModelIndex EventFilterModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid())
+    {
+        return QModelIndex();
+    }
+
+    if (!_isFiltered)
+    {
+        return index(sourceIndex.row(), 0);
+    }
+
+    const auto row = this->row(_eventListModel->record(sourceIndex.row()).index);
+    if (row < 0)
+    {
+        return QModelIndex();
+    }
+
+    return index(row, 0);
+}
+
+void EventFilterModel::setFilter(const EventSearchIndex::Filter &filter)
+{
+    beginResetModel();
+
+    _filter = filter;
+    updateMatches();
+
+    endResetModel();
+}
+
+void EventFilterModel::setRules(const DetectRules &rules)
+{
+    beginResetModel();
+
+    _rules = rules;
+    updateMatches();
+
+    endResetModel();
+}
+
+void EventFilterModel::setCollapseGroups(bool isCollapseGroups)
+{
+    if (_isCollapseGroups == isCollapseGroups)
+    {
+        return;
+    }
+
+    beginResetModel();
+
+    _isCollapseGroups = isCollapseGroups;
+    updateMatches();
+
+    endResetModel();
+}
+
+bool EventFilterModel::isCollapseGroups() const noexcept
+{
+    return _isCollapseGroups;
+}
+
+void EventFilterModel::toggleGroup(quint64 groupIndex)
+{
+    if (!_expandedGroups.erase(groupIndex))
+    {
+        _expandedGroups.insert(groupIndex);
+    }
+
+    if (!_isCollapseGroups)
+    {
+        return;
+    }
+
+    beginResetModel();
+    updateMatches();
+    endResetModel();
+}
+
+bool EventFilterModel::isFiltered() const noexcept
+{
+    return _isFiltered;
+}
+
+const EventListModel::EventRecord &EventFilterModel::record(int row) const
+{
+    return _eventListModel->record(sourceRow(row));
+}
+
+int EventFilterModel::row(quint64 index) const
+{
+    if (!_isFiltered)
+    {
+        return _eventListModel->row(index);
+    }
+
+    const auto it_matches = std::lower_bound(_matches.begin(), _matches.end(), index);
+    if (it_matches == _matches.end() || *it_matches != index)
+    {
+        return -1;
+    }
+
+    return static_cast<int>(std::distance(_matches.begin(), it_matches));
+}
+
+void EventFilterModel::sourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last)
+{
+    if (!_isFiltered)
+    {
+        beginInsertRows(parent, first, last);
+    }
+}
+
+void EventFilterModel::sourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+
+    for (auto row = first; row <= last; ++row)
+    {
+        _searchIndex.add(_eventListModel->record(row));
+    }
+
+    if (!_isFiltered)
+    {
+        endInsertRows();
+
+        return;
+    }
+
+    //новые события проверяются сразу, без повторного запроса к индексам
+    std::vector<quint64> matches;
+    for (auto row = first; row <= last; ++row)
+    {
+        const auto& eventRecord = _eventListModel->record(row);
+        if (isMatch(eventRecord))
+        {
+            matches.push_back(eventRecord.index);
+        }
+    }
+
+    if (matches.empty())
+    {
+        return;
+    }
+
+    const auto firstRow = static_cast<int>(_matches.size());
+    beginInsertRows(QModelIndex(), firstRow, firstRow + static_cast<int>(matches.size()) - 1);
+    _matches.insert(_matches.end(), matches.begin(), matches.end());
+    endInsertRows();
+}
+
+void EventFilterModel::sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    for (auto row = first; row <= last; ++row)
+    {
+        const auto& eventRecord = _eventListModel->record(row);
+        _searchIndex.remove(eventRecord);
+
+        if (eventRecord.isGroupLeader())
+        {
+            _expandedGroups.erase(eventRecord.index);
+        }
+    }
+
+    if (!_isFiltered)
+    {
+        beginRemoveRows(parent, first, last);
+
+        return;
+    }
+
+    //из исходной модели удаляются только самые старые строки, поэтому удаляемые совпадения - в начале списка
+    Q_ASSERT(first == 0);
+
+    const auto lastIndex = _eventListModel->record(last).index;
+    _removeCount = std::distance(_matches.begin(), std::upper_bound(_matches.begin(), _matches.end(), lastIndex));
+    if (_removeCount > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(_removeCount) - 1);
+    }
+}
+
+void EventFilterModel::sourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+    Q_UNUSED(first);
+    Q_UNUSED(last);
+
+    if (!_isFiltered)
+    {
+        endRemoveRows();
+
+        return;
+    }
+
+    if (_removeCount > 0)
+    {
+        _matches.erase(_matches.begin(), _matches.begin() + _removeCount);
+        _removeCount = 0;
+
+        endRemoveRows();
+    }
+}
+
+void EventFilterModel::sourceModelAboutToBeReset()
+{
+    beginResetModel();
+}
+
+void EventFilterModel::sourceModelReset()
+{
+    _searchIndex.clear();
+    _matches.clear();
+
+    for (int row = 0; row < _eventListModel->rowCount(); ++row)
+    {
+        const auto& eventRecord = _eventListModel->record(row);
+        _searchIndex.add(eventRecord);
+
+        if (_isFiltered && isMatch(eventRecord))
+        {
+            _matches.push_back(eventRecord.index);
+        }
+    }
+
+    endResetModel();
+}
+
+void EventFilterModel::sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    for (auto row = topLeft.row(); row <= bottomRight.row(); ++row)
+    {
+        const auto proxyIndex = mapFromSource(_eventListModel->index(row));
+        if (proxyIndex.isValid())
+        {
+            emit dataChanged(proxyIndex, proxyIndex, roles);
+        }
+    }
+}
+
+void EventFilterModel::sourceRecordAboutToBeChanged(int row)
+{
+    _changedRecord = _eventListModel->record(row);
+}
+
+void EventFilterModel::sourceRecordChanged(int row)
+{
+    const auto& eventRecord = _eventListModel->record(row);
+    _searchIndex.update(_changedRecord, eventRecord);
+
+    if (!_isFiltered)
+    {
+        return;
+    }
+
+    //изменившееся событие могло начать или перестать проходить фильтр
+    const auto it_matches = std::lower_bound(_matches.begin(), _matches.end(), eventRecord.index);
+    const auto isMatched = it_matches != _matches.end() && *it_matches == eventRecord.index;
+    if (isMatched == isMatch(eventRecord))
+    {
+        return;
+    }
+
+    const auto matchRow = static_cast<int>(std::distance(_matches.begin(), it_matches));
+    if (isMatched)
+    {
+        beginRemoveRows(QModelIndex(), matchRow, matchRow);
+        _matches.erase(it_matches);
+        endRemoveRows();
+    }
+    else
+    {
+        beginInsertRows(QModelIndex(), matchRow, matchRow);
+        _matches.insert(it_matches, eventRecord.index);
+        endInsertRows();
+    }
+}
+
+int EventFilterModel::sourceRow(int row) const
+{
+    if (!_isFiltered)
+    {
+        return row;
+    }
+
+    Q_ASSERT(row >= 0 && row < static_cast<int>(_matches.size()));
+
+    return _eventListModel->row(_matches[row]);
+}
+
+bool EventFilterModel::isMatch(const EventListModel::EventRecord &record) const
+{
+    if (!isFilterMatch(record))
+    {
+        return false;
+    }
+
+    if (!_isCollapseGroups || !record.isGroupMember() || _expandedGroups.contains(record.groupIndex))
+    {
+        return true;
+    }
+
+    //событие свернутой группы скрыто, только если видно первое событие группы. Если первое событие уже
+    //вытеснено, остальные события группы остаются скрытыми до своего вытеснения или следующего пересчета
+    const auto groupRow = _eventListModel->row(record.groupIndex);
+
+    return groupRow < 0 || !isFilterMatch(_eventListModel->record(groupRow));
+}
+
+bool EventFilterModel::isFilterMatch(const EventListModel::EventRecord &record) const
+{
+    if (!_filter.isEmpty() && !EventSearchIndex::match(_filter, record))
+    {
+        return false;
+    }
+
+    return _rules.match(record);
+}
+
+void EventFilterModel::updateMatches()
+{
+    _isFiltered = !_filter.isEmpty() || !_rules.isEmpty() || _isCollapseGroups;
+    _matches.clear();
+
+    if (!_isFiltered)
+    {
+        return;
+    }
+
+    //с фильтром кандидаты берутся из индексов, с одними правилами проверяются все события
+    if (!_filter.isEmpty())
+    {
+        for (const auto index: _searchIndex.candidates(_filter))
+        {
+            const auto row = _eventListModel->row(index);
+            if (row >= 0 && isMatch(_eventListModel->record(row)))
+            {
+                _matches.push_back(index);
+            }
+        }
+    }
+    else
+    {
+        for (int row = 0; row < _eventListModel->rowCount(); ++row)
+        {
+            const auto& eventRecord = _eventListModel->record(row);
+            if (isMatch(eventRecord))
+            {
+                _matches.push_back(eventRecord.index);
+            }
+        }
+    }
+}
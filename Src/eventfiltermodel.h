@@ -0,0 +1,114 @@
+#pragma once
+
+//STL
+#include <deque>
+#include <unordered_set>
+
+//Qt
+#include <QAbstractProxyModel>
+
+//My
+#include "eventlistmodel.h"
+#include "eventsearchindex.h"
+#include "detectrules.h"
+
+/*!
+    Фильтр списка событий. Без фильтра и правил строки модели совпадают со строками EventListModel.
+    С фильтром модель содержит только подходящие события детектирования: при установке фильтра кандидаты
+    выбираются из EventSearchIndex, новые события проверяются по мере поступления, вытесненные - удаляются.
+    Правила пользователя (DetectRules) скрывают события детектирования, не прошедшие фильтры и черный список.
+    При свернутых группах события группы детектирований на разных биржах, кроме первого, видны только
+    в раскрытых группах
+*/
+class EventFilterModel
+    : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    /*!
+        Конструктор
+        @param eventListModel - модель списка событий
+        @param parent - родительский объект
+    */
+    explicit EventFilterModel(EventListModel* eventListModel, QObject* parent = nullptr);
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+
+    /*!
+        Устанавливает фильтр. Пустой фильтр отключает фильтрацию
+        @param filter - фильтр
+    */
+    void setFilter(const EventSearchIndex::Filter& filter);
+    bool isFiltered() const noexcept;
+
+    /*!
+        Устанавливает правила фильтрации событий детектирования. Пустые правила пропускают все события
+        @param rules - правила
+    */
+    void setRules(const DetectRules& rules);
+
+    /*!
+        Включает сворачивание групп детектирований. Включается при появлении первой группы
+        @param isCollapseGroups - true - события группы, кроме первого, скрыты, пока группа не раскрыта
+    */
+    void setCollapseGroups(bool isCollapseGroups);
+    bool isCollapseGroups() const noexcept;
+
+    /*!
+        Раскрывает свернутую группу или сворачивает раскрытую
+        @param groupIndex - ИД первого события группы
+    */
+    void toggleGroup(quint64 groupIndex);
+
+    const EventListModel::EventRecord& record(int row) const;
+
+    /*!
+        @param index - ИД события
+        @return номер строки события или -1 если события нет в модели
+    */
+    int row(quint64 index) const;
+
+private slots:
+    void sourceRowsAboutToBeInserted(const QModelIndex& parent, int first, int last);
+    void sourceRowsInserted(const QModelIndex& parent, int first, int last);
+    void sourceRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+    void sourceRowsRemoved(const QModelIndex& parent, int first, int last);
+    void sourceModelAboutToBeReset();
+    void sourceModelReset();
+    void sourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles);
+    void sourceRecordAboutToBeChanged(int row);
+    void sourceRecordChanged(int row);
+
+private:
+    EventFilterModel() = delete;
+    Q_DISABLE_COPY_MOVE(EventFilterModel);
+
+    int sourceRow(int row) const;
+
+    bool isMatch(const EventListModel::EventRecord& record) const;
+    bool isFilterMatch(const EventListModel::EventRecord& record) const;
+    void updateMatches();
+
+private:
+    EventListModel* _eventListModel = nullptr;
+
+    EventSearchIndex _searchIndex;
+    EventSearchIndex::Filter _filter;
+    DetectRules _rules;
+    bool _isCollapseGroups = false;
+    bool _isFiltered = false;   ///< true - задан фильтр или правила или свернуты группы
+
+    std::unordered_set<quint64> _expandedGroups;  ///< ИД первых событий раскрытых групп
+
+    std::deque<quint64> _matches;   ///< ИД подходящих событий в порядке возрастания
+    EventListModel::EventRecord _changedRecord;  ///< событие до изменения на месте
+    qsizetype _removeCount = 0;     ///< количество строк, удаляемых вместе со строками исходной модели
+
+};
@@ -0,0 +1,67 @@
+//Qt
+#include <QPainter>
+#include <QFontMetrics>
+#include <QAbstractProxyModel>
+
+#include "eventlistmodel.h"
+#include "eventlistdelegate.h"
+
+constexpr static const int ICON_SIZE = 16;
+constexpr static const int MARGIN = 2;
+
+EventListDelegate::EventListDelegate(QObject* parent /* = nullptr */)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void EventListDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_CHECK_PTR(painter);
+
+    //строки могут отображаться через фильтрующую модель
+    auto sourceIndex = index;
+    const auto proxyModel = qobject_cast<const QAbstractProxyModel*>(index.model());
+    if (proxyModel != nullptr)
+    {
+        sourceIndex = proxyModel->mapToSource(index);
+    }
+
+    const auto model = qobject_cast<const EventListModel*>(sourceIndex.model());
+    if (model == nullptr)
+    {
+        QStyledItemDelegate::paint(painter, option, index);
+
+        return;
+    }
+
+    const auto& eventRecord = model->record(sourceIndex.row());
+
+    painter->save();
+
+    if (option.state.testFlag(QStyle::State_Selected))
+    {
+        painter->fillRect(option.rect, option.palette.highlight());
+    }
+
+    const QRect iconRect(option.rect.left() + MARGIN, option.rect.top() + (option.rect.height() - ICON_SIZE) / 2, ICON_SIZE, ICON_SIZE);
+    const auto& icon = model->icon(eventRecord);
+    if (!icon.isNull())
+    {
+        icon.paint(painter, iconRect);
+    }
+
+    const QRect textRect(iconRect.right() + MARGIN * 2, option.rect.top(), option.rect.right() - iconRect.right() - MARGIN * 2, option.rect.height());
+    painter->setFont(option.font);
+    painter->setPen(model->color(eventRecord));
+    painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine,
+                      option.fontMetrics.elidedText(model->text(eventRecord), Qt::ElideRight, textRect.width()));
+
+    painter->restore();
+}
+
+QSize EventListDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(index);
+
+    return QSize(option.rect.width(), std::max(option.fontMetrics.height(), ICON_SIZE) + MARGIN * 2);
+}
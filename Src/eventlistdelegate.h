@@ -0,0 +1,24 @@
+#pragma once
+
+//Qt
+#include <QStyledItemDelegate>
+
+/*!
+    Отрисовка строк EventListModel. Данные берутся напрямую из записей модели без преобразования в QVariant.
+    Все строки имеют одинаковую высоту
+*/
+class EventListDelegate
+    : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit EventListDelegate(QObject* parent = nullptr);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    Q_DISABLE_COPY_MOVE(EventListDelegate);
+
+};
@@ -7,6 +7,9 @@ EventListMenu::EMenuItemType EventListMenu::intToEMenuItemType(quint8 type)
     {
     case static_cast<quint8>(EMenuItemType::ADD_BLACK_LIST): return EMenuItemType::ADD_BLACK_LIST;
     case static_cast<quint8>(EMenuItemType::ADD_BLACK_LIST_ALL): return EMenuItemType::ADD_BLACK_LIST_ALL;
+    case static_cast<quint8>(EMenuItemType::TOGGLE_GROUP): return EMenuItemType::TOGGLE_GROUP;
+    case static_cast<quint8>(EMenuItemType::EXPORT_CSV): return EMenuItemType::EXPORT_CSV;
+    case static_cast<quint8>(EMenuItemType::EXPORT_COLUMNAR): return EMenuItemType::EXPORT_COLUMNAR;
     default:
         return EMenuItemType::UNDEFINED;
     }
@@ -38,6 +41,27 @@ EventListMenu::EventListMenu(QWidget *parent /* = nullptr */)
         ui->menuListWidget->addItem(addBlackListAllItem);
     }
 
+    {
+        _toggleGroupItem = new QListWidgetItem("Expand/collapse exchanges group");
+        _toggleGroupItem->setData(Qt::UserRole, static_cast<quint8>(EMenuItemType::TOGGLE_GROUP));
+
+        ui->menuListWidget->addItem(_toggleGroupItem);
+    }
+
+    {
+        auto exportCsvItem = new QListWidgetItem("Export all events to CSV");
+        exportCsvItem->setData(Qt::UserRole, static_cast<quint8>(EMenuItemType::EXPORT_CSV));
+
+        ui->menuListWidget->addItem(exportCsvItem);
+    }
+
+    {
+        auto exportColumnarItem = new QListWidgetItem("Export all events to columnar file");
+        exportColumnarItem->setData(Qt::UserRole, static_cast<quint8>(EMenuItemType::EXPORT_COLUMNAR));
+
+        ui->menuListWidget->addItem(exportColumnarItem);
+    }
+
     connect(ui->menuListWidget, SIGNAL(itemClicked(QListWidgetItem*)), SLOT(itemClickedMenuList(QListWidgetItem*)));
 }
 
@@ -46,10 +70,12 @@ EventListMenu::~EventListMenu()
     delete ui;
 }
 
-void EventListMenu::open(const QPoint &pos, quint64 index)
+void EventListMenu::open(const QPoint &pos, quint64 index, bool isGroup)
 {
     _currentIndex = index;
 
+    _toggleGroupItem->setHidden(!isGroup);
+
     move(pos);
     show();
 }
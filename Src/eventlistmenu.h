@@ -17,7 +17,10 @@ public:
     {
         UNDEFINED = 0,
         ADD_BLACK_LIST =1,
-        ADD_BLACK_LIST_ALL = 2
+        ADD_BLACK_LIST_ALL = 2,
+        TOGGLE_GROUP = 3,
+        EXPORT_CSV = 4,
+        EXPORT_COLUMNAR = 5
     };
 
     static EMenuItemType intToEMenuItemType(quint8 type);
@@ -26,7 +29,13 @@ public:
     explicit EventListMenu(QWidget *parent = nullptr);
     ~EventListMenu();
 
-    void open(const QPoint& pos, quint64 index);
+    /*!
+        Показывает меню для события
+        @param pos - положение меню
+        @param index - ИД события
+        @param isGroup - true - событие входит в группу, показывается пункт раскрытия группы
+    */
+    void open(const QPoint& pos, quint64 index, bool isGroup);
 
 signals:
     void clickedItem(EMenuItemType type, quint64 index);
@@ -37,6 +46,8 @@ private slots:
 private:
     Ui::EventListMenu *ui;
 
+    QListWidgetItem* _toggleGroupItem = nullptr;
+
     quint64 _currentIndex = 0;
 
 };
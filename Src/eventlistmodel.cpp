@@ -0,0 +1,420 @@
+//STL
+#include <algorithm>
+#include <array>
+#include <limits>
+
+//Qt
+#include <QDateTime>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPixmap>
+#include <QtMath>
+
+#include "eventlistmodel.h"
+
+constexpr static const quint8 MAX_STAR_LEVEL = 3;
+constexpr static const int EVENT_ICON_SIZE = 32;
+
+//static
+const QIcon& EventListModel::detectIcon(bool isIncrease, quint8 starLevel)
+{
+    static std::array<std::array<QIcon, MAX_STAR_LEVEL + 1>, 2> icons;
+
+    starLevel = std::min(starLevel, MAX_STAR_LEVEL);
+
+    auto& icon = icons[isIncrease ? 1 : 0][starLevel];
+    if (!icon.isNull())
+    {
+        return icon;
+    }
+
+    if (starLevel == 0)
+    {
+        icon = QIcon(isIncrease ? ":/image/img/increase.png" : ":/image/img/decrease.png");
+
+        return icon;
+    }
+
+    auto pixmap = QIcon(isIncrease ? ":/image/img/increase_star.png" : ":/image/img/decrease_star.png").pixmap(EVENT_ICON_SIZE, EVENT_ICON_SIZE);
+
+    //для уровней выше первого дорисовываем по звездочке на каждый дополнительный уровень
+    if (starLevel > 1)
+    {
+        const qreal starRadius = EVENT_ICON_SIZE / 6.0;
+
+        QPainterPath star;
+        for (int i = 0; i < 10; ++i)
+        {
+            const qreal radius = i % 2 == 0 ? starRadius : starRadius * 0.45;
+            const qreal angle = qDegreesToRadians(-90.0 + 36.0 * i);
+            const QPointF point(radius * qCos(angle), radius * qSin(angle));
+            if (i == 0)
+            {
+                star.moveTo(point);
+            }
+            else
+            {
+                star.lineTo(point);
+            }
+        }
+        star.closeSubpath();
+
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(QPen(QColor(36, 31, 49), 1.0));
+        painter.setBrush(QColor(255, 215, 0));
+        for (quint8 level = 1; level < starLevel; ++level)
+        {
+            painter.save();
+            painter.translate(EVENT_ICON_SIZE - starRadius * (2 * level - 1) - 1.0, EVENT_ICON_SIZE - starRadius - 1.0);
+            painter.drawPath(star);
+            painter.restore();
+        }
+    }
+
+    icon = QIcon(pixmap);
+
+    return icon;
+}
+
+//static
+void EventListModel::mergeBurst(EventRecord &eventRecord, const EventRecord &hit)
+{
+    Q_ASSERT(eventRecord.type == EEventType::DETECT && hit.type == EEventType::DETECT);
+    Q_ASSERT(eventRecord.stockExchangeId == hit.stockExchangeId && eventRecord.symbolId == hit.symbolId);
+
+    eventRecord.time = hit.time;
+    eventRecord.firstSeen = hit.firstSeen;
+    eventRecord.delta = hit.delta;
+    eventRecord.volume = hit.volume;
+    eventRecord.hits5min = hit.hits5min;
+    eventRecord.hits15min = hit.hits15min;
+    eventRecord.hits1hour = hit.hits1hour;
+    eventRecord.streak = hit.streak;
+    eventRecord.starLevel = hit.starLevel;
+    eventRecord.isIncrease = hit.isIncrease;
+    eventRecord.burstHits = static_cast<quint16>(std::min<quint32>(std::max<quint32>(eventRecord.burstHits, 1) + 1, std::numeric_limits<quint16>::max()));
+}
+
+//class
+EventListModel::EventListModel(qsizetype capacity, ExchangeRegistry& exchangeRegistry, QObject* parent /* = nullptr */)
+    : QAbstractListModel(parent)
+    , _exchangeRegistry(exchangeRegistry)
+    , _buffer(capacity)
+{
+    Q_ASSERT(capacity > 0);
+}
+
+int EventListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+
+    return static_cast<int>(_size);
+}
+
+QVariant EventListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= _size)
+    {
+        return QVariant();
+    }
+
+    const auto& eventRecord = at(index.row());
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return text(eventRecord);
+    case Qt::ForegroundRole:
+        return color(eventRecord);
+    case Qt::DecorationRole:
+        return icon(eventRecord);
+    case Qt::ToolTipRole:
+        if (eventRecord.type == EEventType::DETECT)
+        {
+            const auto toolTip = QString("Hits: %1 in 5 min, %2 in 15 min, %3 in 1 hour. Streak: %4 since %5")
+                .arg(eventRecord.hits5min)
+                .arg(eventRecord.hits15min)
+                .arg(eventRecord.hits1hour)
+                .arg(eventRecord.streak)
+                .arg(QDateTime::fromMSecsSinceEpoch(eventRecord.firstSeen).toString("hh:mm"));
+
+            QString hint;
+            if (eventRecord.burstHits > 1)
+            {
+                hint += QString("\n%1 detections in the row. Use Left/Right keys to step through them").arg(eventRecord.burstHits);
+            }
+            if (eventRecord.isGroupLeader())
+            {
+                hint += "\nUse the context menu to expand or collapse the group";
+            }
+
+            return toolTip + hint;
+        }
+        break;
+    case INDEX_ROLE:
+        if (eventRecord.type == EEventType::DETECT)
+        {
+            return eventRecord.index;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+Qt::ItemFlags EventListModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid() || index.row() >= _size)
+    {
+        return Qt::NoItemFlags;
+    }
+
+    return at(index.row()).type == EEventType::DETECT ? Qt::ItemIsEnabled | Qt::ItemIsSelectable : Qt::ItemIsEnabled;
+}
+
+std::vector<quint64> EventListModel::append(std::vector<EventRecord> &&records)
+{
+    std::vector<quint64> evicted;
+
+    if (records.empty())
+    {
+        return evicted;
+    }
+
+    const auto capacity = static_cast<qsizetype>(_buffer.size());
+
+    const auto forgetRecord =
+        [this, &evicted](const EventRecord& eventRecord)
+        {
+            if (eventRecord.type == EEventType::DETECT)
+            {
+                evicted.push_back(eventRecord.index);
+            }
+            else
+            {
+                _messages.remove(eventRecord.index);
+            }
+        };
+
+    //если новых записей больше чем емкость буфера - в список попадут только последние из них
+    auto it_begin = records.begin();
+    if (static_cast<qsizetype>(records.size()) > capacity)
+    {
+        const auto it_end = records.end() - capacity;
+        for (; it_begin != it_end; ++it_begin)
+        {
+            forgetRecord(*it_begin);
+        }
+    }
+
+    const auto count = static_cast<qsizetype>(std::distance(it_begin, records.end()));
+
+    const auto removeCount = std::max<qsizetype>(0, _size + count - capacity);
+    if (removeCount > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(removeCount - 1));
+
+        for (qsizetype row = 0; row < removeCount; ++row)
+        {
+            forgetRecord(at(row));
+        }
+
+        _first = (_first + removeCount) % capacity;
+        _size -= removeCount;
+
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), static_cast<int>(_size), static_cast<int>(_size + count - 1));
+
+    for (auto it_records = it_begin; it_records != records.end(); ++it_records)
+    {
+        Q_ASSERT(_size == 0 || it_records->index > at(_size - 1).index);
+
+        _buffer[(_first + _size) % capacity] = std::move(*it_records);
+        ++_size;
+    }
+
+    endInsertRows();
+
+    return evicted;
+}
+
+EventListModel::EventRecord EventListModel::makeMessage(EEventType type, const QString &text)
+{
+    Q_ASSERT(type != EEventType::DETECT);
+
+    EventRecord eventRecord;
+    eventRecord.index = nextIndex();
+    eventRecord.type = type;
+    eventRecord.time = QDateTime::currentMSecsSinceEpoch();
+
+    _messages.insert(eventRecord.index, text);
+
+    return eventRecord;
+}
+
+std::vector<quint64> EventListModel::appendMessage(EEventType type, const QString &text)
+{
+    std::vector<EventRecord> records;
+    records.push_back(makeMessage(type, text));
+
+    return append(std::move(records));
+}
+
+quint64 EventListModel::nextIndex() noexcept
+{
+    return ++_lastIndex;
+}
+
+const EventListModel::EventRecord &EventListModel::record(int row) const
+{
+    Q_ASSERT(row >= 0 && row < _size);
+
+    return at(row);
+}
+
+void EventListModel::setGroupSize(quint64 index, quint8 groupSize)
+{
+    const auto row = this->row(index);
+    if (row < 0)
+    {
+        return;
+    }
+
+    auto& eventRecord = at(row);
+    Q_ASSERT(eventRecord.type == EEventType::DETECT);
+
+    eventRecord.groupIndex = index;
+    eventRecord.groupSize = groupSize;
+
+    const auto modelIndex = this->index(row);
+    emit dataChanged(modelIndex, modelIndex, {Qt::DisplayRole, Qt::ToolTipRole});
+}
+
+bool EventListModel::mergeBurst(quint64 index, const EventRecord &hit)
+{
+    const auto row = this->row(index);
+    if (row < 0)
+    {
+        return false;
+    }
+
+    emit recordAboutToBeChanged(row);
+
+    mergeBurst(at(row), hit);
+
+    emit recordChanged(row);
+
+    const auto modelIndex = this->index(row);
+    emit dataChanged(modelIndex, modelIndex, {Qt::DisplayRole, Qt::DecorationRole, Qt::ToolTipRole});
+
+    return true;
+}
+
+int EventListModel::row(quint64 index) const
+{
+    //ИД событий возрастают от строки к строке, поэтому строку можно найти двоичным поиском
+    qsizetype low = 0;
+    qsizetype high = _size;
+    while (low < high)
+    {
+        const auto middle = low + (high - low) / 2;
+        if (at(middle).index < index)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low < _size && at(low).index == index ? static_cast<int>(low) : -1;
+}
+
+QString EventListModel::text(const EventRecord &eventRecord) const
+{
+    if (eventRecord.type != EEventType::DETECT)
+    {
+        return _messages.value(eventRecord.index);
+    }
+
+    //первое событие группы помечается количеством бирж, остальные события группы - отступом
+    QString prefix;
+    if (eventRecord.isGroupLeader())
+    {
+        prefix = QString("[%1 exchanges] ").arg(eventRecord.groupSize);
+    }
+    else if (eventRecord.isGroupMember())
+    {
+        prefix = "    ";
+    }
+
+    auto text = QString("%1%2->%3 Delta=%4 Volume=%5")
+        .arg(prefix)
+        .arg(_exchangeRegistry.info(eventRecord.stockExchangeId).displayName)
+        .arg(InternTable::instance().symbolName(eventRecord.symbolId))
+        .arg(eventRecord.delta)
+        .arg(eventRecord.volume);
+
+    //объединенная серия повторных детектирований помечается их количеством
+    if (eventRecord.burstHits > 1)
+    {
+        text += QString(" x%1").arg(eventRecord.burstHits);
+    }
+
+    return text;
+}
+
+QColor EventListModel::color(const EventRecord &eventRecord) const
+{
+    if (eventRecord.type != EEventType::DETECT)
+    {
+        return QColor(Qt::white);
+    }
+
+    return _exchangeRegistry.info(eventRecord.stockExchangeId).color;
+}
+
+const QIcon &EventListModel::icon(const EventRecord &eventRecord) const
+{
+    static const QIcon waitIcon(":/icon/img/slippers_cat_icon.ico");
+    static const QIcon successIcon(":/image/img/ok.png");
+    static const QIcon failIcon(":/icon/img/error.ico");
+    static const QIcon emptyIcon;
+
+    switch (eventRecord.type)
+    {
+    case EEventType::DETECT:
+        return detectIcon(eventRecord.isIncrease, eventRecord.starLevel);
+    case EEventType::WAIT:
+        return waitIcon;
+    case EEventType::SUCCESS:
+        return successIcon;
+    case EEventType::FAIL:
+        return failIcon;
+    case EEventType::NOTICE:
+        break;
+    default:
+        Q_ASSERT(false);
+    }
+
+    return emptyIcon;
+}
+
+const EventListModel::EventRecord &EventListModel::at(qsizetype row) const
+{
+    return _buffer[(_first + row) % static_cast<qsizetype>(_buffer.size())];
+}
+
+EventListModel::EventRecord &EventListModel::at(qsizetype row)
+{
+    return _buffer[(_first + row) % static_cast<qsizetype>(_buffer.size())];
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+//STL
+#include <vector>
+
+//Qt
+#include <QAbstractListModel>
+#include <QHash>
+#include <QIcon>
+#include <QColor>
+
+//My
+#include "interntable.h"
+#include "exchangeregistry.h"
+
+/*!
+    Модель списка событий поверх кольцевого буфера фиксированной емкости. Каждая строка - компактная запись без
+    строк и QVariant, текст и оформление строки формируются только при отрисовке видимых строк
+*/
+class EventListModel
+    : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int INDEX_ROLE = Qt::UserRole;  ///< ИД события детектирования или пустое значение для сообщения
+
+    enum class EEventType: quint8
+    {
+        DETECT = 0,  ///< детектирование свечи
+        WAIT = 1,    ///< ожидание данных
+        SUCCESS = 2, ///< успешное действие
+        FAIL = 3,    ///< ошибка
+        NOTICE = 4   ///< сообщение без иконки
+    };
+
+    struct EventRecord
+    {
+        quint64 index = 0;                  ///< ИД события. Возрастает от строки к строке
+        qint64 time = 0;                    ///< время закрытия свечи, мс
+        qint64 firstSeen = 0;               ///< начало серии повторных детектирований, мс
+        double delta = 0.0;
+        double volume = 0.0;
+        InternTable::ID stockExchangeId = 0;
+        InternTable::ID symbolId = 0;
+        quint64 groupIndex = 0;             ///< ИД первого события группы детектирований одной монеты на разных биржах. 0 - вне группы
+        quint16 hits5min = 0;
+        quint16 hits15min = 0;
+        quint16 hits1hour = 0;
+        quint16 streak = 0;
+        quint16 burstHits = 0;              ///< количество детектирований серии, объединенных в строку. 0 - одиночное детектирование
+        EEventType type = EEventType::DETECT;
+        quint8 starLevel = 0;
+        quint8 groupSize = 0;               ///< количество бирж группы. Только для первого события группы
+        bool isIncrease = true;
+
+        bool isGroupLeader() const noexcept { return groupIndex != 0 && groupIndex == index; }
+        bool isGroupMember() const noexcept { return groupIndex != 0 && groupIndex != index; }
+    };
+
+    /*!
+        Иконка события детектирования
+        @param isIncrease - true для растущей свечи
+        @param starLevel - уровень повторяемости детектирования (см. RepeatDetector::Result::starLevel())
+        @return иконка
+    */
+    static const QIcon& detectIcon(bool isIncrease, quint8 starLevel);
+
+    /*!
+        Объединяет повторное детектирование с событием серии: событие получает данные последнего детектирования,
+        ИД, группа, биржа и символ события сохраняются
+        @param eventRecord - событие серии
+        @param hit - повторное детектирование
+    */
+    static void mergeBurst(EventRecord& eventRecord, const EventRecord& hit);
+
+public:
+    EventListModel(qsizetype capacity, ExchangeRegistry& exchangeRegistry, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    /*!
+        Добавляет события в конец списка одной операцией вставки. Самые старые строки, не помещающиеся в буфер,
+        удаляются одной операцией удаления
+        @param records - события
+        @return ИД вытесненных событий детектирования
+    */
+    std::vector<quint64> append(std::vector<EventRecord>&& records);
+
+    /*!
+        Формирует запись сообщения для последующего добавления через append()
+        @param type - тип сообщения
+        @param text - текст сообщения
+        @return запись сообщения
+    */
+    EventRecord makeMessage(EEventType type, const QString& text);
+
+    /*!
+        Добавляет сообщение в конец списка
+        @param type - тип сообщения
+        @param text - текст сообщения
+        @return ИД вытесненных событий детектирования
+    */
+    std::vector<quint64> appendMessage(EEventType type, const QString& text);
+
+    /*!
+        @return ИД для следующего события
+    */
+    quint64 nextIndex() noexcept;
+
+    const EventRecord& record(int row) const;
+
+    /*!
+        Делает событие первым событием группы и обновляет количество бирж в группе
+        @param index - ИД события
+        @param groupSize - количество бирж в группе
+    */
+    void setGroupSize(quint64 index, quint8 groupSize);
+
+    /*!
+        Объединяет повторное детектирование с событием серии, уже добавленным в список (см. mergeBurst())
+        @param index - ИД события серии
+        @param hit - повторное детектирование
+        @return true - событие обновлено, false - событие уже вытеснено из буфера
+    */
+    bool mergeBurst(quint64 index, const EventRecord& hit);
+
+    /*!
+        @param index - ИД события
+        @return номер строки события или -1 если событие уже вытеснено из буфера
+    */
+    int row(quint64 index) const;
+
+    QString text(const EventRecord& eventRecord) const;
+    QColor color(const EventRecord& eventRecord) const;
+    const QIcon& icon(const EventRecord& eventRecord) const;
+
+signals:
+    /*!
+        Испускаются до и после изменения события на месте, чтобы зависимые индексы могли обновиться
+        по старым значениям события. После recordChanged() испускается dataChanged()
+        @param row - номер строки события
+    */
+    void recordAboutToBeChanged(int row);
+    void recordChanged(int row);
+
+private:
+    EventListModel() = delete;
+    Q_DISABLE_COPY_MOVE(EventListModel);
+
+    const EventRecord& at(qsizetype row) const;
+    EventRecord& at(qsizetype row);
+
+private:
+    ExchangeRegistry& _exchangeRegistry;
+
+    std::vector<EventRecord> _buffer;  ///< кольцевой буфер записей
+    qsizetype _first = 0;              ///< позиция первой строки в _buffer
+    qsizetype _size = 0;               ///< количество строк
+
+    QHash<quint64, QString> _messages; ///< тексты сообщений. Ключ - ИД события
+
+    quint64 _lastIndex = 0;
+
+};
@@ -0,0 +1,222 @@
+//STL
+#include <algorithm>
+
+#include "eventsearchindex.h"
+
+bool EventSearchIndex::Filter::isEmpty() const noexcept
+{
+    return symbol.isEmpty() && stockExchangeId == NO_STOCK_EXCHANGE
+        && minDelta == std::numeric_limits<double>::lowest() && maxDelta == std::numeric_limits<double>::max()
+        && minVolume == std::numeric_limits<double>::lowest() && maxVolume == std::numeric_limits<double>::max();
+}
+
+void EventSearchIndex::add(const EventListModel::EventRecord &record)
+{
+    if (record.type != EventListModel::EEventType::DETECT)
+    {
+        return;
+    }
+
+    _bySymbol[record.symbolId].push_back(record.index);
+    _byStockExchange[record.stockExchangeId].push_back(record.index);
+    _byDelta.emplace(record.delta, record.index);
+    _byVolume.emplace(record.volume, record.index);
+
+}
+
+void EventSearchIndex::remove(const EventListModel::EventRecord &record)
+{
+    if (record.type != EventListModel::EEventType::DETECT)
+    {
+        return;
+    }
+
+    const auto it_bySymbol = _bySymbol.find(record.symbolId);
+    if (it_bySymbol != _bySymbol.end())
+    {
+        eraseFront(it_bySymbol->second, record.index);
+        if (it_bySymbol->second.empty())
+        {
+            _bySymbol.erase(it_bySymbol);
+        }
+    }
+
+    const auto it_byStockExchange = _byStockExchange.find(record.stockExchangeId);
+    if (it_byStockExchange != _byStockExchange.end())
+    {
+        eraseFront(it_byStockExchange->second, record.index);
+        if (it_byStockExchange->second.empty())
+        {
+            _byStockExchange.erase(it_byStockExchange);
+        }
+    }
+
+    _byDelta.erase({record.delta, record.index});
+    _byVolume.erase({record.volume, record.index});
+
+}
+
+void EventSearchIndex::update(const EventListModel::EventRecord &oldRecord, const EventListModel::EventRecord &newRecord)
+{
+    if (newRecord.type != EventListModel::EEventType::DETECT)
+    {
+        return;
+    }
+
+    Q_ASSERT(oldRecord.index == newRecord.index);
+    Q_ASSERT(oldRecord.symbolId == newRecord.symbolId && oldRecord.stockExchangeId == newRecord.stockExchangeId);
+
+    if (oldRecord.delta != newRecord.delta)
+    {
+        _byDelta.erase({oldRecord.delta, oldRecord.index});
+        _byDelta.emplace(newRecord.delta, newRecord.index);
+    }
+
+    if (oldRecord.volume != newRecord.volume)
+    {
+        _byVolume.erase({oldRecord.volume, oldRecord.index});
+        _byVolume.emplace(newRecord.volume, newRecord.index);
+    }
+}
+
+void EventSearchIndex::clear()
+{
+    _bySymbol.clear();
+    _byStockExchange.clear();
+    _byDelta.clear();
+    _byVolume.clear();
+}
+
+std::vector<quint64> EventSearchIndex::candidates(const Filter &filter) const
+{
+    Q_ASSERT(!filter.isEmpty());
+
+    //пустой диапазон значений не пропускает ни одного события
+    if (filter.minDelta > filter.maxDelta || filter.minVolume > filter.maxVolume)
+    {
+        return {};
+    }
+
+    std::vector<const EventsList*> lists;
+    qsizetype listsSize = std::numeric_limits<qsizetype>::max();
+
+    //символы, содержащие подстроку. Просматриваются только символы, для которых есть события
+    if (!filter.symbol.isEmpty())
+    {
+        const auto& internTable = InternTable::instance();
+
+        listsSize = 0;
+        for (const auto& [symbolId, events]: _bySymbol)
+        {
+            if (internTable.symbolName(symbolId).contains(filter.symbol, Qt::CaseInsensitive))
+            {
+                lists.push_back(&events);
+                listsSize += static_cast<qsizetype>(events.size());
+            }
+        }
+    }
+
+    if (filter.stockExchangeId != NO_STOCK_EXCHANGE)
+    {
+        const auto it_byStockExchange = _byStockExchange.find(filter.stockExchangeId);
+        const auto stockExchangeSize = it_byStockExchange != _byStockExchange.end() ? static_cast<qsizetype>(it_byStockExchange->second.size()) : 0;
+        if (stockExchangeSize < listsSize)
+        {
+            lists.clear();
+            if (it_byStockExchange != _byStockExchange.end())
+            {
+                lists.push_back(&it_byStockExchange->second);
+            }
+            listsSize = stockExchangeSize;
+        }
+    }
+
+    if (listsSize != std::numeric_limits<qsizetype>::max())
+    {
+        std::vector<quint64> result;
+        result.reserve(listsSize);
+        for (const auto events: lists)
+        {
+            result.insert(result.end(), events->begin(), events->end());
+        }
+
+        if (lists.size() > 1)
+        {
+            std::sort(result.begin(), result.end());
+        }
+
+        return result;
+    }
+
+    //остались только ограничения по значениям
+    if (filter.minDelta != std::numeric_limits<double>::lowest() || filter.maxDelta != std::numeric_limits<double>::max())
+    {
+        return rangeCandidates(_byDelta, filter.minDelta, filter.maxDelta);
+    }
+
+    return rangeCandidates(_byVolume, filter.minVolume, filter.maxVolume);
+}
+
+bool EventSearchIndex::match(const Filter &filter, const EventListModel::EventRecord &record)
+{
+    if (record.type != EventListModel::EEventType::DETECT)
+    {
+        return false;
+    }
+
+    if (filter.stockExchangeId != NO_STOCK_EXCHANGE && record.stockExchangeId != filter.stockExchangeId)
+    {
+        return false;
+    }
+
+    if (record.delta < filter.minDelta || record.delta > filter.maxDelta || record.volume < filter.minVolume || record.volume > filter.maxVolume)
+    {
+        return false;
+    }
+
+    if (!filter.symbol.isEmpty() && !InternTable::instance().symbolName(record.symbolId).contains(filter.symbol, Qt::CaseInsensitive))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void EventSearchIndex::eraseFront(EventsList &events, quint64 index)
+{
+    //вытесняются самые старые события, поэтому удаляемый ИД почти всегда в начале списка
+    if (!events.empty() && events.front() == index)
+    {
+        events.pop_front();
+
+        return;
+    }
+
+    const auto it_events = std::lower_bound(events.begin(), events.end(), index);
+    if (it_events != events.end() && *it_events == index)
+    {
+        events.erase(it_events);
+    }
+}
+
+std::vector<quint64> EventSearchIndex::rangeCandidates(const ValueIndex &valueIndex, double min, double max)
+{
+    std::vector<quint64> result;
+
+    //при min > max начало диапазона оказывается за его концом
+    if (min > max)
+    {
+        return result;
+    }
+
+    const auto it_begin = valueIndex.lower_bound({min, 0});
+    const auto it_end = valueIndex.upper_bound({max, std::numeric_limits<quint64>::max()});
+    for (auto it = it_begin; it != it_end; ++it)
+    {
+        result.push_back(it->second);
+    }
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+//STL
+#include <deque>
+#include <set>
+#include <vector>
+#include <limits>
+#include <unordered_map>
+
+//Qt
+#include <QString>
+
+//My
+#include "interntable.h"
+#include "eventlistmodel.h"
+
+/*!
+    Инкрементальные индексы событий детектирования для фильтрации списка событий: по символу, по бирже и
+    упорядоченные по дельте и объему. Индексы обновляются при добавлении и вытеснении событий, поэтому
+    запрос выбирает кандидатов из самого избирательного индекса без просмотра всего списка
+*/
+class EventSearchIndex
+{
+public:
+    static constexpr InternTable::ID NO_STOCK_EXCHANGE = std::numeric_limits<InternTable::ID>::max();
+
+    struct Filter
+    {
+        QString symbol;                                   ///< подстрока имени символа без учета регистра. Пусто - любой символ
+        InternTable::ID stockExchangeId = NO_STOCK_EXCHANGE; ///< ИД биржи. NO_STOCK_EXCHANGE - любая биржа
+        double minDelta = std::numeric_limits<double>::lowest();
+        double maxDelta = std::numeric_limits<double>::max();
+        double minVolume = std::numeric_limits<double>::lowest();
+        double maxVolume = std::numeric_limits<double>::max();
+
+        bool isEmpty() const noexcept;
+    };
+
+public:
+    EventSearchIndex() = default;
+
+    /*!
+        Добавляет событие в индексы. События должны добавляться в порядке возрастания ИД
+        @param record - событие. Сообщения игнорируются
+    */
+    void add(const EventListModel::EventRecord& record);
+
+    /*!
+        Удаляет событие из индексов. Удаляться могут только самые старые события
+        @param record - событие. Сообщения игнорируются
+    */
+    void remove(const EventListModel::EventRecord& record);
+
+    /*!
+        Обновляет индексы по дельте и объему при изменении события на месте. Символ и биржа события не меняются
+        @param oldRecord - событие до изменения
+        @param newRecord - событие после изменения
+    */
+    void update(const EventListModel::EventRecord& oldRecord, const EventListModel::EventRecord& newRecord);
+
+    void clear();
+
+    /*!
+        Выбирает кандидатов для фильтра из самого избирательного индекса. Кандидатов необходимо проверить match()
+        @param filter - фильтр. Не должен быть пустым
+        @return ИД событий в порядке возрастания
+    */
+    std::vector<quint64> candidates(const Filter& filter) const;
+
+    /*!
+        @param filter - фильтр
+        @param record - событие
+        @return true - событие удовлетворяет фильтру
+    */
+    static bool match(const Filter& filter, const EventListModel::EventRecord& record);
+
+private:
+    Q_DISABLE_COPY_MOVE(EventSearchIndex);
+
+    using EventsList = std::deque<quint64>;              ///< ИД событий в порядке возрастания
+    using ValueIndex = std::set<std::pair<double, quint64>>;
+
+    static void eraseFront(EventsList& events, quint64 index);
+    static std::vector<quint64> rangeCandidates(const ValueIndex& valueIndex, double min, double max);
+
+private:
+    std::unordered_map<InternTable::ID, EventsList> _bySymbol;
+    std::unordered_map<InternTable::ID, EventsList> _byStockExchange;
+    ValueIndex _byDelta;
+    ValueIndex _byVolume;
+
+};
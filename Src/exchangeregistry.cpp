@@ -0,0 +1,131 @@
+//STL
+#include <algorithm>
+
+//Qt
+#include <QFile>
+#include <QHash>
+
+#include "exchangeregistry.h"
+
+using namespace TradingCatCommon;
+
+Q_GLOBAL_STATIC_WITH_ARGS(const QString, FUTURES_SUFFIX, ("_FUTURES"));
+Q_GLOBAL_STATIC_WITH_ARGS(const QString, ICON_PATH, (":/image/img/%1.png"));
+Q_GLOBAL_STATIC_WITH_ARGS(const QString, DEFAULT_ICON_PATH, (":/image/img/info.png"));
+
+using ColorsList = QHash<QString, QColor>;
+
+Q_GLOBAL_STATIC_WITH_ARGS(const ColorsList, KNOWN_COLORS, ({
+    //Spot
+    {"MEXC", QColor(Qt::yellow)},            //желтый
+    {"KUCOIN", QColor(246, 97, 81)},         //красный
+    {"GATE", QColor(153, 193, 241)},         //голубой
+    {"BYBIT", QColor(97, 53, 131)},          //фиолетовый
+    {"BITMART", QColor(47, 93, 200)},        //синий
+    {"BINANCE", QColor(46, 194, 126)},       //светло зеленый
+    {"BITGET", QColor(200, 200, 200)},       //серый
+    {"BINGX", QColor(220, 138, 221)},        //розовый
+    {"OKX", QColor(255, 163, 72)},           //оранжевый
+    {"HTX", QColor(5, 55, 155)},             //синий
+    {"LBANK", QColor(0, 200, 0)},            //зеленый
+    //Futures
+    {"KUCOIN_FUTURES", QColor(246, 127, 110)},  //красный
+    {"BITGET_FUTURES", QColor(200, 230, 230)},  //серый
+    {"GATE_FUTURES", QColor(153, 223, 255)},    //голубой
+    {"BYBIT_FUTURES", QColor(97, 83, 161)},     //фиолетовый
+    {"MEXC_FUTURES", QColor(Qt::darkYellow)},   //желтый
+    {"BINGX_FUTURES", QColor(200, 108, 201)},   //розовый
+    {"BITMART_FUTURES", QColor(67, 113, 220)}   //синий
+}));
+
+void ExchangeRegistry::update(const TradingCatCommon::StockExchangesIDList &stockExchangesIdList)
+{
+    auto& internTable = InternTable::instance();
+
+    _available.clear();
+    for (const auto& stockExchangeId: stockExchangesIdList)
+    {
+        const auto id = internTable.stockExchange(stockExchangeId);
+        info(id);
+
+        _available.push_back(id);
+    }
+
+    std::sort(_available.begin(), _available.end(),
+              [&internTable](InternTable::ID left, InternTable::ID right)
+              {
+                  return internTable.stockExchangeName(left) < internTable.stockExchangeName(right);
+              });
+}
+
+void ExchangeRegistry::clear()
+{
+    _available.clear();
+}
+
+const ExchangeRegistry::ExchangeInfo &ExchangeRegistry::info(InternTable::ID id)
+{
+    if (id >= _info.size())
+    {
+        _info.resize(id + 1);
+        _isInfoExists.resize(id + 1, false);
+    }
+
+    if (!_isInfoExists[id])
+    {
+        _info[id] = makeInfo(id);
+        _isInfoExists[id] = true;
+    }
+
+    return _info[id];
+}
+
+const std::vector<InternTable::ID> &ExchangeRegistry::available() const noexcept
+{
+    return _available;
+}
+
+ExchangeRegistry::ExchangeInfo ExchangeRegistry::makeInfo(InternTable::ID id)
+{
+    ExchangeInfo result;
+    result.id = id;
+    result.name = InternTable::instance().stockExchangeName(id);
+    result.isFutures = result.name.endsWith(*FUTURES_SUFFIX);
+
+    const auto spotName = result.isFutures ? result.name.chopped(FUTURES_SUFFIX->size()) : result.name;
+
+    result.displayName = result.isFutures ? QString("%1 Futures").arg(spotName) : result.name;
+
+    //Color
+    const auto it_knownColors = KNOWN_COLORS->constFind(result.name);
+    if (it_knownColors != KNOWN_COLORS->constEnd())
+    {
+        result.color = it_knownColors.value();
+    }
+    else
+    {
+        //для новой биржи берем цвет спотового рынка, либо формируем постоянный цвет по имени
+        const auto it_knownSpotColors = KNOWN_COLORS->constFind(spotName);
+        const auto spotColor = it_knownSpotColors != KNOWN_COLORS->constEnd()
+                                   ? it_knownSpotColors.value()
+                                   : QColor::fromHsv(static_cast<int>(qHash(spotName) % 360), 120, 230);
+
+        result.color = result.isFutures ? spotColor.lighter(115) : spotColor;
+    }
+
+    //Icon
+    if (QFile::exists(ICON_PATH->arg(result.name)))
+    {
+        result.icon = QIcon(ICON_PATH->arg(result.name));
+    }
+    else if (QFile::exists(ICON_PATH->arg(spotName)))
+    {
+        result.icon = QIcon(ICON_PATH->arg(spotName));
+    }
+    else
+    {
+        result.icon = QIcon(*DEFAULT_ICON_PATH);
+    }
+
+    return result;
+}
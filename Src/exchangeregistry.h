@@ -0,0 +1,69 @@
+#pragma once
+
+//STL
+#include <vector>
+
+//Qt
+#include <QString>
+#include <QColor>
+#include <QIcon>
+
+//My
+#include <TradingCatCommon/stockexchange.h>
+
+#include "interntable.h"
+
+/*!
+    Справочник бирж: цвет, иконка, отображаемое имя и тип рынка (спот/фьючерсы).
+    Заполняется один раз при получении списка бирж от сервера. Для неизвестных клиенту бирж
+    метаданные выводятся из имени, поэтому добавление биржи на сервере не требует изменения клиента
+*/
+class ExchangeRegistry
+{
+public:
+    struct ExchangeInfo
+    {
+        InternTable::ID id = 0;
+        QString name;           ///< имя биржи как его передает сервер
+        QString displayName;    ///< имя для отображения пользователю
+        QColor color;           ///< цвет событий биржи в списке событий
+        QIcon icon;             ///< иконка биржи
+        bool isFutures = false; ///< true - фьючерсный рынок, false - спот
+    };
+
+public:
+    ExchangeRegistry() = default;
+
+    /*!
+        Обновляет справочник по списку бирж от сервера
+        @param stockExchangesIdList - список бирж
+    */
+    void update(const TradingCatCommon::StockExchangesIDList& stockExchangesIdList);
+
+    /*!
+        Очищает список доступных бирж. Метаданные уже известных бирж сохраняются
+    */
+    void clear();
+
+    /*!
+        @param id - ИД биржи в InternTable
+        @return метаданные биржи. Если биржа встречается впервые - метаданные формируются по ее имени
+    */
+    const ExchangeInfo& info(InternTable::ID id);
+
+    /*!
+        @return ИД бирж, полученных от сервера, отсортированные по имени
+    */
+    const std::vector<InternTable::ID>& available() const noexcept;
+
+private:
+    Q_DISABLE_COPY_MOVE(ExchangeRegistry);
+
+    static ExchangeInfo makeInfo(InternTable::ID id);
+
+private:
+    std::vector<ExchangeInfo> _info;           ///< метаданные бирж. Индекс - ИД биржи в InternTable
+    std::vector<bool> _isInfoExists;           ///< признак заполненности _info
+    std::vector<InternTable::ID> _available;   ///< биржи, доступные на сервере
+
+};
@@ -0,0 +1,128 @@
+//Qt
+#include <QApplication>
+#include <QFont>
+#include <QFontDatabase>
+#include <QNetworkRequest>
+#include <QUrl>
+#include <QDebug>
+
+//EM
+#include <emscripten/val.h>
+
+//My
+#include "profiler.h"
+
+#include "fontloader.h"
+
+using namespace emscripten;
+
+constexpr static const char* CJK_FONT_PATH = "font/NotoSansCJK-Regular.ttc";  ///< путь к файлу шрифта относительно страницы приложения
+constexpr static const char* LATIN_FONT_PATH = ":/font/font/Lato-Regular.ttf";
+constexpr static const char* CJK_FONT_FAMILY = "Noto Sans CJK SC";
+constexpr static const char16_t LAST_LATIN_CHAR = u'\u024F';                 ///< последний символ блока Latin Extended-B
+
+//static
+bool FontLoader::isNonLatin(const QString &text) noexcept
+{
+    for (const auto ch: text)
+    {
+        if (ch.unicode() > LAST_LATIN_CHAR)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void FontLoader::loadLatin()
+{
+    const auto fontId = QFontDatabase::addApplicationFont(LATIN_FONT_PATH);
+    const auto families = fontId != -1 ? QFontDatabase::applicationFontFamilies(fontId) : QStringList();
+    if (families.isEmpty())
+    {
+        qWarning() << "The font is not load. Use font for default system" << QApplication::font().family();
+
+        return;
+    }
+
+    QApplication::setFont(QFont(families.front()));
+
+    qInfo() << "Font:" << families.front();
+}
+
+FontLoader::FontLoader(QObject* parent /* = nullptr */)
+    : QObject{parent}
+{
+}
+
+void FontLoader::load()
+{
+    if (_state != EState::NOT_LOADED)
+    {
+        return;
+    }
+
+    _state = EState::LOADING;
+
+    Profiler::instance().mark("cjkFontRequested");
+
+    const QUrl pageUrl(QString::fromStdString(val::global("location")["href"].as<std::string>()));
+    const auto url = pageUrl.resolved(QUrl(CJK_FONT_PATH));
+
+    _manager = new QNetworkAccessManager(this);
+    _reply = _manager->get(QNetworkRequest(url));
+
+    QObject::connect(_reply, SIGNAL(finished()), SLOT(finishedReply()));
+}
+
+bool FontLoader::isLoaded() const noexcept
+{
+    return _state == EState::LOADED;
+}
+
+void FontLoader::finishedReply()
+{
+    Q_CHECK_PTR(_reply);
+
+    if (_reply->error() == QNetworkReply::NoError)
+    {
+        apply(_reply->readAll());
+    }
+    else
+    {
+        _state = EState::FAILED;
+
+        qWarning() << "The font is not load. Use font for default system" << QApplication::font().family() << "Error:" << _reply->errorString();
+    }
+
+    _reply->deleteLater();
+    _reply = nullptr;
+
+    _manager->deleteLater();
+    _manager = nullptr;
+}
+
+void FontLoader::apply(const QByteArray &fontData)
+{
+    const auto fontId = QFontDatabase::addApplicationFontFromData(fontData);
+    if (fontId == -1)
+    {
+        _state = EState::FAILED;
+
+        qWarning() << "The font is not load. Use font for default system" << QApplication::font().family();
+
+        return;
+    }
+
+    _state = EState::LOADED;
+
+    //латинские символы продолжают отображаться текущим шрифтом, остальные - загруженным
+    auto font = QApplication::font();
+    font.setFamilies({font.family(), CJK_FONT_FAMILY});
+    QApplication::setFont(font);
+
+    Profiler::instance().mark("cjkFontLoaded");
+
+    qInfo() << "Font:" << CJK_FONT_FAMILY << "loaded as fallback";
+}
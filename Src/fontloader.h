@@ -0,0 +1,63 @@
+#pragma once
+
+//Qt
+#include <QObject>
+#include <QString>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+/*!
+    Отложенная загрузка шрифта с CJK символами. Файл шрифта очень большой, поэтому он не входит в ресурсы
+    приложения, копируется при сборке в каталог font рядом со страницей приложения и загружается с сервера
+    только когда в данных впервые встречаются не латинские имена. До загрузки используется небольшой
+    латинский шрифт из ресурсов. После загрузки шрифт подключается как резервный к текущему шрифту приложения
+*/
+class FontLoader
+    : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FontLoader(QObject* parent = nullptr);
+
+    /*!
+        @param text - проверяемый текст
+        @return true - текст содержит символы, которых нет в латинском шрифте
+    */
+    static bool isNonLatin(const QString& text) noexcept;
+
+    /*!
+        Устанавливает латинский шрифт из ресурсов шрифтом приложения. Вызывается до создания окон
+    */
+    static void loadLatin();
+
+    /*!
+        Запускает загрузку шрифта. Повторные вызовы игнорируются
+    */
+    void load();
+
+    bool isLoaded() const noexcept;
+
+private slots:
+    void finishedReply();
+
+private:
+    Q_DISABLE_COPY_MOVE(FontLoader);
+
+    enum class EState: quint8
+    {
+        NOT_LOADED = 0,
+        LOADING,
+        LOADED,
+        FAILED
+    };
+
+    void apply(const QByteArray& fontData);
+
+private:
+    EState _state = EState::NOT_LOADED;
+
+    QNetworkAccessManager* _manager = nullptr;
+    QNetworkReply* _reply = nullptr;
+
+};
@@ -0,0 +1,214 @@
+//STL
+#include <algorithm>
+#include <cmath>
+
+//Qt
+#include <QHashFunctions>
+
+#include "indicatorengine.h"
+
+void IndicatorBuffer::fill(KLineBuffer &klines) const
+{
+    const auto it_time = std::lower_bound(time.begin(), time.end(), klines.time.empty() ? 0 : klines.time.front());
+    const auto first = std::distance(time.begin(), it_time);
+    if (klines.isEmpty() || first + klines.size() > size() || time[first] != klines.time.front())
+    {
+        Q_ASSERT(false);
+
+        return;
+    }
+
+    const auto last = first + klines.size();
+    klines.ema.assign(ema.begin() + first, ema.begin() + last);
+    klines.vwap.assign(vwap.begin() + first, vwap.begin() + last);
+    klines.rsi.assign(rsi.begin() + first, rsi.begin() + last);
+    klines.atr.assign(atr.begin() + first, atr.begin() + last);
+}
+
+IndicatorEngine::IndicatorEngine(qsizetype capacity)
+    : _capacity(capacity)
+{
+    Q_ASSERT(_capacity > 0);
+}
+
+PIndicatorBuffer IndicatorEngine::compute(InternTable::ID stockExchangeId, InternTable::ID symbolId, const KLineBuffer &klines)
+{
+    const Key key{stockExchangeId, symbolId, klines.duration};
+
+    auto result = std::make_shared<IndicatorBuffer>();
+
+    qsizetype first = 0;
+    const auto it_index = _index.find(key);
+    if (it_index != _index.end())
+    {
+        const auto it_entries = it_index->second;
+        first = copyOverlap(*it_entries->second, klines, *result);
+
+        _index.erase(it_index);
+        _entries.erase(it_entries);
+    }
+
+    computeFrom(klines, first, *result);
+
+    _entries.emplace_front(key, result);
+    _index.emplace(key, _entries.begin());
+
+    if (static_cast<qsizetype>(_entries.size()) > _capacity)
+    {
+        _index.erase(_entries.back().first);
+        _entries.pop_back();
+    }
+
+    return result;
+}
+
+void IndicatorEngine::clear()
+{
+    _index.clear();
+    _entries.clear();
+}
+
+qsizetype IndicatorEngine::copyOverlap(const IndicatorBuffer &previous, const KLineBuffer &klines, IndicatorBuffer &result)
+{
+    if (klines.isEmpty() || previous.size() == 0)
+    {
+        return 0;
+    }
+
+    //ряд продолжается, только если свечи начинаются внутри предыдущего ряда и совпадают с ним до его конца
+    const auto it_time = std::lower_bound(previous.time.begin(), previous.time.end(), klines.time.front());
+    if (it_time == previous.time.end() || *it_time != klines.time.front())
+    {
+        return 0;
+    }
+
+    const auto offset = std::distance(previous.time.begin(), it_time);
+    const auto count = std::min(previous.size() - offset, klines.size());
+    if (!std::equal(klines.time.begin(), klines.time.begin() + count, it_time))
+    {
+        return 0;
+    }
+
+    const auto copy = [offset, count](const std::vector<float>& from, std::vector<float>& to)
+    {
+        to.assign(from.begin() + offset, from.begin() + offset + count);
+    };
+
+    result.time.assign(it_time, it_time + count);
+    copy(previous.ema, result.ema);
+    copy(previous.vwap, result.vwap);
+    copy(previous.rsi, result.rsi);
+    copy(previous.atr, result.atr);
+    copy(previous.averageGain, result.averageGain);
+    copy(previous.averageLoss, result.averageLoss);
+
+    //последняя совпадающая свеча могла быть еще не закрыта (или быть неполной свечей укрупненного интервала)
+    //и с тем же временем получить новые цены и объем, поэтому она всегда пересчитывается
+    return count - 1;
+}
+
+void IndicatorEngine::computeFrom(const KLineBuffer &klines, qsizetype first, IndicatorBuffer &result)
+{
+    const auto count = klines.size();
+    Q_ASSERT(first >= 0 && first <= count);
+
+    if (first == count)
+    {
+        return;
+    }
+
+    result.time.resize(count);
+    result.ema.resize(count);
+    result.vwap.resize(count);
+    result.rsi.resize(count);
+    result.atr.resize(count);
+    result.averageGain.resize(count);
+    result.averageLoss.resize(count);
+
+    std::copy(klines.time.begin() + first, klines.time.end(), result.time.begin() + first);
+
+    //типичная цена и ее произведение на объем не зависят от соседних свечей и считаются отдельным проходом,
+    //включая окно VWAP перед first
+    const auto windowFirst = std::max<qsizetype>(0, first - VWAP_PERIOD + 1);
+    std::vector<double> typical(count - windowFirst);
+    std::vector<double> priceVolume(count - windowFirst);
+    for (qsizetype index = windowFirst; index < count; ++index)
+    {
+        const auto value = (static_cast<double>(klines.high[index]) + klines.low[index] + klines.close[index]) / 3.0;
+        typical[index - windowFirst] = value;
+        priceVolume[index - windowFirst] = value * klines.volume[index];
+    }
+
+    //VWAP: скользящие суммы по окну VWAP_PERIOD
+    double sumPriceVolume = 0.0;
+    double sumVolume = 0.0;
+    for (qsizetype index = windowFirst; index < first; ++index)
+    {
+        sumPriceVolume += priceVolume[index - windowFirst];
+        sumVolume += klines.volume[index];
+    }
+
+    for (qsizetype index = first; index < count; ++index)
+    {
+        sumPriceVolume += priceVolume[index - windowFirst];
+        sumVolume += klines.volume[index];
+
+        const auto expired = index - VWAP_PERIOD;
+        if (expired >= windowFirst)
+        {
+            sumPriceVolume -= priceVolume[expired - windowFirst];
+            sumVolume -= klines.volume[expired];
+        }
+
+        result.vwap[index] = static_cast<float>(sumVolume > 0.0 ? sumPriceVolume / sumVolume : typical[index - windowFirst]);
+    }
+
+    //EMA, RSI и ATR - рекуррентные, продолжаются от значений в позиции first - 1
+    constexpr double emaAlpha = 2.0 / static_cast<double>(EMA_PERIOD + 1);
+    constexpr double rsiAlpha = 1.0 / static_cast<double>(RSI_PERIOD);
+    constexpr double atrAlpha = 1.0 / static_cast<double>(ATR_PERIOD);
+
+    for (qsizetype index = first; index < count; ++index)
+    {
+        const double close = klines.close[index];
+        const double high = klines.high[index];
+        const double low = klines.low[index];
+
+        if (index == 0)
+        {
+            result.ema[index] = klines.close[index];
+            result.averageGain[index] = 0.0f;
+            result.averageLoss[index] = 0.0f;
+            result.rsi[index] = 50.0f;
+            result.atr[index] = static_cast<float>(high - low);
+
+            continue;
+        }
+
+        const double previousClose = klines.close[index - 1];
+
+        result.ema[index] = static_cast<float>(result.ema[index - 1] + emaAlpha * (close - result.ema[index - 1]));
+
+        const auto change = close - previousClose;
+        const auto averageGain = result.averageGain[index - 1] + rsiAlpha * (std::max(change, 0.0) - result.averageGain[index - 1]);
+        const auto averageLoss = result.averageLoss[index - 1] + rsiAlpha * (std::max(-change, 0.0) - result.averageLoss[index - 1]);
+        result.averageGain[index] = static_cast<float>(averageGain);
+        result.averageLoss[index] = static_cast<float>(averageLoss);
+        if (averageLoss > 0.0)
+        {
+            result.rsi[index] = static_cast<float>(100.0 - 100.0 / (1.0 + averageGain / averageLoss));
+        }
+        else
+        {
+            result.rsi[index] = averageGain > 0.0 ? 100.0f : 50.0f;
+        }
+
+        const auto trueRange = std::max({high - low, std::abs(high - previousClose), std::abs(low - previousClose)});
+        result.atr[index] = static_cast<float>(result.atr[index - 1] + atrAlpha * (trueRange - result.atr[index - 1]));
+    }
+}
+
+size_t IndicatorEngine::KeyHash::operator()(const Key &key) const noexcept
+{
+    return qHashMulti(0, key.stockExchangeId, key.symbolId, key.duration);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+//STL
+#include <list>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+//Qt
+#include <QtGlobal>
+
+//My
+#include "interntable.h"
+#include "klinebuffer.h"
+
+/*!
+    Значения технических индикаторов для непрерывного ряда свечей. Индекс 0 - самая старая свеча
+*/
+struct IndicatorBuffer
+{
+    std::vector<qint64> time;        ///< время закрытия свечи, мс
+    std::vector<float> ema;          ///< экспоненциальная скользящая средняя цены закрытия
+    std::vector<float> vwap;         ///< скользящая средневзвешенная по объему типичная цена
+    std::vector<float> rsi;          ///< индекс относительной силы, 0..100
+    std::vector<float> atr;          ///< средний истинный диапазон
+    std::vector<float> averageGain;  ///< сглаженный средний рост цены закрытия. Состояние RSI для продолжения ряда
+    std::vector<float> averageLoss;  ///< сглаженное среднее падение цены закрытия. Состояние RSI для продолжения ряда
+
+    qsizetype size() const noexcept { return static_cast<qsizetype>(time.size()); }
+
+    /*!
+        Копирует значения индикаторов в буфер свечей по совпадающему времени
+        @param klines - буфер свечей. Его свечи должны быть непрерывной частью ряда индикаторов
+    */
+    void fill(KLineBuffer& klines) const;
+};
+
+using PIndicatorBuffer = std::shared_ptr<const IndicatorBuffer>;
+
+/*!
+    Расчет индикаторов EMA, VWAP, RSI и ATR по истории свечей. Последний рассчитанный ряд хранится по бирже,
+    символу и интервалу свечей. История нового детектирования того же символа почти полностью совпадает
+    с предыдущей, поэтому совпадающая часть копируется, а рассчитываются только новые свечи
+*/
+class IndicatorEngine
+{
+public:
+    static constexpr qsizetype EMA_PERIOD = 20;
+    static constexpr qsizetype VWAP_PERIOD = 20;
+    static constexpr qsizetype RSI_PERIOD = 14;
+    static constexpr qsizetype ATR_PERIOD = 14;
+
+public:
+    /*!
+        Конструктор
+        @param capacity - максимальное количество хранимых рядов
+    */
+    explicit IndicatorEngine(qsizetype capacity);
+
+    /*!
+        Рассчитывает индикаторы, продолжая ранее рассчитанный ряд того же символа, если он совпадает с началом свечей
+        @param stockExchangeId - ИД биржи
+        @param symbolId - ИД символа
+        @param klines - свечи
+        @return значения индикаторов для всех свечей klines
+    */
+    PIndicatorBuffer compute(InternTable::ID stockExchangeId, InternTable::ID symbolId, const KLineBuffer& klines);
+
+    void clear();
+
+private:
+    IndicatorEngine() = delete;
+    Q_DISABLE_COPY_MOVE(IndicatorEngine);
+
+    struct Key
+    {
+        InternTable::ID stockExchangeId = 0;
+        InternTable::ID symbolId = 0;
+        qint64 duration = 0;
+
+        bool operator==(const Key& other) const noexcept = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const noexcept;
+    };
+
+    using Entry = std::pair<Key, PIndicatorBuffer>;
+
+    /*!
+        @param previous - ранее рассчитанный ряд
+        @param klines - свечи
+        @param result - ряд для klines. Совпадающая с previous часть копируется в начало
+        @return количество значений, которые не нужно пересчитывать. Последнее совпадающее по времени значение
+            не учитывается - его свеча могла измениться
+    */
+    static qsizetype copyOverlap(const IndicatorBuffer& previous, const KLineBuffer& klines, IndicatorBuffer& result);
+
+    /*!
+        Рассчитывает значения индикаторов начиная с позиции first. Значения до first должны быть уже рассчитаны
+    */
+    static void computeFrom(const KLineBuffer& klines, qsizetype first, IndicatorBuffer& result);
+
+private:
+    const qsizetype _capacity = 0;
+
+    std::list<Entry> _entries;  ///< ряды. В начале - последние использованные
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _index;
+
+};
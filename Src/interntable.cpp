@@ -0,0 +1,91 @@
+//STL
+#include <algorithm>
+
+#include "interntable.h"
+
+using namespace TradingCatCommon;
+
+InternTable &InternTable::instance()
+{
+    static InternTable table;
+
+    return table;
+}
+
+InternTable::ID InternTable::stockExchange(const TradingCatCommon::StockExchangeID &stockExchangeId)
+{
+    const auto it_stockExchangeIds = _stockExchangeIds.constFind(stockExchangeId.name);
+    if (it_stockExchangeIds != _stockExchangeIds.constEnd())
+    {
+        return it_stockExchangeIds.value();
+    }
+
+    const auto id = static_cast<ID>(_stockExchangeNames.size());
+    _stockExchangeNames.push_back(stockExchangeId.name);
+    _stockExchangeIds.insert(stockExchangeId.name, id);
+
+    return id;
+}
+
+InternTable::ID InternTable::symbol(const TradingCatCommon::Symbol &symbol)
+{
+    const auto it_symbolIds = _symbolIds.constFind(symbol.name);
+    if (it_symbolIds != _symbolIds.constEnd())
+    {
+        return it_symbolIds.value();
+    }
+
+    const auto id = static_cast<ID>(_symbolNames.size());
+    _symbolNames.push_back(symbol.name);
+    _symbolIds.insert(symbol.name, id);
+
+    _isSortedSymbolsValid = false;
+
+    return id;
+}
+
+const QString &InternTable::stockExchangeName(ID id) const
+{
+    Q_ASSERT(id < _stockExchangeNames.size());
+
+    return _stockExchangeNames[id];
+}
+
+const QString &InternTable::symbolName(ID id) const
+{
+    Q_ASSERT(id < _symbolNames.size());
+
+    return _symbolNames[id];
+}
+
+qsizetype InternTable::stockExchangesCount() const noexcept
+{
+    return static_cast<qsizetype>(_stockExchangeNames.size());
+}
+
+qsizetype InternTable::symbolsCount() const noexcept
+{
+    return static_cast<qsizetype>(_symbolNames.size());
+}
+
+const std::vector<InternTable::ID> &InternTable::sortedSymbols()
+{
+    if (!_isSortedSymbolsValid)
+    {
+        _sortedSymbols.resize(_symbolNames.size());
+        for (ID id = 0; id < _sortedSymbols.size(); ++id)
+        {
+            _sortedSymbols[id] = id;
+        }
+
+        std::sort(_sortedSymbols.begin(), _sortedSymbols.end(),
+                  [this](ID left, ID right)
+                  {
+                      return _symbolNames[left] < _symbolNames[right];
+                  });
+
+        _isSortedSymbolsValid = true;
+    }
+
+    return _sortedSymbols;
+}
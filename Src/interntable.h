@@ -0,0 +1,64 @@
+#pragma once
+
+//STL
+#include <vector>
+
+//Qt
+#include <QString>
+#include <QHash>
+
+//My
+#include <TradingCatCommon/kline.h>
+#include <TradingCatCommon/stockexchange.h>
+
+/*!
+    Таблица интернирования имен бирж и символов. Каждому имени один раз присваивается плотный целочисленный ИД,
+    дальше поиск, сортировка и хэширование выполняются по ИД без сравнения строк.
+    Используется только из основного потока
+*/
+class InternTable
+{
+public:
+    using ID = quint32;
+
+    static InternTable& instance();
+
+public:
+    /*!
+        @param stockExchangeId - ИД биржи
+        @return целочисленный ИД биржи. Если биржа встречается впервые - она добавляется в таблицу
+    */
+    ID stockExchange(const TradingCatCommon::StockExchangeID& stockExchangeId);
+
+    /*!
+        @param symbol - символ
+        @return целочисленный ИД символа. Если символ встречается впервые - он добавляется в таблицу
+    */
+    ID symbol(const TradingCatCommon::Symbol& symbol);
+
+    const QString& stockExchangeName(ID id) const;
+    const QString& symbolName(ID id) const;
+
+    qsizetype stockExchangesCount() const noexcept;
+    qsizetype symbolsCount() const noexcept;
+
+    /*!
+        @return ИД всех символов, отсортированные по имени. Сортировка выполняется только после добавления новых символов
+    */
+    const std::vector<ID>& sortedSymbols();
+
+private:
+    InternTable() = default;
+    Q_DISABLE_COPY_MOVE(InternTable);
+
+private:
+    std::vector<QString> _stockExchangeNames;
+    QHash<QString, ID> _stockExchangeIds;
+
+    std::vector<QString> _symbolNames;
+    QHash<QString, ID> _symbolIds;
+
+    std::vector<ID> _sortedSymbols;  ///< ИД символов в алфавитном порядке
+    bool _isSortedSymbolsValid = true;
+
+};
@@ -0,0 +1,230 @@
+//Qt
+#include <QDateTime>
+
+//My
+#include "eventlistmodel.h"
+#include "interntable.h"
+
+#include "journallistmodel.h"
+
+JournalListModel::JournalListModel(ExchangeRegistry &exchangeRegistry, QObject *parent /* = nullptr */)
+    : QAbstractListModel(parent)
+    , _exchangeRegistry(exchangeRegistry)
+{
+}
+
+int JournalListModel::rowCount(const QModelIndex &parent /* = QModelIndex() */) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+
+    return static_cast<int>(_size);
+}
+
+QVariant JournalListModel::data(const QModelIndex &index, int role /* = Qt::DisplayRole */) const
+{
+    if (!index.isValid() || index.row() >= _size)
+    {
+        return QVariant();
+    }
+
+    const auto& detectData = detect(index.row());
+    const auto& kline = detectData->history->front();
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return QString("%1 %2->%3 Delta=%4 Volume=%5")
+            .arg(QDateTime::fromMSecsSinceEpoch(kline->closeTime).toString("dd.MM hh:mm"))
+            .arg(_exchangeRegistry.info(InternTable::instance().stockExchange(detectData->stockExchangeId)).displayName)
+            .arg(kline->id.symbol.name)
+            .arg(detectData->delta)
+            .arg(detectData->volume);
+    case Qt::ForegroundRole:
+        return _exchangeRegistry.info(InternTable::instance().stockExchange(detectData->stockExchangeId)).color;
+    case Qt::DecorationRole:
+        return EventListModel::detectIcon(kline->open <= kline->close, 0);
+    case Qt::ToolTipRole:
+        return QDateTime::fromMSecsSinceEpoch(kline->closeTime).toString("dd.MM.yyyy hh:mm:ss");
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+void JournalListModel::clear()
+{
+    beginResetModel();
+
+    _pages.clear();
+    _size = 0;
+
+    endResetModel();
+}
+
+int JournalListModel::prepend(quint64 number, DetectJournal::DetectList &&detected)
+{
+    Q_ASSERT(_pages.empty() || number < _pages.front().number);
+
+    if (static_cast<qsizetype>(_pages.size()) >= MAX_PAGES)
+    {
+        removeLastPage();
+    }
+
+    const auto count = static_cast<int>(detected.size());
+    if (count > 0)
+    {
+        beginInsertRows(QModelIndex(), 0, count - 1);
+    }
+
+    _pages.push_front({number, _lastIndex + 1, std::move(detected)});
+    _lastIndex += count;
+    _size += count;
+
+    if (count > 0)
+    {
+        endInsertRows();
+    }
+
+    return count;
+}
+
+void JournalListModel::append(quint64 number, DetectJournal::DetectList &&detected)
+{
+    Q_ASSERT(_pages.empty() || number >= _pages.back().number);
+
+    //текущий блок журнала перечитывается по мере дописывания событий
+    if (!_pages.empty() && _pages.back().number == number)
+    {
+        removeLastPage();
+    }
+
+    if (static_cast<qsizetype>(_pages.size()) >= MAX_PAGES)
+    {
+        removeFirstPage();
+    }
+
+    const auto count = static_cast<int>(detected.size());
+    if (count > 0)
+    {
+        beginInsertRows(QModelIndex(), static_cast<int>(_size), static_cast<int>(_size) + count - 1);
+    }
+
+    _pages.push_back({number, _lastIndex + 1, std::move(detected)});
+    _lastIndex += count;
+    _size += count;
+
+    if (count > 0)
+    {
+        endInsertRows();
+    }
+}
+
+quint64 JournalListModel::firstChunk() const noexcept
+{
+    return _pages.empty() ? DetectJournal::NO_CHUNK : _pages.front().number;
+}
+
+quint64 JournalListModel::lastChunk() const noexcept
+{
+    return _pages.empty() ? DetectJournal::NO_CHUNK : _pages.back().number;
+}
+
+qsizetype JournalListModel::pageCount() const noexcept
+{
+    return static_cast<qsizetype>(_pages.size());
+}
+
+const TradingCatCommon::Detector::PKLineDetectData &JournalListModel::detect(int row) const
+{
+    const auto [page, position] = locate(row);
+
+    return page->detected[position];
+}
+
+quint64 JournalListModel::detectIndex(int row) const
+{
+    const auto [page, position] = locate(row);
+
+    return page->firstIndex + static_cast<quint64>(position);
+}
+
+int JournalListModel::row(qint64 time) const
+{
+    int row = 0;
+    for (const auto& page: _pages)
+    {
+        for (const auto& detectData: page.detected)
+        {
+            if (detectData->history->front()->closeTime >= time)
+            {
+                return row;
+            }
+            ++row;
+        }
+    }
+
+    return static_cast<int>(_size) - 1;
+}
+
+std::pair<const JournalListModel::Page*, qsizetype> JournalListModel::locate(int row) const
+{
+    Q_ASSERT(row >= 0 && row < _size);
+
+    //в окне не больше MAX_PAGES блоков, поэтому блок ищется перебором
+    qsizetype position = row;
+    for (const auto& page: _pages)
+    {
+        const auto size = static_cast<qsizetype>(page.detected.size());
+        if (position < size)
+        {
+            return {&page, position};
+        }
+        position -= size;
+    }
+
+    Q_ASSERT(false);
+
+    return {nullptr, 0};
+}
+
+void JournalListModel::removeFirstPage()
+{
+    Q_ASSERT(!_pages.empty());
+
+    const auto count = static_cast<int>(_pages.front().detected.size());
+    if (count > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, count - 1);
+    }
+
+    _pages.pop_front();
+    _size -= count;
+
+    if (count > 0)
+    {
+        endRemoveRows();
+    }
+}
+
+void JournalListModel::removeLastPage()
+{
+    Q_ASSERT(!_pages.empty());
+
+    const auto count = static_cast<int>(_pages.back().detected.size());
+    if (count > 0)
+    {
+        beginRemoveRows(QModelIndex(), static_cast<int>(_size) - count, static_cast<int>(_size) - 1);
+    }
+
+    _pages.pop_back();
+    _size -= count;
+
+    if (count > 0)
+    {
+        endRemoveRows();
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+//STL
+#include <deque>
+#include <utility>
+
+//Qt
+#include <QAbstractListModel>
+
+//My
+#include "detectjournal.h"
+#include "exchangeregistry.h"
+
+/*!
+    Окно просмотра журнала событий: несколько соседних блоков DetectJournal, загруженных в память.
+    Блоки добавляются в начало или конец окна по мере прокрутки, при превышении MAX_PAGES
+    удаляются блоки с противоположного конца, поэтому в памяти находится только видимая часть журнала
+*/
+class JournalListModel
+    : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr qsizetype MAX_PAGES = 5;  ///< максимальное количество блоков в окне
+
+public:
+    /*!
+        Конструктор
+        @param exchangeRegistry - справочник бирж. Должен существовать все время жизни модели
+        @param parent - родительский объект
+    */
+    JournalListModel(ExchangeRegistry& exchangeRegistry, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    void clear();
+
+    /*!
+        Добавляет блок перед первым блоком окна
+        @param number - номер блока
+        @param detected - события блока
+        @return количество добавленных строк
+    */
+    int prepend(quint64 number, DetectJournal::DetectList&& detected);
+
+    /*!
+        Добавляет блок после последнего блока окна. Блок с номером последнего блока окна заменяет его
+        @param number - номер блока
+        @param detected - события блока
+    */
+    void append(quint64 number, DetectJournal::DetectList&& detected);
+
+    /*!
+        @return номер первого блока окна или DetectJournal::NO_CHUNK если окно пусто
+    */
+    quint64 firstChunk() const noexcept;
+
+    /*!
+        @return номер последнего блока окна или DetectJournal::NO_CHUNK если окно пусто
+    */
+    quint64 lastChunk() const noexcept;
+    qsizetype pageCount() const noexcept;
+
+    const TradingCatCommon::Detector::PKLineDetectData& detect(int row) const;
+
+    /*!
+        @param row - номер строки
+        @return ИД события для кэша данных графиков. Уникален для каждой загрузки блока
+    */
+    quint64 detectIndex(int row) const;
+
+    /*!
+        @param time - время, мс
+        @return номер первой строки, время события которой не раньше time, или последняя строка
+    */
+    int row(qint64 time) const;
+
+private:
+    JournalListModel() = delete;
+    Q_DISABLE_COPY_MOVE(JournalListModel);
+
+    struct Page
+    {
+        quint64 number = 0;                ///< номер блока
+        quint64 firstIndex = 0;            ///< ИД первого события блока
+        DetectJournal::DetectList detected;
+    };
+
+    /*!
+        @param row - номер строки
+        @return блок и позиция события строки в блоке
+    */
+    std::pair<const Page*, qsizetype> locate(int row) const;
+
+    void removeFirstPage();
+    void removeLastPage();
+
+private:
+    ExchangeRegistry& _exchangeRegistry;
+
+    std::deque<Page> _pages;   ///< блоки окна в порядке номеров
+    qsizetype _size = 0;       ///< количество строк
+
+    quint64 _lastIndex = 0;
+
+};
@@ -0,0 +1,218 @@
+//Qt
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QSplitter>
+#include <QScrollBar>
+#include <QDateTime>
+
+//My
+#include "localconfig.h"
+
+#include "journalwidget.h"
+
+constexpr static const qsizetype CHART_DATA_CACHE_SIZE = 8;
+
+JournalWidget::JournalWidget(DetectJournal &detectJournal, ExchangeRegistry &exchangeRegistry, QWidget *parent)
+    : QWidget(parent)
+    , _detectJournal(detectJournal)
+    , _chartDataCache(CHART_DATA_CACHE_SIZE)
+{
+    Q_CHECK_PTR(parent);
+
+    auto layout = new QVBoxLayout(this);
+
+    auto toolsLayout = new QHBoxLayout();
+    layout->addLayout(toolsLayout);
+
+    auto latestPB = new QPushButton("Latest", this);
+    toolsLayout->addWidget(latestPB);
+
+    _goToDateTimeEdit = new QDateTimeEdit(QDateTime::currentDateTime(), this);
+    _goToDateTimeEdit->setDisplayFormat("dd.MM.yyyy hh:mm");
+    _goToDateTimeEdit->setCalendarPopup(true);
+    toolsLayout->addWidget(_goToDateTimeEdit);
+
+    auto goToPB = new QPushButton("Go to", this);
+    toolsLayout->addWidget(goToPB);
+    toolsLayout->addStretch();
+
+    auto splitter = new QSplitter(Qt::Horizontal, this);
+    layout->addWidget(splitter, 1);
+
+    _journalListModel = new JournalListModel(exchangeRegistry, this);
+
+    _journalList = new QListView(splitter);
+    _journalList->setModel(_journalListModel);
+    _journalList->setUniformItemSizes(true);
+    _journalList->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    _journalList->setIconSize(QSize(16, 16));
+    splitter->addWidget(_journalList);
+
+    _chart = new MultiPaneChart(_chartDataCache, splitter);
+    _chart->addPane(ChartDataCache::ESource::HISTORY, {0.7, true, {true, true, true, true}}, static_cast<qsizetype>(LocalConfig::EHistoryKLineCount::MAX));
+    _chart->addPane(ChartDataCache::ESource::REVIEW, {0.5, false, {true, false, false, false}}, static_cast<qsizetype>(LocalConfig::EReviewHistoryKLineCount::MAX));
+    splitter->addWidget(_chart);
+    splitter->setStretchFactor(1, 1);
+
+    QObject::connect(&_detectJournal, SIGNAL(opened()), this, SLOT(journalOpened()));
+    QObject::connect(&_detectJournal, SIGNAL(chunkLoaded(quint64, const DetectJournal::DetectList&)),
+                     this, SLOT(chunkLoaded(quint64, const DetectJournal::DetectList&)));
+    QObject::connect(latestPB, SIGNAL(clicked()), this, SLOT(latestPBClicked()));
+    QObject::connect(goToPB, SIGNAL(clicked()), this, SLOT(goToPBClicked()));
+    QObject::connect(_journalList->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(scrollBarValueChanged(int)));
+    QObject::connect(_journalList, SIGNAL(clicked(const QModelIndex&)), this, SLOT(journalListClicked(const QModelIndex&)));
+}
+
+void JournalWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+
+    //при первом показе открываем последние события журнала
+    if (!_isLatestLoaded && _detectJournal.isOpened())
+    {
+        _isLatestLoaded = true;
+
+        latestPBClicked();
+    }
+}
+
+void JournalWidget::journalOpened()
+{
+    if (!_isLatestLoaded && isVisible())
+    {
+        _isLatestLoaded = true;
+
+        latestPBClicked();
+    }
+}
+
+void JournalWidget::chunkLoaded(quint64 number, const DetectJournal::DetectList &detected)
+{
+    if (_load == ELoad::NONE || number != _loadNumber)
+    {
+        return;
+    }
+
+    //до конца изменения окна _load не сбрасывается, чтобы прокрутка при вставке строк не запускала новую загрузку
+    switch (_load)
+    {
+    case ELoad::REPLACE:
+    {
+        _journalListModel->clear();
+        _journalListModel->append(number, DetectJournal::DetectList(detected));
+
+        if (_journalListModel->rowCount() > 0)
+        {
+            const auto index = _journalListModel->index(_goToTime != 0 ? _journalListModel->row(_goToTime) : _journalListModel->rowCount() - 1);
+            _journalList->setCurrentIndex(index);
+            _journalList->scrollTo(index, _goToTime != 0 ? QAbstractItemView::PositionAtTop : QAbstractItemView::PositionAtBottom);
+        }
+        break;
+    }
+    case ELoad::PREPEND:
+    {
+        //сохраняем видимые строки на месте после вставки строк выше них
+        const auto count = _journalListModel->prepend(number, DetectJournal::DetectList(detected));
+        if (count > 0 && count < _journalListModel->rowCount())
+        {
+            _journalList->scrollTo(_journalListModel->index(count), QAbstractItemView::PositionAtTop);
+        }
+        break;
+    }
+    case ELoad::APPEND:
+        _journalListModel->append(number, DetectJournal::DetectList(detected));
+        break;
+    case ELoad::NONE:
+    default:
+        Q_ASSERT(false);
+    }
+
+    _load = ELoad::NONE;
+    _loadNumber = DetectJournal::NO_CHUNK;
+
+    loadNeighbour();
+}
+
+void JournalWidget::latestPBClicked()
+{
+    if (!_detectJournal.isOpened())
+    {
+        return;
+    }
+
+    _goToTime = 0;
+
+    load(_detectJournal.lastChunk(), ELoad::REPLACE);
+}
+
+void JournalWidget::goToPBClicked()
+{
+    if (!_detectJournal.isOpened())
+    {
+        return;
+    }
+
+    _goToTime = _goToDateTimeEdit->dateTime().toMSecsSinceEpoch();
+
+    load(_detectJournal.findChunk(_goToTime), ELoad::REPLACE);
+}
+
+void JournalWidget::scrollBarValueChanged(int value)
+{
+    Q_UNUSED(value);
+
+    loadNeighbour();
+}
+
+void JournalWidget::journalListClicked(const QModelIndex &index)
+{
+    if (!index.isValid())
+    {
+        return;
+    }
+
+    _chart->setDetect(_journalListModel->detectIndex(index.row()), _journalListModel->detect(index.row()));
+}
+
+void JournalWidget::load(quint64 number, ELoad load)
+{
+    Q_ASSERT(load != ELoad::NONE);
+
+    //переход к дате или последним событиям отменяет ожидание подгрузки соседнего блока
+    if (number == DetectJournal::NO_CHUNK || (_load != ELoad::NONE && load != ELoad::REPLACE))
+    {
+        return;
+    }
+
+    _load = load;
+    _loadNumber = number;
+
+    _detectJournal.load(number);
+}
+
+void JournalWidget::loadNeighbour()
+{
+    const auto firstChunk = _journalListModel->firstChunk();
+    const auto lastChunk = _journalListModel->lastChunk();
+    if (_load != ELoad::NONE || firstChunk == DetectJournal::NO_CHUNK)
+    {
+        return;
+    }
+
+    //если заполненное окно не прокручивается, подгрузка с одного края вытеснила бы блок, нужный на другом
+    const auto scrollBar = _journalList->verticalScrollBar();
+    const auto isScrollable = scrollBar->maximum() > scrollBar->minimum();
+    if (!isScrollable && _journalListModel->pageCount() >= JournalListModel::MAX_PAGES)
+    {
+        return;
+    }
+
+    if (scrollBar->value() == scrollBar->minimum() && firstChunk > _detectJournal.firstChunk())
+    {
+        load(firstChunk - 1, ELoad::PREPEND);
+    }
+    else if (scrollBar->value() == scrollBar->maximum() && lastChunk < _detectJournal.lastChunk())
+    {
+        load(lastChunk + 1, ELoad::APPEND);
+    }
+}
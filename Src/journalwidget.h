@@ -0,0 +1,85 @@
+#pragma once
+
+//Qt
+#include <QWidget>
+#include <QListView>
+#include <QDateTimeEdit>
+#include <QPushButton>
+
+//My
+#include "detectjournal.h"
+#include "journallistmodel.h"
+#include "chartdatacache.h"
+#include "multipanechart.h"
+#include "exchangeregistry.h"
+
+/*!
+    Содержимое вкладки журнала: список событий DetectJournal с переходом к дате и график выбранного события.
+    При прокрутке к краю списка подгружается соседний блок журнала, поэтому листать можно всю историю
+    за дни, а в памяти находится только окно JournalListModel
+*/
+class JournalWidget
+    : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /*!
+        Конструктор
+        @param detectJournal - журнал событий. Должен существовать все время жизни виджета
+        @param exchangeRegistry - справочник бирж. Должен существовать все время жизни виджета
+        @param parent - родительский виджет
+    */
+    JournalWidget(DetectJournal& detectJournal, ExchangeRegistry& exchangeRegistry, QWidget* parent);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+
+private slots:
+    void journalOpened();
+    void chunkLoaded(quint64 number, const DetectJournal::DetectList& detected);
+    void latestPBClicked();
+    void goToPBClicked();
+    void scrollBarValueChanged(int value);
+    void journalListClicked(const QModelIndex& index);
+
+private:
+    JournalWidget() = delete;
+    Q_DISABLE_COPY_MOVE(JournalWidget);
+
+    enum class ELoad: quint8
+    {
+        NONE = 0,   ///< загрузка не выполняется
+        REPLACE,    ///< блок заменяет окно
+        PREPEND,    ///< блок добавляется в начало окна
+        APPEND      ///< блок добавляется в конец окна
+    };
+
+    /*!
+        Запускает загрузку блока. Пока блок не загружен, остальные запросы игнорируются
+        @param number - номер блока
+        @param load - способ добавления блока в окно
+    */
+    void load(quint64 number, ELoad load);
+
+    /*!
+        Подгружает соседний блок, если список прокручен к краю окна
+    */
+    void loadNeighbour();
+
+private:
+    DetectJournal& _detectJournal;
+
+    JournalListModel* _journalListModel = nullptr;
+    QListView* _journalList = nullptr;
+    QDateTimeEdit* _goToDateTimeEdit = nullptr;
+
+    ChartDataCache _chartDataCache;         ///< данные графика событий журнала. Отдельный от списка событий кэш
+    MultiPaneChart* _chart = nullptr;
+
+    ELoad _load = ELoad::NONE;
+    quint64 _loadNumber = DetectJournal::NO_CHUNK;  ///< номер загружаемого блока
+    qint64 _goToTime = 0;                           ///< время, к которому переходит список после загрузки, мс. 0 - к последнему событию
+    bool _isLatestLoaded = false;                   ///< последний блок загружался при первом показе
+
+};
@@ -0,0 +1,210 @@
+//STL
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "klinebuffer.h"
+
+using namespace TradingCatCommon;
+
+KLineBuffer KLineBuffer::fromKLines(const TradingCatCommon::PKLinesList &klines, qsizetype count)
+{
+    Q_CHECK_PTR(klines);
+
+    KLineBuffer result;
+    if (klines->empty())
+    {
+        return result;
+    }
+
+    count = std::min(count, static_cast<qsizetype>(klines->size()));
+
+    result.duration = static_cast<qint64>(klines->front()->id.type);
+    result.time.resize(count);
+    result.open.resize(count);
+    result.high.resize(count);
+    result.low.resize(count);
+    result.close.resize(count);
+    result.volume.resize(count);
+
+    //в списке первая свеча самая новая - заполняем массивы с конца
+    qsizetype index = count;
+    for (const auto& kline: *klines)
+    {
+        if (index == 0)
+        {
+            break;
+        }
+
+        --index;
+
+        result.time[index] = kline->closeTime;
+        result.open[index] = kline->open;
+        result.high[index] = kline->high;
+        result.low[index] = kline->low;
+        result.close[index] = kline->close;
+        result.volume[index] = kline->volume;
+    }
+
+    result.updateRange();
+
+    return result;
+}
+
+KLineBuffer KLineBuffer::downsample(qsizetype maxCount) const
+{
+    Q_ASSERT(maxCount > 0);
+
+    const auto bucketSize = downsampleBucketSize(size(), maxCount);
+    if (bucketSize == 1)
+    {
+        return *this;
+    }
+
+    Q_ASSERT(duration > 0);
+
+    return resample(duration * bucketSize);
+}
+
+qsizetype KLineBuffer::downsampleBucketSize(qsizetype count, qsizetype maxCount)
+{
+    Q_ASSERT(maxCount > 0);
+
+    if (count <= maxCount)
+    {
+        return 1;
+    }
+
+    //выравнивание по времени может дать одну лишнюю неполную корзину с каждого края
+    return (count + std::max<qsizetype>(1, maxCount - 2) - 1) / std::max<qsizetype>(1, maxCount - 2);
+}
+
+KLineBuffer KLineBuffer::resample(qint64 bucketDuration) const
+{
+    Q_ASSERT(duration > 0);
+    Q_ASSERT(bucketDuration >= duration && bucketDuration % duration == 0);
+
+    if (bucketDuration == duration)
+    {
+        return *this;
+    }
+
+    const auto isIndicators = hasIndicators();
+
+    KLineBuffer result;
+    result.duration = bucketDuration;
+    result.reserve(size() * duration / bucketDuration + 2);
+
+    qint64 currentBucket = std::numeric_limits<qint64>::min();
+    for (qsizetype index = 0; index < size(); ++index)
+    {
+        //время закрытия свечи лежит на правой границе ее интервала, поэтому корзина ищется по time - 1
+        //и получает время своего закрытия, даже если в ней еще нет последней свечи
+        const auto bucket = (time[index] - 1) / bucketDuration;
+        if (bucket != currentBucket)
+        {
+            result.append((bucket + 1) * bucketDuration, open[index], high[index], low[index], close[index], volume[index]);
+            currentBucket = bucket;
+
+            if (isIndicators)
+            {
+                result.ema.push_back(ema[index]);
+                result.vwap.push_back(vwap[index]);
+                result.rsi.push_back(rsi[index]);
+                result.atr.push_back(atr[index]);
+            }
+
+            continue;
+        }
+
+        result.high.back() = std::max(result.high.back(), high[index]);
+        result.low.back() = std::min(result.low.back(), low[index]);
+        result.close.back() = close[index];
+        result.volume.back() += volume[index];
+
+        if (isIndicators)
+        {
+            result.ema.back() = ema[index];
+            result.vwap.back() = vwap[index];
+            result.rsi.back() = rsi[index];
+            result.atr.back() = atr[index];
+        }
+    }
+
+    result.updateRange();
+
+    return result;
+}
+
+KLineBuffer KLineBuffer::tail(qsizetype count) const
+{
+    Q_ASSERT(count >= 0);
+
+    if (count >= size())
+    {
+        return *this;
+    }
+
+    const auto first = size() - count;
+    const auto copyTail = [first](const auto& values)
+    {
+        return std::decay_t<decltype(values)>(values.begin() + first, values.end());
+    };
+
+    KLineBuffer result;
+    result.duration = duration;
+    result.time = copyTail(time);
+    result.open = copyTail(open);
+    result.high = copyTail(high);
+    result.low = copyTail(low);
+    result.close = copyTail(close);
+    result.volume = copyTail(volume);
+
+    if (hasIndicators())
+    {
+        result.ema = copyTail(ema);
+        result.vwap = copyTail(vwap);
+        result.rsi = copyTail(rsi);
+        result.atr = copyTail(atr);
+    }
+
+    result.updateRange();
+
+    return result;
+}
+
+void KLineBuffer::reserve(qsizetype count)
+{
+    time.reserve(count);
+    open.reserve(count);
+    high.reserve(count);
+    low.reserve(count);
+    close.reserve(count);
+    volume.reserve(count);
+}
+
+void KLineBuffer::append(qint64 closeTime, float openValue, float highValue, float lowValue, float closeValue, float volumeValue)
+{
+    time.push_back(closeTime);
+    open.push_back(openValue);
+    high.push_back(highValue);
+    low.push_back(lowValue);
+    close.push_back(closeValue);
+    volume.push_back(volumeValue);
+}
+
+void KLineBuffer::updateRange()
+{
+    if (time.empty())
+    {
+        priceMin = 0.0f;
+        priceMax = 0.0f;
+        volumeMax = 0.0f;
+
+        return;
+    }
+
+    priceMax = *std::max_element(high.begin(), high.end());
+    priceMin = *std::min_element(low.begin(), low.end());
+    volumeMax = *std::max_element(volume.begin(), volume.end());
+}
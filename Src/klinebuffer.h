@@ -0,0 +1,88 @@
+#pragma once
+
+//STL
+#include <vector>
+#include <memory>
+
+//Qt
+#include <QtGlobal>
+
+//My
+#include <TradingCatCommon/kline.h>
+
+/*!
+    Свечи, разложенные по непрерывным массивам значений. Индекс 0 - самая старая свеча.
+    Используется как неизменяемый источник данных для графиков
+*/
+struct KLineBuffer
+{
+    qint64 duration = 0;          ///< длительность одной свечи (корзины), мс
+    std::vector<qint64> time;     ///< время закрытия, мс
+    std::vector<float> open;
+    std::vector<float> high;
+    std::vector<float> low;
+    std::vector<float> close;
+    std::vector<float> volume;
+
+    //индикаторы. Пустые, если не рассчитаны. Для объединенной свечи - значение последней свечи корзины
+    std::vector<float> ema;
+    std::vector<float> vwap;
+    std::vector<float> rsi;
+    std::vector<float> atr;
+
+    float priceMin = 0.0f;        ///< минимальная цена
+    float priceMax = 0.0f;        ///< максимальная цена
+    float volumeMax = 0.0f;       ///< максимальный объем
+
+    /*!
+        Копирует свечи в буфер
+        @param klines - свечи. Первая - самая новая
+        @param count - максимальное количество копируемых свечей, начиная с самой новой
+        @return буфер
+    */
+    static KLineBuffer fromKLines(const TradingCatCommon::PKLinesList& klines, qsizetype count);
+
+    /*!
+        Объединяет соседние свечи в корзины OHLCV так, чтобы их количество не превышало maxCount.
+        Границы корзин выровнены по времени, поэтому при добавлении новых свечей старые корзины не меняются
+        @param maxCount - максимальное количество свечей в результате
+        @return буфер с объединенными свечами. Если свечей не больше maxCount - копия исходного буфера
+    */
+    KLineBuffer downsample(qsizetype maxCount) const;
+
+    /*!
+        @param count - количество свечей
+        @param maxCount - максимальное количество свечей в результате
+        @return количество свечей, объединяемых downsample() в одну корзину. 1 - свечи не объединяются
+    */
+    static qsizetype downsampleBucketSize(qsizetype count, qsizetype maxCount);
+
+    /*!
+        Объединяет свечи в свечи большего интервала за один проход. Границы свечей выровнены по времени,
+        время свечи результата - время закрытия ее интервала
+        @param bucketDuration - длительность свечи результата, мс. Должна быть кратна duration
+        @return буфер с объединенными свечами. Первая и последняя свечи могут быть неполными
+    */
+    KLineBuffer resample(qint64 bucketDuration) const;
+
+    /*!
+        @param count - количество свечей
+        @return буфер с count самыми новыми свечами
+    */
+    KLineBuffer tail(qsizetype count) const;
+
+    qsizetype size() const noexcept { return static_cast<qsizetype>(time.size()); }
+    bool isEmpty() const noexcept { return time.empty(); }
+    bool hasIndicators() const noexcept { return !ema.empty(); }
+
+    void reserve(qsizetype count);
+    void append(qint64 closeTime, float openValue, float highValue, float lowValue, float closeValue, float volumeValue);
+
+    /*!
+        Пересчитывает диапазоны значений priceMin, priceMax и volumeMax. Вызывается один раз после заполнения буфера,
+        дальше диапазоны используются всеми графиками, отображающими буфер
+    */
+    void updateRange();
+};
+
+using PKLineBuffer = std::shared_ptr<const KLineBuffer>;
@@ -2,6 +2,11 @@
 
 using namespace emscripten;
 
+constexpr static const int FLUSH_DELAY = 500;         //ms
+constexpr static const qint64 MAX_FLUSH_DELAY = 5000; //ms
+
+static LocalConfig* localConfigInstance = nullptr;     ///< настройки, записываемые при закрытии страницы
+
 //static
 LocalConfig::EHistoryKLineCount LocalConfig::stringToEHistoryKLineCount(const QString &count)
 {
@@ -48,17 +53,111 @@ LocalConfig::EReviewHistoryKLineCount LocalConfig::stringToEReviewHistoryKLineCo
     return EReviewHistoryKLineCount::MAX;
 }
 
+LocalConfig::EHistoryKLineType LocalConfig::stringToEHistoryKLineType(const QString &type)
+{
+    if (type == QString::number(static_cast<quint64>(EHistoryKLineType::MIN5)))
+    {
+        return EHistoryKLineType::MIN5;
+    }
+    else if (type == QString::number(static_cast<quint64>(EHistoryKLineType::MIN15)))
+    {
+        return EHistoryKLineType::MIN15;
+    }
+    else if (type == QString::number(static_cast<quint64>(EHistoryKLineType::H1)))
+    {
+        return EHistoryKLineType::H1;
+    }
+
+    return EHistoryKLineType::MIN1;
+}
+
+const char* LocalConfig::keyName(EKey key) noexcept
+{
+    switch (key)
+    {
+    case EKey::USER: return "user";
+    case EKey::PASSWORD: return "password";
+    case EKey::SPLITTER_POS: return "splitter_pos";
+    case EKey::AUTO_SCROLL: return "auto_scroll";
+    case EKey::HISTORY_KLINE_COUNT: return "history_kline_count";
+    case EKey::REVIEW_HISTORY_KLINE_COUNT: return "review_history_kline_count";
+    case EKey::HISTORY_KLINE_TYPE: return "history_kline_type";
+    case EKey::COALESCE_BURSTS: return "coalesce_bursts";
+    case EKey::COUNT:
+    default:
+        Q_ASSERT(false);
+    }
+
+    return "";
+}
+
+const char* LocalConfig::beforeUnload(int eventType, const void *reserved, void *userData)
+{
+    Q_UNUSED(eventType);
+    Q_UNUSED(reserved);
+    Q_UNUSED(userData);
+
+    if (localConfigInstance != nullptr)
+    {
+        localConfigInstance->flush();
+    }
+
+    return nullptr;
+}
+
 //class
 LocalConfig::LocalConfig()
 {
+    Q_ASSERT(localConfigInstance == nullptr);
+
+    localConfigInstance = this;
+
     _localStorage = val::global("window")["localStorage"];
 
-    _user = QByteArray::fromBase64(loadValue("user").toUtf8());
-    _password = QByteArray::fromBase64(loadValue("password").toUtf8());
-    _splitterPos = QByteArray::fromBase64(loadValue("splitter_pos").toUtf8());
-    _autoScroll = loadValue("auto_scroll") == "0" ? false : true;
-    _historyKLineCount = stringToEHistoryKLineCount(loadValue("history_kline_count"));
-    _reviewHistoryKLineCount = stringToEReviewHistoryKLineCount(loadValue("review_history_kline_count"));
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(FLUSH_DELAY);
+    _flushTimer.callOnTimeout([this](){ flush(); });
+
+    //обработчик работает через localConfigInstance и не снимается: снятие удалило бы все обработчики beforeunload,
+    //в том числе обработчики SessionStore и DetectJournal
+    emscripten_set_beforeunload_callback(nullptr, LocalConfig::beforeUnload);
+
+    _user = QByteArray::fromBase64(loadValue(keyName(EKey::USER)).toUtf8());
+    _password = QByteArray::fromBase64(loadValue(keyName(EKey::PASSWORD)).toUtf8());
+    _splitterPos = QByteArray::fromBase64(loadValue(keyName(EKey::SPLITTER_POS)).toUtf8());
+    _autoScroll = loadValue(keyName(EKey::AUTO_SCROLL)) == "0" ? false : true;
+    _historyKLineCount = stringToEHistoryKLineCount(loadValue(keyName(EKey::HISTORY_KLINE_COUNT)));
+    _reviewHistoryKLineCount = stringToEReviewHistoryKLineCount(loadValue(keyName(EKey::REVIEW_HISTORY_KLINE_COUNT)));
+    _historyKLineType = stringToEHistoryKLineType(loadValue(keyName(EKey::HISTORY_KLINE_TYPE)));
+    _coalesceBursts = loadValue(keyName(EKey::COALESCE_BURSTS)) == "1";
+}
+
+LocalConfig::~LocalConfig()
+{
+    flush();
+
+    localConfigInstance = nullptr;
+}
+
+void LocalConfig::flush()
+{
+    _flushTimer.stop();
+    _dirtyTimer.invalidate();
+
+    if (_dirty.none())
+    {
+        return;
+    }
+
+    for (quint8 key = 0; key < static_cast<quint8>(EKey::COUNT); ++key)
+    {
+        if (_dirty.test(key))
+        {
+            saveValue(keyName(static_cast<EKey>(key)), encodeValue(static_cast<EKey>(key)));
+        }
+    }
+
+    _dirty.reset();
 }
 
 const QString &LocalConfig::user() const noexcept
@@ -68,8 +167,13 @@ const QString &LocalConfig::user() const noexcept
 
 void LocalConfig::setUser(const QString &user)
 {
+    if (_user == user)
+    {
+        return;
+    }
+
     _user = user;
-    saveValue("user", _user.toUtf8().toBase64());
+    markDirty(EKey::USER);
 }
 
 const QString &LocalConfig::password() const noexcept
@@ -79,8 +183,13 @@ const QString &LocalConfig::password() const noexcept
 
 void LocalConfig::setPassword(const QString &password)
 {
+    if (_password == password)
+    {
+        return;
+    }
+
     _password = password;
-    saveValue("password", _password.toUtf8().toBase64());
+    markDirty(EKey::PASSWORD);
 }
 
 QByteArray LocalConfig::splitterPos() const noexcept
@@ -90,8 +199,13 @@ QByteArray LocalConfig::splitterPos() const noexcept
 
 void LocalConfig::setSplitterPos(const QByteArray& newPos)
 {
-    _splitterPos= newPos;
-    saveValue("splitter_pos", QString(_splitterPos.toBase64()));
+    if (_splitterPos == newPos)
+    {
+        return;
+    }
+
+    _splitterPos = newPos;
+    markDirty(EKey::SPLITTER_POS);
 }
 
 bool LocalConfig::autoScroll() const noexcept
@@ -101,14 +215,40 @@ bool LocalConfig::autoScroll() const noexcept
 
 void LocalConfig::setAutoScroll(bool autoscroll)
 {
+    if (_autoScroll == autoscroll)
+    {
+        return;
+    }
+
     _autoScroll = autoscroll;
-    saveValue("auto_scroll", _autoScroll ? "1" : "0");
+    markDirty(EKey::AUTO_SCROLL);
+}
+
+bool LocalConfig::coalesceBursts() const noexcept
+{
+    return _coalesceBursts;
+}
+
+void LocalConfig::setCoalesceBursts(bool coalesceBursts)
+{
+    if (_coalesceBursts == coalesceBursts)
+    {
+        return;
+    }
+
+    _coalesceBursts = coalesceBursts;
+    markDirty(EKey::COALESCE_BURSTS);
 }
 
 void LocalConfig::setHistoryKLineCount(EHistoryKLineCount count)
 {
+    if (_historyKLineCount == count)
+    {
+        return;
+    }
+
     _historyKLineCount = count;
-    saveValue("history_kline_count", QString::number(static_cast<quint64>(_historyKLineCount)));
+    markDirty(EKey::HISTORY_KLINE_COUNT);
 }
 
 LocalConfig::EReviewHistoryKLineCount LocalConfig::reviewHistoryKLineCount() const noexcept
@@ -118,8 +258,13 @@ LocalConfig::EReviewHistoryKLineCount LocalConfig::reviewHistoryKLineCount() con
 
 void LocalConfig::setReviewHistoryKLineCount(EReviewHistoryKLineCount count)
 {
+    if (_reviewHistoryKLineCount == count)
+    {
+        return;
+    }
+
     _reviewHistoryKLineCount = count;
-    saveValue("review_history_kline_count", QString::number(static_cast<quint64>(_reviewHistoryKLineCount)));
+    markDirty(EKey::REVIEW_HISTORY_KLINE_COUNT);
 }
 
 LocalConfig::EHistoryKLineCount LocalConfig::historyKLineCount() const noexcept
@@ -127,6 +272,62 @@ LocalConfig::EHistoryKLineCount LocalConfig::historyKLineCount() const noexcept
     return _historyKLineCount;
 }
 
+LocalConfig::EHistoryKLineType LocalConfig::historyKLineType() const noexcept
+{
+    return _historyKLineType;
+}
+
+void LocalConfig::setHistoryKLineType(EHistoryKLineType type)
+{
+    if (_historyKLineType == type)
+    {
+        return;
+    }
+
+    _historyKLineType = type;
+    markDirty(EKey::HISTORY_KLINE_TYPE);
+}
+
+void LocalConfig::markDirty(EKey key)
+{
+    _dirty.set(static_cast<size_t>(key));
+
+    if (!_dirtyTimer.isValid())
+    {
+        _dirtyTimer.start();
+    }
+
+    //при непрерывных изменениях (например, перетаскивании разделителя) записываем не реже MAX_FLUSH_DELAY
+    if (_dirtyTimer.elapsed() >= MAX_FLUSH_DELAY)
+    {
+        flush();
+
+        return;
+    }
+
+    _flushTimer.start();
+}
+
+QString LocalConfig::encodeValue(EKey key) const
+{
+    switch (key)
+    {
+    case EKey::USER: return _user.toUtf8().toBase64();
+    case EKey::PASSWORD: return _password.toUtf8().toBase64();
+    case EKey::SPLITTER_POS: return _splitterPos.toBase64();
+    case EKey::AUTO_SCROLL: return _autoScroll ? "1" : "0";
+    case EKey::HISTORY_KLINE_COUNT: return QString::number(static_cast<quint64>(_historyKLineCount));
+    case EKey::REVIEW_HISTORY_KLINE_COUNT: return QString::number(static_cast<quint64>(_reviewHistoryKLineCount));
+    case EKey::HISTORY_KLINE_TYPE: return QString::number(static_cast<quint64>(_historyKLineType));
+    case EKey::COALESCE_BURSTS: return _coalesceBursts ? "1" : "0";
+    case EKey::COUNT:
+    default:
+        Q_ASSERT(false);
+    }
+
+    return "";
+}
+
 void LocalConfig::saveValue(const QString &key, const QString &value)
 {
     const std::string keyString = key.toStdString();
@@ -1,16 +1,27 @@
 #pragma once
 
+//STL
+#include <bitset>
+
 //Qt
 #include <QString>
 #include <QByteArray>
+#include <QTimer>
+#include <QElapsedTimer>
 
 //EM
 #include <emscripten.h>
 #include <emscripten/val.h>
+#include <emscripten/html5.h>
 
 //My
 #include <TradingCatCommon/detector.h>
 
+/*!
+    Локальные настройки клиента в localStorage браузера.
+    Значения хранятся в памяти в своих типах. Изменения помечаются в наборе измененных ключей и записываются
+    в localStorage одной пачкой: после паузы в изменениях, не реже чем раз в MAX_FLUSH_DELAY и при закрытии страницы
+*/
 class LocalConfig
 {
 public:
@@ -34,8 +45,24 @@ public:
 
     static EReviewHistoryKLineCount stringToEReviewHistoryKLineCount(const QString& count);
 
+    enum class EHistoryKLineType: quint64  ///< интервал свечей графика истории, мс
+    {
+        MIN1 = 60 * 1000,
+        MIN5 = 5 * 60 * 1000,
+        MIN15 = 15 * 60 * 1000,
+        H1 = 60 * 60 * 1000
+    };
+
+    static EHistoryKLineType stringToEHistoryKLineType(const QString& type);
+
 public:
     LocalConfig();
+    ~LocalConfig();
+
+    /*!
+        Записывает все измененные значения в localStorage
+    */
+    void flush();
 
     const QString& user() const noexcept;
     void setUser(const QString& user);
@@ -49,26 +76,57 @@ public:
     bool autoScroll() const noexcept;
     void setAutoScroll(bool autoscroll);
 
+    bool coalesceBursts() const noexcept;
+    void setCoalesceBursts(bool coalesceBursts);
+
     EHistoryKLineCount historyKLineCount() const noexcept;
     void setHistoryKLineCount(EHistoryKLineCount count);
 
     EReviewHistoryKLineCount reviewHistoryKLineCount() const noexcept;
     void setReviewHistoryKLineCount(EReviewHistoryKLineCount count);
 
+    EHistoryKLineType historyKLineType() const noexcept;
+    void setHistoryKLineType(EHistoryKLineType type);
+
 private:
     Q_DISABLE_COPY_MOVE(LocalConfig);
 
+    enum class EKey: quint8
+    {
+        USER = 0,
+        PASSWORD,
+        SPLITTER_POS,
+        AUTO_SCROLL,
+        HISTORY_KLINE_COUNT,
+        REVIEW_HISTORY_KLINE_COUNT,
+        HISTORY_KLINE_TYPE,
+        COALESCE_BURSTS,
+        COUNT
+    };
+
+    static const char* keyName(EKey key) noexcept;
+    static const char* beforeUnload(int eventType, const void* reserved, void* userData);
+
+    void markDirty(EKey key);
+    QString encodeValue(EKey key) const;
+
     void saveValue(const QString& key, const QString& value);
     QString loadValue(const QString& key);
 
 private:
     emscripten::val _localStorage;
 
+    std::bitset<static_cast<size_t>(EKey::COUNT)> _dirty;  ///< ключи, измененные после последней записи
+    QTimer _flushTimer;                                      ///< таймер отложенной записи
+    QElapsedTimer _dirtyTimer;                               ///< время с момента первого незаписанного изменения
+
     QString _user;
     QString _password;
     QByteArray _splitterPos;
     bool _autoScroll = true;
+    bool _coalesceBursts = false;  ///< true - повторные детектирования символа на бирже объединяются в одну строку
     EHistoryKLineCount _historyKLineCount = EHistoryKLineCount::MAX;
     EReviewHistoryKLineCount _reviewHistoryKLineCount = EReviewHistoryKLineCount::MAX;
+    EHistoryKLineType _historyKLineType = EHistoryKLineType::MIN1;
 
 };
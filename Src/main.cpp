@@ -1,9 +1,10 @@
 #include <emscripten/html5.h>
 
 #include "mainwindow.h"
+#include "fontloader.h"
+#include "profiler.h"
 
 #include <QApplication>
-#include <QFontDatabase>
 
 QApplication *app = nullptr;
 MainWindow *appWindow = nullptr;
@@ -19,6 +20,9 @@ static bool keyCallback(int eventType, const EmscriptenKeyboardEvent *keyEvent,
 
 int main(int argc, char *argv[])
 {
+    //первое обращение запускает отсчет времени этапов запуска
+    Profiler::instance().mark("main");
+
     app = new QApplication(argc, argv);
 
     QApplication::setApplicationName("TradingCatClient");
@@ -27,28 +31,22 @@ int main(int argc, char *argv[])
 
     qDebug() << "Start" << QApplication::applicationName() << QApplication::applicationVersion();
 
-    // Загрузка файла шрифта
-    const auto fontId = QFontDatabase::addApplicationFont(":/font/font/NotoSansCJK-Regular.ttc");
-    if (fontId != -1)
-    {
-        QFont customFont("Noto Sans CJK SC");
-
-        // Применение шрифта
-        QApplication::setFont(customFont);
-        qDebug() << "Use custom font:" << customFont.family();
-    }
-    else
-    {
-        qDebug() << "The font is not load. Use font for default system" << QApplication::font().family();
-    }
+    Profiler::instance().mark("applicationCreated");
+
+    //шрифт с CJK символами загружается позже и только при необходимости (см. FontLoader)
+    FontLoader::loadLatin();
 
     appWindow = new MainWindow();
 
+    Profiler::instance().mark("mainWindowCreated");
+
     app->installEventFilter(appWindow);
 
     emscripten_set_keydown_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, appWindow, true, keyCallback);
 
     appWindow->show();
 
+    Profiler::instance().mark("mainWindowShown");
+
     return 0;
 }
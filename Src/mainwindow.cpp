@@ -1,15 +1,13 @@
 //STL
 #include <vector>
 #include <algorithm>
+#include <limits>
 
 //Qt
 #include <QTimer>
 #include <QUrl>
-#include <QCandlestickSet>
-#include <QBarCategoryAxis>
-#include <QValueAxis>
-#include <QDateTimeAxis>
 #include <QComboBox>
+#include <QCompleter>
 #include <QDoubleSpinBox>
 #include <QRandomGenerator64>
 #include <QClipboard>
@@ -23,6 +21,7 @@
 
 #include "mainwindow.h"
 #include "./ui_mainwindow.h"
+#include "eventlistdelegate.h"
 
 //My
 #include <TradingCatCommon/appserverprotocol.h>
@@ -30,12 +29,16 @@
 using namespace Common;
 using namespace TradingCatCommon;
 
-constexpr static const int INDEX_ROLE = Qt::UserRole;
-constexpr static const int KLINE_NAME_ROLE = Qt::UserRole + 1;
-
 constexpr static const int MAX_ITEM_COUNT = 10000;
 
-constexpr static const qint64 LAST_DETECT_TIMEOUT = 1000 * 60 * 5; //5min
+constexpr static const qint64 SESSION_RESTORE_TIME_BUDGET = 200; //ms
+constexpr static const qint64 FIRST_SCREEN_TIME_BUDGET = 1000; //ms
+constexpr static const qsizetype CHART_DATA_CACHE_SIZE = 64;
+constexpr static const qsizetype PREFETCH_DEPTH = 2;    ///< количество событий выше и ниже текущего, для которых заранее готовятся данные графиков
+constexpr static const int KEY_REPEAT_DELAY = 60;       //ms
+constexpr static const int COMBOBOX_MIN_CONTENTS_LENGTH = 12;
+constexpr static const qint64 BURST_WINDOW = 5 * 60 * 1000;  ///< максимальный интервал между детектированиями одной серии, мс
+constexpr static const size_t MAX_BURST_HITS = 100;         ///< максимальное количество хранимых детектирований серии
 
 Q_GLOBAL_STATIC_WITH_ARGS(const QString, STOCKEXCHANGE_NAME_ALL, ("ALL"));
 Q_GLOBAL_STATIC_WITH_ARGS(const QString, SYMBOL_NAME_ALL, ("ALL"));
@@ -45,19 +48,47 @@ MainWindow::MainWindow(QWidget *parent /* = nullptr */)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , _localCnf()
+    , _sessionStore()
+    , _chartDataCache(CHART_DATA_CACHE_SIZE)
 {
+    _startTimer.start();
+
     qRegisterMetaType<TradingCatCommon::Detector::KLinesDetectedList>("TradingCatCommon::Detector::KLinesDetectedList");
     qRegisterMetaType<TradingCatCommon::StockExchangesIDList>("TradingCatCommon::StockExchangesIDList");
     qRegisterMetaType<Common::MSG_CODE>("Common::MSG_CODE");
     qRegisterMetaType<TradingCatCommon::UserConfig>("TradingCatCommon::UserConfig");
 
+    _fontLoader = new FontLoader(this);
+
     //UI
     ui->setupUi(this);
 
-    //Set fonts
-    const auto defaultFont = QApplication::font();
-    ui->eventsList->setFont(defaultFont);
-    ui->blackListTableWidget->setFont(defaultFont);
+    _eventListModel = new EventListModel(MAX_ITEM_COUNT, _exchangeRegistry, this);
+    _eventFilterModel = new EventFilterModel(_eventListModel, this);
+    ui->eventsList->setModel(_eventFilterModel);
+    ui->eventsList->setItemDelegate(new EventListDelegate(ui->eventsList));
+
+    _stockExchangeListModel = new StockExchangeListModel(*STOCKEXCHANGE_NAME_ALL, _exchangeRegistry, this);
+    _symbolListModel = new SymbolListModel(*SYMBOL_NAME_ALL, this);
+
+    ui->eventFilterStockExchangeComboBox->setModel(_stockExchangeListModel);
+    ui->eventFilterStockExchangeComboBox->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    ui->eventFilterStockExchangeComboBox->setMinimumContentsLength(COMBOBOX_MIN_CONTENTS_LENGTH);
+
+    _keyRepeatTimer = new QTimer(this);
+    _keyRepeatTimer->setSingleShot(true);
+    _keyRepeatTimer->setInterval(KEY_REPEAT_DELAY);
+    connect(_keyRepeatTimer, SIGNAL(timeout()), SLOT(keyRepeatTimerTimeout()));
+
+    _prefetchTimer = new QTimer(this);
+    _prefetchTimer->setSingleShot(true);
+    _prefetchTimer->setInterval(0);
+    connect(_prefetchTimer, SIGNAL(timeout()), SLOT(prefetchTimerTimeout()));
+
+    appendMessage(EventListModel::EEventType::WAIT, QString("Please wait until you receive new data or change your settings"));
+
+    //шрифт не задается виджетам явно: они наследуют шрифт приложения, к которому FontLoader позже
+    //добавляет резервный CJK шрифт
 
     if (_localCnf.user().isEmpty() || _localCnf.password().isEmpty())
     {
@@ -92,11 +123,20 @@ MainWindow::MainWindow(QWidget *parent /* = nullptr */)
     // UI
     connect(ui->detectorSplitter, SIGNAL(splitterMoved(int, int)),
             SLOT(detectorSplitterSplitterMoved(int, int)));
-    connect(ui->eventsList, SIGNAL(itemClicked(QListWidgetItem *)),
-            SLOT(eventListItemClicked(QListWidgetItem *)));
+    connect(ui->eventsList, SIGNAL(clicked(const QModelIndex&)),
+            SLOT(eventListItemClicked(const QModelIndex&)));
 
     connect(ui->autoscrollCB, SIGNAL(checkStateChanged(Qt::CheckState)),
             SLOT(checkStateChangedAutoScrollCB(Qt::CheckState)));
+    connect(ui->coalesceBurstsCB, SIGNAL(checkStateChanged(Qt::CheckState)),
+            SLOT(checkStateChangedCoalesceBurstsCB(Qt::CheckState)));
+
+    connect(ui->eventFilterSymbolLineEdit, SIGNAL(textChanged(const QString&)), SLOT(eventFilterChanged()));
+    connect(ui->eventFilterStockExchangeComboBox, SIGNAL(currentIndexChanged(int)), SLOT(eventFilterChanged()));
+    connect(ui->eventFilterDeltaSpinBox, SIGNAL(valueChanged(double)), SLOT(eventFilterChanged()));
+    connect(ui->eventFilterVolumeSpinBox, SIGNAL(valueChanged(double)), SLOT(eventFilterChanged()));
+    connect(ui->eventFilterMaxDeltaSpinBox, SIGNAL(valueChanged(double)), SLOT(eventFilterChanged()));
+    connect(ui->eventFilterMaxVolumeSpinBox, SIGNAL(valueChanged(double)), SLOT(eventFilterChanged()));
 
     ui->eventsList->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(ui->eventsList, SIGNAL(customContextMenuRequested(const QPoint&)), SLOT(customContextMenuRequestedEventList(const QPoint&)));
@@ -106,6 +146,12 @@ MainWindow::MainWindow(QWidget *parent /* = nullptr */)
     connect(ui->history1hourPB, SIGNAL(clicked()), SLOT(history1hourPBClicked()));
     connect(ui->history2hoursPB, SIGNAL(clicked()), SLOT(history2hoursPBClicked()));
 
+    ui->historyKLineTypeCB->addItem("1m", static_cast<quint64>(LocalConfig::EHistoryKLineType::MIN1));
+    ui->historyKLineTypeCB->addItem("5m", static_cast<quint64>(LocalConfig::EHistoryKLineType::MIN5));
+    ui->historyKLineTypeCB->addItem("15m", static_cast<quint64>(LocalConfig::EHistoryKLineType::MIN15));
+    ui->historyKLineTypeCB->addItem("1h", static_cast<quint64>(LocalConfig::EHistoryKLineType::H1));
+    connect(ui->historyKLineTypeCB, SIGNAL(currentIndexChanged(int)), SLOT(historyKLineTypeCBCurrentIndexChanged(int)));
+
     connect(ui->reviewHistory2hoursPB, SIGNAL(clicked()), SLOT(reviewHistory2hoursPBClicked()));
     connect(ui->reviewHistory6hoursPB, SIGNAL(clicked()), SLOT(reviewHistory6hoursPBClicked()));
     connect(ui->reviewHistory12hoursPB, SIGNAL(clicked()), SLOT(reviewHistory12hoursPBClicked()));
@@ -125,30 +171,32 @@ MainWindow::MainWindow(QWidget *parent /* = nullptr */)
 
     ui->mainTabWidget->setCurrentIndex(0);
 
-    makeChart();
-    makeReviewChart();
+    //графики, контекстное меню и содержимое вкладок настроек создаются при первом использовании
+
+    _profilerOverlay = new ProfilerOverlay(this);
 
-    _eventListMenu = new EventListMenu(this);
-    _eventListMenu->setVisible(false);
+    _detectJournal = new DetectJournal(this);
+    _detectJournal->open();
 
-    connect(_eventListMenu, SIGNAL(clickedItem(EventListMenu::EMenuItemType, quint64)),
-            SLOT(clickedItemEventListMenu(EventListMenu::EMenuItemType, quint64)));
+    _detectExporter = new DetectExporter(this);
+    connect(_detectExporter, SIGNAL(finished(const QString&, qsizetype)), SLOT(detectExporterFinished(const QString&, qsizetype)));
 
     //start
     QTimer::singleShot(10, this,
                        [this]()
                        {
-                           _reviewChartView->show();
-                           _chartView->show();
-
                            resizeEvent(nullptr);
 
                            setHistoryCountButton(_localCnf.historyKLineCount());
+                           ui->historyKLineTypeCB->setCurrentIndex(ui->historyKLineTypeCB->findData(static_cast<quint64>(_localCnf.historyKLineType())));
                            setReviewHistoryCountButton(_localCnf.reviewHistoryKLineCount());
 
                            ui->autoscrollCB->setChecked(_localCnf.autoScroll());
+                           ui->coalesceBurstsCB->setChecked(_localCnf.coalesceBursts());
+
+                           ui->eventsList->setCurrentIndex(_eventFilterModel->index(0, 0));
 
-                           ui->eventsList->setCurrentRow(0);
+                           restoreSession();
 
                            _networkCore->thread.start();
                        });
@@ -173,67 +221,368 @@ bool MainWindow::keyPress(const EmscriptenKeyboardEvent *keyEvent)
 {
     // qDebug() << "User press key:" << keyEvent->key << "Code:" << keyEvent->keyCode;
 
-    if (keyEvent->keyCode == DOM_VK_UP)
+    if (keyEvent->keyCode == DOM_VK_F2)
+    {
+        _profilerOverlay->toggle();
+
+        return true;
+    }
+
+    //стрелки влево/вправо перемещают по серии только при фокусе на списке, чтобы не мешать вводу в полях фильтра
+    if ((keyEvent->keyCode == DOM_VK_LEFT || keyEvent->keyCode == DOM_VK_RIGHT) && QApplication::focusWidget() == ui->eventsList)
+    {
+        return stepBurstHit(keyEvent->keyCode == DOM_VK_LEFT ? -1 : 1);
+    }
+
+    if (keyEvent->keyCode == DOM_VK_UP || keyEvent->keyCode == DOM_VK_DOWN)
+    {
+        const auto step = keyEvent->keyCode == DOM_VK_UP ? -1 : 1;
+        const auto row = findDetectRow(ui->eventsList->currentIndex().row() + step, step);
+        if (row < 0)
+        {
+            return true;
+        }
+
+        //первое нажатие отображаем сразу. При автоповторе только перемещаем выделение, а графики перестраиваем
+        //для последнего выбранного события после паузы
+        if (!_keyRepeatTimer->isActive())
+        {
+            selectEvent(row);
+        }
+        else
+        {
+            ui->eventsList->setCurrentIndex(_eventFilterModel->index(row, 0));
+            _pendingKLineIndex = _eventFilterModel->record(row).index;
+        }
+
+        _keyRepeatTimer->start();
+
+        return true;
+    }
+
+    return false;
+}
+
+
+void MainWindow::keyRepeatTimerTimeout()
+{
+    if (_pendingKLineIndex == 0)
+    {
+        return;
+    }
+
+    const auto row = _eventFilterModel->row(_pendingKLineIndex);
+    _pendingKLineIndex = 0;
+
+    if (row >= 0)
     {
-        const auto& eventList = ui->eventsList;
-        const auto currentRow = eventList->currentRow();
-        for (int row = currentRow - 1; row >= 0 ; --row)
+        selectEvent(row);
+    }
+}
+
+void MainWindow::prefetchTimerTimeout()
+{
+    if (_currentKLineIndex == 0 || _keyRepeatTimer->isActive() || _chart == nullptr)
+    {
+        return;
+    }
+
+    const auto currentRow = _eventFilterModel->row(_currentKLineIndex);
+    if (currentRow < 0)
+    {
+        return;
+    }
+
+    for (const auto step: {-1, 1})
+    {
+        auto row = currentRow;
+        for (qsizetype depth = 0; depth < PREFETCH_DEPTH; ++depth)
         {
-            const auto item = eventList->item(row);
-            if (!item->data(INDEX_ROLE).isNull())
+            row = findDetectRow(row + step, step);
+            if (row < 0)
             {
-                eventListItemClicked(item);
                 break;
             }
+
+            const auto index = latestBurstHit(_eventFilterModel->record(row).index);
+            const auto it_getKLineDetectData = _getKLineDetectData.find(index);
+            if (it_getKLineDetectData == _getKLineDetectData.end())
+            {
+                break;
+            }
+
+            _chart->prefetch(index, it_getKLineDetectData->second);
+            _reviewChart->prefetch(index, it_getKLineDetectData->second);
         }
+    }
+}
 
-        return true;
+int MainWindow::findDetectRow(int row, int step) const
+{
+    Q_ASSERT(step == 1 || step == -1);
+
+    for (; row >= 0 && row < _eventFilterModel->rowCount(); row += step)
+    {
+        if (_eventFilterModel->record(row).type == EventListModel::EEventType::DETECT)
+        {
+            return row;
+        }
+    }
+
+    return -1;
+}
+
+void MainWindow::eventFilterChanged()
+{
+    EventSearchIndex::Filter filter;
+    filter.symbol = ui->eventFilterSymbolLineEdit->text().trimmed();
+
+    const auto stockExchangeData = ui->eventFilterStockExchangeComboBox->currentData(StockExchangeListModel::STOCK_EXCHANGE_ID_ROLE);
+    if (stockExchangeData.isValid())
+    {
+        filter.stockExchangeId = stockExchangeData.value<InternTable::ID>();
     }
-    else  if (keyEvent->keyCode == DOM_VK_DOWN)
+
+    const auto deltaSpinBox = ui->eventFilterDeltaSpinBox;
+    if (deltaSpinBox->value() > deltaSpinBox->minimum())
     {
-        const auto& eventList = ui->eventsList;
-        const auto currentRow = eventList->currentRow();
-        for (int row = currentRow + 1; row < eventList->count() ; ++row)
+        filter.minDelta = deltaSpinBox->value();
+    }
+
+    //минимальное значение поля верхней границы означает отсутствие ограничения
+    const auto maxDeltaSpinBox = ui->eventFilterMaxDeltaSpinBox;
+    if (maxDeltaSpinBox->value() > maxDeltaSpinBox->minimum())
+    {
+        filter.maxDelta = maxDeltaSpinBox->value();
+    }
+
+    const auto volumeSpinBox = ui->eventFilterVolumeSpinBox;
+    if (volumeSpinBox->value() > volumeSpinBox->minimum())
+    {
+        filter.minVolume = volumeSpinBox->value();
+    }
+
+    const auto maxVolumeSpinBox = ui->eventFilterMaxVolumeSpinBox;
+    if (maxVolumeSpinBox->value() > maxVolumeSpinBox->minimum())
+    {
+        filter.maxVolume = maxVolumeSpinBox->value();
+    }
+
+    //верхняя граница меньше нижней, пока ее число набирается по цифрам. Такая граница не применяется
+    if (filter.maxDelta < filter.minDelta)
+    {
+        filter.maxDelta = std::numeric_limits<double>::max();
+    }
+    if (filter.maxVolume < filter.minVolume)
+    {
+        filter.maxVolume = std::numeric_limits<double>::max();
+    }
+
+    _eventFilterModel->setFilter(filter);
+
+    keepCurrentEventSelected();
+}
+
+void MainWindow::keepCurrentEventSelected()
+{
+    //сохраняем выделение текущего события, если оно прошло фильтр
+    const auto row = _eventFilterModel->row(_currentKLineIndex);
+    if (row >= 0)
+    {
+        ui->eventsList->setCurrentIndex(_eventFilterModel->index(row, 0));
+        ui->eventsList->scrollTo(_eventFilterModel->index(row, 0));
+    }
+}
+
+void MainWindow::eventListItemClicked(const QModelIndex& index)
+{
+    if (!index.isValid())
+    {
+        return;
+    }
+
+    selectEvent(index.row());
+}
+
+void MainWindow::toggleEventGroup(quint64 index)
+{
+    const auto row = _eventListModel->row(index);
+    if (row < 0)
+    {
+        return;
+    }
+
+    const auto groupIndex = _eventListModel->record(row).groupIndex;
+    if (groupIndex == 0)
+    {
+        return;
+    }
+
+    _eventFilterModel->toggleGroup(groupIndex);
+
+    keepCurrentEventSelected();
+}
+
+void MainWindow::exportEvents(DetectExporter::EFormat format)
+{
+    if (_detectExporter->isRunning())
+    {
+        appendMessage(EventListModel::EEventType::NOTICE, "Export is already running");
+
+        return;
+    }
+
+    //выгрузка хранит только указатели на данные событий, сами свечи не копируются
+    DetectExporter::DetectList detected;
+    for (int row = 0; row < _eventListModel->rowCount(); ++row)
+    {
+        const auto& eventRecord = _eventListModel->record(row);
+        if (eventRecord.type != EventListModel::EEventType::DETECT)
         {
-            const auto item = eventList->item(row);
-            if (!item->data(INDEX_ROLE).isNull())
+            continue;
+        }
+
+        //объединенная серия выгружается всеми детектированиями, первое из них - само событие
+        const auto it_burstHits = _burstHits.find(eventRecord.index);
+        const auto hits = it_burstHits != _burstHits.end() ? it_burstHits->second : std::vector<quint64>{eventRecord.index};
+        for (const auto hitIndex: hits)
+        {
+            const auto it_getKLineDetectData = _getKLineDetectData.find(hitIndex);
+            if (it_getKLineDetectData != _getKLineDetectData.end())
             {
-                eventListItemClicked(item);
-                break;
+                detected.push_back(it_getKLineDetectData->second);
             }
         }
+    }
 
-        return true;
+    if (detected.empty())
+    {
+        appendMessage(EventListModel::EEventType::NOTICE, "No events to export");
+
+        return;
     }
 
-    return false;
+    const auto count = detected.size();
+    if (_detectExporter->start(format, std::move(detected)))
+    {
+        appendMessage(EventListModel::EEventType::WAIT, QString("Export of %1 event(s) started").arg(count));
+    }
 }
 
+void MainWindow::detectExporterFinished(const QString &fileName, qsizetype count)
+{
+    appendMessage(EventListModel::EEventType::SUCCESS, QString("Exported %1 event(s) to %2").arg(count).arg(fileName));
+}
 
-void MainWindow::eventListItemClicked(QListWidgetItem *item)
-{  
-    if (item->data(INDEX_ROLE).isNull())
+void MainWindow::selectEvent(int row)
+{
+    const auto& eventRecord = _eventFilterModel->record(row);
+    if (eventRecord.type != EventListModel::EEventType::DETECT)
     {
         return;
     }
 
-    const auto index = item->data(INDEX_ROLE).toULongLong();
+    const auto index = eventRecord.index;
 
     Q_ASSERT(index != 0);
 
-    if (index == _currentKLineIndex)
+    ui->eventsList->setCurrentIndex(_eventFilterModel->index(row, 0));
+
+    //у объединенной серии отображается последнее детектирование
+    const auto hitIndex = latestBurstHit(index);
+    if (index == _currentKLineIndex && hitIndex == _currentHitIndex)
     {
         return;
     }
 
-    const auto& klineData = _getKLineDetectData.at(index);
+    showDetect(eventRecord, hitIndex);
+}
+
+void MainWindow::showDetect(const EventListModel::EventRecord &eventRecord, quint64 hitIndex)
+{
+    const auto& klineData = _getKLineDetectData.at(hitIndex);
+
+    //остальные события группы рисуются поверх свечей события
+    MultiPaneChart::OverlayDetects overlays;
+    const auto it_eventGroups = _eventGroups.find(eventRecord.groupIndex);
+    if (it_eventGroups != _eventGroups.end())
+    {
+        for (const auto groupEventIndex: it_eventGroups->second)
+        {
+            const auto groupHitIndex = latestBurstHit(groupEventIndex);
+            const auto it_getKLineDetectData = _getKLineDetectData.find(groupHitIndex);
+            if (groupEventIndex != eventRecord.index && it_getKLineDetectData != _getKLineDetectData.end())
+            {
+                overlays.emplace_back(groupHitIndex, it_getKLineDetectData->second);
+            }
+        }
+    }
+
+    if (_chart == nullptr)
+    {
+        makeCharts();
+    }
+
+    {
+        Profiler::Scope profilerScope(Profiler::ESection::SHOW_CHART);
+        _chart->setDetect(hitIndex, klineData, overlays);
+    }
+
+    {
+        Profiler::Scope profilerScope(Profiler::ESection::SHOW_REVIEW_CHART);
+        _reviewChart->setDetect(hitIndex, klineData, overlays);
+    }
+
+    _pendingKLineIndex = 0;
+    _prefetchTimer->start();
+
+    _currentKLineIndex = eventRecord.index;
+    _currentHitIndex = hitIndex;
+
+    _sessionStore.setCurrent(klineData);
+}
+
+quint64 MainWindow::latestBurstHit(quint64 index) const
+{
+    const auto it_burstHits = _burstHits.find(index);
+
+    return it_burstHits != _burstHits.end() ? it_burstHits->second.back() : index;
+}
+
+bool MainWindow::stepBurstHit(int step)
+{
+    Q_ASSERT(step == 1 || step == -1);
+
+    const auto it_burstHits = _burstHits.find(_currentKLineIndex);
+    if (it_burstHits == _burstHits.end())
+    {
+        return false;
+    }
+
+    const auto& hits = it_burstHits->second;
+    const auto it_hits = std::find(hits.begin(), hits.end(), _currentHitIndex);
+    if (it_hits == hits.end())
+    {
+        return false;
+    }
+
+    const auto position = std::distance(hits.begin(), it_hits) + step;
+    const auto row = _eventListModel->row(_currentKLineIndex);
+    if (position < 0 || position >= static_cast<qsizetype>(hits.size()) || row < 0)
+    {
+        return true;
+    }
 
-    showChart(klineData->history, klineData->stockExchangeId);
-    showReviewChart(klineData->reviewHistory, klineData->stockExchangeId);
+    showDetect(_eventListModel->record(row), hits[position]);
 
-    ui->eventsList->setCurrentItem(item);
+    return true;
+}
 
-    _currentKLineIndex = index;
+quint64 MainWindow::currentEventIndex() const
+{
+    const auto data = ui->eventsList->currentIndex().data(EventListModel::INDEX_ROLE);
+
+    return data.isNull() ? 0 : data.toULongLong();
 }
 
 void MainWindow::checkStateChangedAutoScrollCB(Qt::CheckState state)
@@ -241,52 +590,68 @@ void MainWindow::checkStateChangedAutoScrollCB(Qt::CheckState state)
     _localCnf.setAutoScroll(state == Qt::Checked);
 }
 
+void MainWindow::checkStateChangedCoalesceBurstsCB(Qt::CheckState state)
+{
+    //уже добавленные строки не перестраиваются, настройка действует на новые детектирования
+    _localCnf.setCoalesceBursts(state == Qt::Checked);
+}
+
 void MainWindow::historyMaxPBClicked()
 {
     setHistoryCountButton(LocalConfig::EHistoryKLineCount::MAX);
-    updateHistoryChart(_currentKLineIndex);
 }
 
 void MainWindow::history30minPBClicked()
 {
     setHistoryCountButton(LocalConfig::EHistoryKLineCount::MIN30);
-    updateHistoryChart(_currentKLineIndex);
 }
 
 void MainWindow::history1hourPBClicked()
 {
     setHistoryCountButton(LocalConfig::EHistoryKLineCount::H1);
-    updateHistoryChart(_currentKLineIndex);
 }
 
 void MainWindow::history2hoursPBClicked()
 {
     setHistoryCountButton(LocalConfig::EHistoryKLineCount::H2);
-    updateHistoryChart(_currentKLineIndex);
+}
+
+void MainWindow::historyKLineTypeCBCurrentIndexChanged(int index)
+{
+    if (index < 0)
+    {
+        return;
+    }
+
+    _viewKLineType = static_cast<LocalConfig::EHistoryKLineType>(ui->historyKLineTypeCB->itemData(index).toULongLong());
+
+    //история события в свечах выбранного интервала кэшируется, поэтому повторное переключение не пересчитывает свечи
+    if (_chart != nullptr)
+    {
+        _chart->setPaneKLinesDuration(0, static_cast<qint64>(_viewKLineType));
+    }
+
+    _localCnf.setHistoryKLineType(_viewKLineType);
 }
 
 void MainWindow::reviewHistory2hoursPBClicked()
 {
     setReviewHistoryCountButton(LocalConfig::EReviewHistoryKLineCount::H2);
-    updateReviewHistoryChart(_currentKLineIndex);
 }
 
 void MainWindow::reviewHistory6hoursPBClicked()
 {
     setReviewHistoryCountButton(LocalConfig::EReviewHistoryKLineCount::H6);
-    updateReviewHistoryChart(_currentKLineIndex);
 }
 
 void MainWindow::reviewHistory12hoursPBClicked()
 {
     setReviewHistoryCountButton(LocalConfig::EReviewHistoryKLineCount::H12);
-    updateReviewHistoryChart(_currentKLineIndex);
 }
 
 void MainWindow::reviewHistoryMaxPBClicked()
 {
     setReviewHistoryCountButton(LocalConfig::EReviewHistoryKLineCount::MAX);
-    updateReviewHistoryChart(_currentKLineIndex);
 }
 
 void MainWindow::detectorSplitterSplitterMoved(int pos, int index)
@@ -300,6 +665,8 @@ void MainWindow::detectorSplitterSplitterMoved(int pos, int index)
 void MainWindow::addPushButtonClicked()
 {
     addFilterRow(QString(), 5.0, 1000.0);
+
+    filterTablesChanged();
 }
 
 void MainWindow::removePushButtonClicked()
@@ -308,11 +675,15 @@ void MainWindow::removePushButtonClicked()
     filterTable->removeRow(filterTable->currentRow());
 
     showRemovePushButton();
+
+    filterTablesChanged();
 }
 
 void MainWindow::addBlackListPushButtonClicked()
 {
     addBlackListRow(QString(), KLineID());
+
+    filterTablesChanged();
 }
 
 void MainWindow::removeBlackListPushButtonClicked()
@@ -321,18 +692,28 @@ void MainWindow::removeBlackListPushButtonClicked()
     blackListTable->removeRow(blackListTable->currentRow());
 
     showRemoveBlackListPushButton();
+
+    filterTablesChanged();
 }
 
 void MainWindow::customContextMenuRequestedEventList(const QPoint &pos)
 {
-    Q_CHECK_PTR(_eventListMenu);
-
-    const auto& eventList = ui->eventsList;
-    const auto item = eventList->currentItem();
-    const auto data = item->data(INDEX_ROLE);
-    if (!data.isNull())
+    const auto index = currentEventIndex();
+    if (index != 0)
     {
-        _eventListMenu->open(ui->eventsList->mapToGlobal(pos), data.toULongLong());
+        if (_eventListMenu == nullptr)
+        {
+            _eventListMenu = new EventListMenu(this);
+            _eventListMenu->setVisible(false);
+
+            connect(_eventListMenu, SIGNAL(clickedItem(EventListMenu::EMenuItemType, quint64)),
+                    SLOT(clickedItemEventListMenu(EventListMenu::EMenuItemType, quint64)));
+        }
+
+        const auto row = _eventListModel->row(index);
+        const auto isGroup = row >= 0 && _eventListModel->record(row).groupIndex != 0;
+
+        _eventListMenu->open(ui->eventsList->mapToGlobal(pos), index, isGroup);
     }
 }
 
@@ -340,16 +721,37 @@ void MainWindow::clickedItemEventListMenu(EventListMenu::EMenuItemType type, qui
 {
     //qDebug() << "Event list menu clicked" << static_cast<quint8>(type) << "Index" << index;
 
+    //выгружается весь список, поэтому выгрузка не зависит от того, есть ли еще данные выбранного события
+    if (type == EventListMenu::EMenuItemType::EXPORT_CSV || type == EventListMenu::EMenuItemType::EXPORT_COLUMNAR)
+    {
+        exportEvents(type == EventListMenu::EMenuItemType::EXPORT_CSV ? DetectExporter::EFormat::CSV : DetectExporter::EFormat::COLUMNAR);
+
+        return;
+    }
+
     const auto it_getKLineDetectData = _getKLineDetectData.find(index);
     if (it_getKLineDetectData == _getKLineDetectData.end())
     {
         return;
     }
 
+    //группа переключается без построения вкладки черного списка
+    if (type == EventListMenu::EMenuItemType::TOGGLE_GROUP)
+    {
+        toggleEventGroup(index);
+
+        return;
+    }
+
     const auto& klineData = it_getKLineDetectData->second;
     const auto& klineId = klineData->history->front()->id;
     const auto& stockExchangeId = klineData->stockExchangeId;
 
+    if (!_isBlackListTabBuilt)
+    {
+        makeBlackListTab();
+    }
+
     switch (type)
     {
     case EventListMenu::EMenuItemType::ADD_BLACK_LIST:
@@ -367,236 +769,167 @@ void MainWindow::clickedItemEventListMenu(EventListMenu::EMenuItemType type, qui
 
 void MainWindow::mainTabWidgetCurrentChanged(int index)
 {
-    if (index != 0 || !_login)
+    Profiler::Scope profilerScope(Profiler::ESection::MAIN_TAB_CHANGED);
+
+    const auto tab = ui->mainTabWidget->widget(index);
+
+    //статистика не зависит от подключения к серверу
+    if (tab == ui->statisticsTab && _statisticsWidget == nullptr)
+    {
+        _statisticsWidget = new StatisticsWidget(_detectStatistics, _exchangeRegistry, ui->statisticsTab);
+        ui->statisticsLayout->addWidget(_statisticsWidget);
+
+        Profiler::instance().mark("statisticsTabBuilt");
+    }
+
+    //журнал читается из IndexedDB и тоже не зависит от подключения к серверу
+    if (tab == ui->journalTab && _journalWidget == nullptr)
+    {
+        _journalWidget = new JournalWidget(*_detectJournal, _exchangeRegistry, ui->journalTab);
+        ui->journalLayout->addWidget(_journalWidget);
+
+        Profiler::instance().mark("journalTabBuilt");
+    }
+
+    if (!_login)
     {
         return;
     }
 
+    if (tab == ui->filterTab && !_isFilterTabBuilt)
+    {
+        makeFilterTab();
+    }
+    else if (tab == ui->blackListTab && !_isBlackListTabBuilt)
+    {
+        makeBlackListTab();
+    }
+
+    if (index != 0 || !updateUserConfig())
+    {
+        return;
+    }
+
+    emit updateConfig(_userConfig);
+}
+
+bool MainWindow::updateUserConfig()
+{
+    //настройки могли измениться только в таблицах, которые уже открывались
+    if (!_isFilterTabBuilt && !_isBlackListTabBuilt)
+    {
+        return false;
+    }
+
+    const auto filter = _userConfig.filter();
     _userConfig.clearFilter();
+
     const auto& filterTableWidget = ui->filterTableWidget;
-    for (int row = 0; row < filterTableWidget->rowCount(); ++row)
+    if (!_isFilterTabBuilt)
+    {
+        for (const auto& filterData: filter.klineFilter())
+        {
+            _userConfig.addFilterData(KLineFilterData(filterData));
+        }
+    }
+    else
     {
-        KLineFilterData tmp;
+        for (int row = 0; row < filterTableWidget->rowCount(); ++row)
+        {
+            KLineFilterData tmp;
+
+            const auto stockExchangeName = static_cast<QComboBox*>(filterTableWidget->cellWidget(row, 0))->currentData(StockExchangeListModel::STOCK_EXCHANGE_NAME_ROLE).toString();
+            if (stockExchangeName != *STOCKEXCHANGE_NAME_ALL)
+            {
+                tmp.setStockExchangeID(StockExchangeID(stockExchangeName));
+            }
+
+            tmp.setDelta(static_cast<QDoubleSpinBox*>(filterTableWidget->cellWidget(row, 1))->value());
+            tmp.setVolume(static_cast<QDoubleSpinBox*>(filterTableWidget->cellWidget(row, 2))->value());
+
+            _userConfig.addFilterData(std::move(tmp));
+        }
+    }
 
-        const auto stockExchangeName = static_cast<QComboBox*>(filterTableWidget->cellWidget(row, 0))->currentText();
-        if (stockExchangeName != *STOCKEXCHANGE_NAME_ALL)
+    const auto& blackListTabletWidget = ui->blackListTableWidget;
+    if (!_isBlackListTabBuilt)
+    {
+        for (const auto& blackListData: filter.blackList())
         {
-            tmp.setStockExchangeID(StockExchangeID(stockExchangeName));
+            _userConfig.addBlackListData(BlackListFilterData(blackListData));
         }
+    }
+    else
+    {
+        for (int row = 0; row < blackListTabletWidget->rowCount(); ++row)
+        {
+            BlackListFilterData tmp;
+
+            const auto stockExchangeName = static_cast<QComboBox*>(blackListTabletWidget->cellWidget(row, 0))->currentData(StockExchangeListModel::STOCK_EXCHANGE_NAME_ROLE).toString();
+            if (stockExchangeName != *STOCKEXCHANGE_NAME_ALL)
+            {
+                tmp.setStockExchangeID(StockExchangeID(stockExchangeName));
+            }
 
-        tmp.setDelta(static_cast<QDoubleSpinBox*>(filterTableWidget->cellWidget(row, 1))->value());
-        tmp.setVolume(static_cast<QDoubleSpinBox*>(filterTableWidget->cellWidget(row, 2))->value());
+            const auto symbol = static_cast<QComboBox*>(blackListTabletWidget->cellWidget(row, 1))->currentData().toString();
+            if (symbol != *SYMBOL_NAME_ALL)
+            {
+                tmp.setKLineID(KLineID(symbol, KLineType::MIN1));
+            }
 
-        _userConfig.addFilterData(std::move(tmp));
+            _userConfig.addBlackListData(std::move(tmp));
+        }
     }
 
-    const auto& blackListTabletWidget = ui->blackListTableWidget;
-    for (int row = 0; row < blackListTabletWidget->rowCount(); ++row)
-    {
-        BlackListFilterData tmp;
+    applyDetectRules();
 
-        const auto stockExchangeName = static_cast<QComboBox*>(blackListTabletWidget->cellWidget(row, 0))->currentText();
-        if (stockExchangeName != *STOCKEXCHANGE_NAME_ALL)
-        {
-            tmp.setStockExchangeID(StockExchangeID(stockExchangeName));
-        }
+    return true;
+}
 
-        const auto symbol = static_cast<QComboBox*>(blackListTabletWidget->cellWidget(row, 1))->currentData().toString();
-        if (symbol != *SYMBOL_NAME_ALL)
-        {
-            tmp.setKLineID(KLineID(symbol, KLineType::MIN1));
-        }
+void MainWindow::applyDetectRules()
+{
+    _eventFilterModel->setRules(DetectRules(_userConfig));
 
-        _userConfig.addBlackListData(std::move(tmp));
-    }
+    keepCurrentEventSelected();
+}
 
-    emit updateConfig(_userConfig);
+void MainWindow::filterTablesChanged()
+{
+    updateUserConfig();
 }
 
-void MainWindow::makeChart()
-{
-    //Chart
-    _series = new QCandlestickSeries;
-    _series->setIncreasingColor(QColor(Qt::green));
-    _series->setDecreasingColor(QColor(Qt::red));
-    _series->setBodyOutlineVisible(true);
-    _series->setBodyWidth(0.7);
-    _series->setCapsVisible(true);
-    _series->setCapsWidth(0.5);
-    _series->setMinimumColumnWidth(-1.0);
-    _series->setMaximumColumnWidth(50.0);
-    _series->setUseOpenGL(true);
-    auto pen = _series->pen();
-    pen.setColor(Qt::white);
-    _series->setPen(pen);
-
-    _seriesVolume = new QCandlestickSeries;
-    _seriesVolume->setIncreasingColor(QColor(61, 56, 70));
-    _seriesVolume->setDecreasingColor(QColor(61, 56, 70));
-    _seriesVolume->setBodyOutlineVisible(true);
-    _seriesVolume->setCapsVisible(true);
-    _seriesVolume->setMinimumColumnWidth(-1.0);
-    _seriesVolume->setMaximumColumnWidth(50.0);
-    _seriesVolume->setCapsWidth(0.3);
-    _seriesVolume->setBodyWidth(0.5);
-    _seriesVolume->setUseOpenGL(true);
-    _seriesVolume->setPen(pen);
-
-    auto chart = new QChart;
-    chart->setFont(QApplication::font());
-    chart->addSeries(_seriesVolume);
-    chart->addSeries(_series);
-    chart->setTitle("No data");
-//    chart->setAnimationOptions(QChart::SeriesAnimations);
-    chart->setBackgroundBrush(QBrush(QColor(36, 31, 49)));
-    auto titleFont = chart->titleFont();
-    titleFont.setPointSize(20);
-    chart->setTitleFont(titleFont);
-    chart->legend()->setVisible(false);
-    chart->setTitle("No data");
-    chart->setMargins({0,0,0,0});
-
-    auto axisX = new QDateTimeAxis;
-    axisX->setTickCount(3);
-    axisX->setFormat("hh:mm");
-    axisX->setGridLineVisible(false);
-    axisX->setLabelsColor(Qt::white);
-    auto axisXLabelsFont = axisX->labelsFont();
-    axisXLabelsFont.setPixelSize(12);
-    axisX->setLabelsFont(axisXLabelsFont);
-
-    chart->addAxis(axisX, Qt::AlignBottom);
-
-    _series->attachAxis(axisX);
-    _seriesVolume->attachAxis(axisX);
-
-    auto axisY = new QValueAxis();
-    axisY->setGridLineVisible(true);
-    axisY->setGridLineColor(QColor(94, 92, 100));
-    auto axisYGridLinePen = axisY->gridLinePen();
-    axisYGridLinePen.setStyle(Qt::DotLine);
-    axisY->setGridLinePen(axisYGridLinePen);
-    axisY->setLabelsColor(Qt::white);
-    auto axisYLabelsFont = axisY->labelsFont();
-    axisYLabelsFont.setPixelSize(12);
-    axisY->setLabelsFont(axisYLabelsFont);
-
-    chart->addAxis(axisY, Qt::AlignRight);
-
-    _series->attachAxis(axisY);
-
-    auto axisY2 = new QValueAxis();
-    axisY2->setGridLineVisible(false);
-    axisY2->setLabelsVisible(false);
-
-    chart->addAxis(axisY2, Qt::AlignLeft);
-
-    _seriesVolume->attachAxis(axisY2);
-
-    _chartView = new QChartView(chart, ui->chartFrame);
-    _chartView->resize(ui->chartFrame->size());
-    _chartView->show();
-}
-
-void MainWindow::makeReviewChart()
-{
-    //ReviewChart
-    _reviewSeries = new QCandlestickSeries;
-    _reviewSeries->setIncreasingColor(QColor(Qt::green));
-    _reviewSeries->setDecreasingColor(QColor(Qt::red));
-    _reviewSeries->setBodyOutlineVisible(true);
-    _reviewSeries->setBodyWidth(0.5);
-    _reviewSeries->setMinimumColumnWidth(-1.0);
-    _reviewSeries->setMaximumColumnWidth(50.0);
-    _reviewSeries->setCapsVisible(true);
-    _reviewSeries->setCapsWidth(0.3);
-    _reviewSeries->setUseOpenGL(true);
-    auto pen = _series->pen();
-    pen.setWidth(1);
-    pen.setColor(Qt::white);
-    _reviewSeries->setPen(pen);
-
-    _reviewSeriesVolume = new QCandlestickSeries;
-    _reviewSeriesVolume->setIncreasingColor(QColor(61, 56, 70));
-    _reviewSeriesVolume->setDecreasingColor(QColor(61, 56, 70));
-    _reviewSeriesVolume->setBodyOutlineVisible(true);
-    _reviewSeriesVolume->setCapsVisible(true);
-    _reviewSeriesVolume->setMinimumColumnWidth(-1.0);
-    _reviewSeriesVolume->setMaximumColumnWidth(50.0);
-    _reviewSeriesVolume->setCapsWidth(0.3);
-    _reviewSeriesVolume->setBodyWidth(0.5);
-    _reviewSeriesVolume->setUseOpenGL(true);
-    _reviewSeriesVolume->setPen(pen);
-
-    auto chart = new QChart;
-    chart->setFont(QApplication::font());
-    chart->addSeries(_reviewSeriesVolume);
-    chart->addSeries(_reviewSeries);
-//    chart->setAnimationOptions(QChart::SeriesAnimations);
-    chart->setBackgroundBrush(QBrush(QColor(36, 31, 49)));
-    auto titleFont = chart->titleFont();
-    titleFont.setPointSize(20);
-    chart->setTitleFont(titleFont);
-    chart->legend()->setVisible(false);
-    chart->setTitle("No data");
-    chart->setMargins({0,0,0,0});
-
-    auto axisX = new QDateTimeAxis;
-    axisX->setTickCount(3);
-    axisX->setFormat("hh:mm");
-    axisX->setGridLineVisible(false);
-    axisX->setLabelsColor(Qt::white);
-    auto axisXLabelsFont = axisX->labelsFont();
-    axisXLabelsFont.setPixelSize(12);
-    axisX->setLabelsFont(axisXLabelsFont);
-
-    chart->addAxis(axisX, Qt::AlignBottom);
-
-    _reviewSeries->attachAxis(axisX);
-    _reviewSeriesVolume->attachAxis(axisX);
-
-    auto axisY = new QValueAxis();
-    axisY->setGridLineVisible(true);
-    axisY->setGridLineColor(QColor(94, 92, 100));
-    auto axisYGridLinePen = axisY->gridLinePen();
-    axisYGridLinePen.setStyle(Qt::DotLine);
-    axisY->setGridLinePen(axisYGridLinePen);
-    axisY->setLabelsColor(Qt::white);
-    auto axisYLabelsFont = axisY->labelsFont();
-    axisYLabelsFont.setPixelSize(12);
-    axisY->setLabelsFont(axisYLabelsFont);
-
-    chart->addAxis(axisY, Qt::AlignRight);
-
-    _reviewSeries->attachAxis(axisY);
-
-    auto axisY2 = new QValueAxis();
-    axisY2->setGridLineVisible(false);
-    axisY2->setLabelsVisible(false);
-
-    chart->addAxis(axisY2, Qt::AlignLeft);
-
-    _reviewSeriesVolume->attachAxis(axisY2);
-
-    _reviewChartView = new QChartView(chart, ui->reviewChartFrame);
-    _reviewChartView->resize(ui->reviewChartFrame->size());
-    _reviewChartView->show();
+void MainWindow::makeCharts()
+{
+    Q_ASSERT(_chart == nullptr && _reviewChart == nullptr);
+
+    _chart = new MultiPaneChart(_chartDataCache, ui->chartFrame);
+    _chart->addPane(ChartDataCache::ESource::HISTORY, {0.7, true, {true, true, true, true}}, static_cast<qsizetype>(_viewCount));
+    _chart->setPaneKLinesDuration(0, static_cast<qint64>(_viewKLineType));
+    _chart->resize(ui->chartFrame->size());
+    _chart->show();
+
+    _reviewChart = new MultiPaneChart(_chartDataCache, ui->reviewChartFrame);
+    _reviewChart->addPane(ChartDataCache::ESource::REVIEW, {0.5, false, {true, false, false, false}}, static_cast<qsizetype>(_reviewCount));
+    _reviewChart->resize(ui->reviewChartFrame->size());
+    _reviewChart->show();
+
+    Profiler::instance().mark("chartsCreated");
 }
 
 void MainWindow::resizeEvent(QResizeEvent *event)
 {
     Q_UNUSED(event);
 
-    if (_chartView != nullptr)
+    Profiler::Scope profilerScope(Profiler::ESection::RESIZE);
+
+    if (_chart != nullptr)
     {
-        _chartView->resize(ui->chartFrame->size());
-        _chartView->update();
+        _chart->resize(ui->chartFrame->size());
     }
 
-    if (_reviewChartView != nullptr)
+    if (_reviewChart != nullptr)
     {
-        _reviewChartView->resize(ui->reviewChartFrame->size());
-        _reviewChartView->update();
+        _reviewChart->resize(ui->reviewChartFrame->size());
     }
 
     _localCnf.setSplitterPos(ui->detectorSplitter->saveState());
@@ -604,16 +937,12 @@ void MainWindow::resizeEvent(QResizeEvent *event)
 
 bool MainWindow::eventFilter(QObject *watched, QEvent *event)
 {
-    Q_CHECK_PTR(_eventListMenu);
-
     if (event->type() == QEvent::MouseButtonDblClick)
     {
-        const auto& eventList = ui->eventsList;
-        const auto item = eventList->currentItem();
-        const auto data = item->data(INDEX_ROLE);
-        if (!data.isNull())
+        const auto index = currentEventIndex();
+        if (index != 0)
         {
-            const auto& detect = _getKLineDetectData.at(data.toULongLong());
+            const auto& detect = _getKLineDetectData.at(index);
             const auto& klineId = detect->history->front()->id;
 
             auto clipboard = QApplication::clipboard();
@@ -627,7 +956,7 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
 
     if (event->type() == QEvent::MouseButtonPress)
     {
-        if (!_eventListMenu->isHidden())
+        if (_eventListMenu != nullptr && !_eventListMenu->isHidden())
         {
             QTimer::singleShot(10, this, [this](){ _eventListMenu->close(); });
         }
@@ -640,19 +969,22 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
 void MainWindow::loginNetworkCore(const TradingCatCommon::UserConfig &userConfig)
 {
     _userConfig = userConfig;
+
+    applyDetectRules();
 }
 
 void MainWindow::logoutNetworkCore()
 {
-    auto item = new QListWidgetItem(QString("Logout. Try to reconnection to server"));
-    item->setIcon(QIcon(":/icon/img/error.ico"));
-    item->setFlags(Qt::ItemFlag::ItemIsEnabled);
-    ui->eventsList->addItem(item);
+    appendMessage(EventListModel::EEventType::FAIL, QString("Logout. Try to reconnection to server"));
 
     clearFilterTab();
     clearBlackListTab();
 
     _stockExchengeData.clear();
+    _stockExchangeSymbols.clear();
+    _symbolListModel->clear();
+    _stockExchangeListModel->clear();
+    _exchangeRegistry.clear();
 
     _login = false;  
 }
@@ -661,24 +993,68 @@ void MainWindow::klineDetectNetworkCore(const TradingCatCommon::Detector::KLines
 {
     Q_ASSERT(!detectData.detected.empty());
 
-    QListWidgetItem* item = nullptr;
+    Profiler::Scope profilerScope(Profiler::ESection::KLINE_DETECT);
+
+    const auto isCoalesceBursts = ui->coalesceBurstsCB->isChecked();
+
+    std::vector<EventListModel::EventRecord> records;
+    records.reserve(detectData.detected.size() + 1);
+    bool isGrouped = false;
+    quint64 lastIndex = 0;
     for (const auto& detect: detectData.detected)
     {
-        item = addDetectToEventList(detect);
+        auto record = makeDetectRecord(detect);
+        _detectStatistics.add(record.stockExchangeId, record.symbolId, record.delta, record.volume, record.time);
+
+        //событие кодируется один раз для обоих хранилищ
+        const auto detectRecord = SessionStore::encode(detect);
+        _sessionStore.append(detectRecord);
+        _detectJournal->append(detect, detectRecord);
+
+        //повтор серии не добавляет строку и не участвует в группах бирж: биржа события серии уже учтена
+        const auto burstIndex = isCoalesceBursts ? coalesceBurst(records, record) : 0;
+        if (burstIndex != 0)
+        {
+            lastIndex = burstIndex;
+
+            continue;
+        }
+
+        lastIndex = record.index;
+        records.push_back(std::move(record));
+
+        const auto& newRecord = records.back();
+        const auto groupIndex = _correlationGrouper.add(newRecord.index, newRecord.stockExchangeId, newRecord.symbolId, newRecord.time);
+        if (groupIndex != 0 && addToGroup(records, groupIndex))
+        {
+            isGrouped = true;
+        }
     }
 
-    Q_CHECK_PTR(item);
+    Q_ASSERT(lastIndex != 0);
 
     if (detectData.isFull)
     {
-        auto item = new QListWidgetItem(QString("There are too many detections. Some events were skipped"));
-        item->setFlags(Qt::ItemFlag::ItemIsEnabled);
-        ui->eventsList->addItem(item);
+        records.push_back(_eventListModel->makeMessage(EventListModel::EEventType::NOTICE, QString("There are too many detections. Some events were skipped")));
+    }
+
+    //группы сворачиваются с появлением группы и разворачиваются с вытеснением последней (forgetEvents()),
+    //чтобы без групп список не проходил через фильтр
+    if (isGrouped && !_eventFilterModel->isCollapseGroups())
+    {
+        _eventFilterModel->setCollapseGroups(true);
+        keepCurrentEventSelected();
     }
 
+    appendEvents(std::move(records));
+
     if (ui->autoscrollCB->isChecked())
     {
-        eventListItemClicked(item);
+        const auto row = _eventFilterModel->row(lastIndex);
+        if (row >= 0)
+        {
+            selectEvent(row);
+        }
 
         ui->eventsList->scrollToBottom();
     }
@@ -687,9 +1063,15 @@ void MainWindow::klineDetectNetworkCore(const TradingCatCommon::Detector::KLines
 void MainWindow::stockExchangesNetworkCore(const TradingCatCommon::StockExchangesIDList& stockExchangesIdList)
 {
     _stockExchengeData.clear();
+    _stockExchangeSymbols.clear();
+
+    _exchangeRegistry.update(stockExchangesIdList);
+    _stockExchangeListModel->update();
+
+    auto& internTable = InternTable::instance();
     for (const auto& stockExchnageId: stockExchangesIdList)
     {
-        _stockExchengeData.emplace(stockExchnageId, std::make_shared<TradingCatCommon::KLinesIDList>());
+        _stockExchengeData.emplace(internTable.stockExchange(stockExchnageId), std::make_shared<TradingCatCommon::KLinesIDList>());
     }
 
     //далее ждем данных о доступных свечах
@@ -697,10 +1079,13 @@ void MainWindow::stockExchangesNetworkCore(const TradingCatCommon::StockExchange
 
 void MainWindow::klinesIdListNetworkCore(const TradingCatCommon::StockExchangeID &stockExchangesId, const TradingCatCommon::PKLinesIDList &klinesIdList)
 {
-    Q_ASSERT(_stockExchengeData.contains(stockExchangesId));
     Q_CHECK_PTR(klinesIdList);
 
-    auto it_stockExchengeData = _stockExchengeData.find(stockExchangesId);
+    auto& internTable = InternTable::instance();
+
+    auto it_stockExchengeData = _stockExchengeData.find(internTable.stockExchange(stockExchangesId));
+    Q_ASSERT(it_stockExchengeData != _stockExchengeData.end());
+
     if (!klinesIdList->empty())
     {
         it_stockExchengeData->second = klinesIdList;
@@ -712,29 +1097,62 @@ void MainWindow::klinesIdListNetworkCore(const TradingCatCommon::StockExchangeID
         it_stockExchengeData->second = tmp;
     }
 
-    qDebug() << "Add stockExhange" << stockExchangesId.toString() << klinesIdList->size();
-    // выполняем логин, как только данные по всем биржам получены
-    if (!_login)
+    //интернируем символы один раз при загрузке списка свечей и сразу исключаем повторы
+    std::vector<bool> isSymbolExists(internTable.symbolsCount(), false);
+    for (const auto symbolId: _stockExchangeSymbols)
     {
-        const auto& isAll = std::all_of(_stockExchengeData.begin(), _stockExchengeData.end(),
-                                        [](const auto& item)
-                                        {
-                                            return !item.second->empty();
-                                        });
+        isSymbolExists[symbolId] = true;
+    }
 
-        if (isAll)
+    for (const auto& klineId: *it_stockExchengeData->second)
+    {
+        if (klineId.type != TradingCatCommon::KLineType::MIN1)
         {
-            auto item = new QListWidgetItem(QString("Login successfully as: %1").arg(_localCnf.user()));
-            item->setIcon(QIcon(":/image/img/ok.png"));
-            item->setFlags(Qt::ItemFlag::ItemIsEnabled);
-            ui->eventsList->addItem(item);
+            continue;
+        }
 
-            _login = true;
+        const auto symbolId = internTable.symbol(klineId.symbol);
+        if (symbolId >= isSymbolExists.size())
+        {
+            isSymbolExists.resize(symbolId + 1, false);
+        }
+        if (!isSymbolExists[symbolId])
+        {
+            isSymbolExists[symbolId] = true;
+            _stockExchangeSymbols.push_back(symbolId);
 
-            makeFilterTab();
-            makeBlackListTab();
+            if (!_fontLoader->isLoaded() && FontLoader::isNonLatin(internTable.symbolName(symbolId)))
+            {
+                _fontLoader->load();
+            }
         }
     }
+
+    qDebug() << "Add stockExhange" << stockExchangesId.toString() << klinesIdList->size();
+
+    const auto& isAll = std::all_of(_stockExchengeData.begin(), _stockExchengeData.end(),
+                                    [](const auto& item)
+                                    {
+                                        return !item.second->empty();
+                                    });
+    if (!isAll)
+    {
+        return;
+    }
+
+    //каталог символов перестраивается один раз, когда получены данные по всем биржам
+    _symbolListModel->setSymbols(_stockExchangeSymbols);
+
+    // выполняем логин, как только данные по всем биржам получены
+    if (!_login)
+    {
+        appendMessage(EventListModel::EEventType::SUCCESS, QString("Login successfully as: %1").arg(_localCnf.user()));
+
+        _login = true;
+
+        //содержимое вкладок настроек строится при первом открытии вкладки
+        mainTabWidgetCurrentChanged(ui->mainTabWidget->currentIndex());
+    }
 }
 
 void MainWindow::sendLogMsgNetworkCore(Common::MSG_CODE category, const QString &msg)
@@ -770,247 +1188,235 @@ void MainWindow::sendLogMsg(MSG_CODE category, const QString &msg)
     }
 }
 
-void MainWindow::showChart(const TradingCatCommon::PKLinesList &klinesData, const TradingCatCommon::StockExchangeID &stockExchangeID)
+EventListModel::EventRecord MainWindow::makeDetectRecord(const TradingCatCommon::Detector::PKLineDetectData &detectData)
 {
-    Q_CHECK_PTR(_series);
-    Q_CHECK_PTR(_chartView);
+    Q_ASSERT(!detectData->history->empty());
+    Q_ASSERT(!detectData->reviewHistory->empty());
+    Q_ASSERT(!detectData->stockExchangeId.isEmpty());
 
-    Q_ASSERT(!klinesData->empty());
-    Q_ASSERT(!stockExchangeID.isEmpty());
+    const auto& kline = detectData->history->front();
 
-    const auto& firstKLine = klinesData->front();
-    auto& lastKLine = klinesData->back();
-    const auto& klineId = firstKLine->id;
+    qInfo() << "Detect:" << detectData->msg;
 
-    _chartView->chart()->setTitle(QString("%1: %2 %3")
-                                      .arg(stockExchangeID.name)
-                                      .arg(klineId.symbol.name)
-                                      .arg(KLineTypeToString(klineId.type)));
+    auto& internTable = InternTable::instance();
 
-    float max = std::numeric_limits<float>::min();
-    float min = std::numeric_limits<float>::max();
-    float maxVolume = std::numeric_limits<float>::min();
+    EventListModel::EventRecord eventRecord;
+    eventRecord.index = _eventListModel->nextIndex();
+    eventRecord.type = EventListModel::EEventType::DETECT;
+    eventRecord.time = kline->closeTime;
+    eventRecord.delta = detectData->delta;
+    eventRecord.volume = detectData->volume;
+    eventRecord.stockExchangeId = internTable.stockExchange(detectData->stockExchangeId);
+    eventRecord.symbolId = internTable.symbol(kline->id.symbol);
 
-    quint64 index = 0;
-    const auto count = static_cast<quint64>(_viewCount);
-    QList<QCandlestickSet*> candlestickList;
-    candlestickList.reserve(count);
-    QList<QCandlestickSet*> candlestickVolumeList;
-    candlestickVolumeList.reserve(count);
-    for (const auto& kline: *klinesData)
+    if (!_fontLoader->isLoaded() && FontLoader::isNonLatin(internTable.symbolName(eventRecord.symbolId)))
     {
-        if (index >= count)
-        {
-            break;
-        }
-
-        ++index;
-
-        {
-            auto candlestick = new QCandlestickSet(kline->closeTime);
-            candlestick->setHigh(kline->high);
-            candlestick->setLow(kline->low);
-            candlestick->setOpen(kline->open);
-            candlestick->setClose(kline->open != kline->close ? kline->close : kline->close + 0.001 * kline->close);
-            auto pen = _series->pen();
-            pen.setColor(kline->open <= kline->close ? QColor(Qt::green) : QColor(Qt::red));
-            candlestick->setPen(pen);
-
-            candlestickList.push_back(candlestick);
-        }
-
-        {
-            auto candlestickVolume = new QCandlestickSet(kline->closeTime);
-            candlestickVolume->setOpen(kline->volume);
-            candlestickVolume->setHigh(kline->volume);
-            candlestickVolume->setLow(0);
-            candlestickVolume->setClose(0);
-            auto penVolume = _seriesVolume->pen();
-            penVolume.setColor(QColor(61, 56, 70));
-            candlestickVolume->setPen(penVolume);
-
-            candlestickVolumeList.push_back(candlestickVolume);
-        }
-
-        max = std::max(max, kline->high);
-        min = std::min(min, kline->low);
-        maxVolume = std::max(maxVolume, kline->volume);
-
-        lastKLine = kline;
+        _fontLoader->load();
     }
+    eventRecord.isIncrease = kline->open <= kline->close;
 
-    _chartView->hide();
-
-    auto axisX = qobject_cast<QDateTimeAxis*>(_chartView->chart()->axes(Qt::Horizontal).at(0));
-    axisX->setMax(QDateTime::fromMSecsSinceEpoch(firstKLine->closeTime + static_cast<qint64>(klineId.type) * 5));
-    axisX->setMin(QDateTime::fromMSecsSinceEpoch(lastKLine->closeTime - static_cast<qint64>(klineId.type)));
-    axisX->setTickCount(5);
+    const auto repeat = _repeatDetector.add(eventRecord.stockExchangeId, eventRecord.symbolId, kline->closeTime);
+    eventRecord.starLevel = repeat.starLevel();
+    eventRecord.firstSeen = repeat.firstSeen;
+    eventRecord.streak = static_cast<quint16>(std::min<quint32>(repeat.streak, std::numeric_limits<quint16>::max()));
+    eventRecord.hits5min = static_cast<quint16>(std::min<quint32>(repeat.hits5min, std::numeric_limits<quint16>::max()));
+    eventRecord.hits15min = static_cast<quint16>(std::min<quint32>(repeat.hits15min, std::numeric_limits<quint16>::max()));
+    eventRecord.hits1hour = static_cast<quint16>(std::min<quint32>(repeat.hits1hour, std::numeric_limits<quint16>::max()));
 
-    auto axisY = qobject_cast<QValueAxis*>(_chartView->chart()->axes(Qt::Vertical).at(0));
-    const auto fivePercent = (max - min) / 3.0;
-    axisY->setMax(max  +  fivePercent);
-    axisY->setMin(min -  fivePercent);
+    _getKLineDetectData.emplace(eventRecord.index, detectData);
 
-    auto axisY2 = qobject_cast<QValueAxis*>(_chartView->chart()->axes(Qt::Vertical).at(1));
-    axisY2->setMax(maxVolume * 2);
-    axisY2->setMin(-0.01f);
-
-    _series->clear();
-    _seriesVolume->clear();
+    return eventRecord;
+}
 
-    _series->append(candlestickList);
-    _seriesVolume->append(candlestickVolumeList);
+void MainWindow::appendEvents(std::vector<EventListModel::EventRecord> &&records)
+{
+    Profiler::Scope profilerScope(Profiler::ESection::APPEND_EVENTS);
 
-    _chartView->show();
+    forgetEvents(_eventListModel->append(std::move(records)));
 }
 
-void MainWindow::showReviewChart(const TradingCatCommon::PKLinesList &klinesData, const TradingCatCommon::StockExchangeID &stockExchangeID)
+void MainWindow::forgetEvents(const std::vector<quint64> &evicted)
 {
-    Q_CHECK_PTR(_reviewSeries);
-    Q_CHECK_PTR(_reviewChartView);
-
-    Q_ASSERT(!klinesData->empty());
-    Q_ASSERT(!stockExchangeID.isEmpty());
+    for (const auto index: evicted)
+    {
+        const auto it_burstHits = _burstHits.find(index);
+        if (it_burstHits != _burstHits.end())
+        {
+            for (const auto hitIndex: it_burstHits->second)
+            {
+                _getKLineDetectData.erase(hitIndex);
+                _chartDataCache.remove(hitIndex);
+            }
 
-    const auto& firstKLine = klinesData->front();
-    auto& lastKLine = klinesData->back();
-    const auto& klineId = firstKLine->id;
+            _burstHits.erase(it_burstHits);
+        }
 
-    _reviewChartView->chart()->setTitle(QString("%2 %3")
-                                            .arg(klineId.symbol.name)
-                                            .arg(KLineTypeToString(klineId.type)));
+        _getKLineDetectData.erase(index);
+        _chartDataCache.remove(index);
+        _eventGroups.erase(index);
+    }
 
-    float max = std::numeric_limits<float>::min();
-    float min = std::numeric_limits<float>::max();
-    float maxVolume = std::numeric_limits<float>::min();
+    //без групп сворачивать нечего, и список снова показывается без фильтра
+    if (_eventGroups.empty() && _eventFilterModel->isCollapseGroups())
+    {
+        _eventFilterModel->setCollapseGroups(false);
+        keepCurrentEventSelected();
+    }
+}
 
-    quint64 index = 0;
-    const auto count = static_cast<quint64>(_reviewCount);
-    QList<QCandlestickSet*> candlestickList;
-    candlestickList.reserve(count);
-    QList<QCandlestickSet*> candlestickVolumeList;
-    candlestickVolumeList.reserve(count);
-    for (const auto& kline: *klinesData)
+quint64 MainWindow::coalesceBurst(std::vector<EventListModel::EventRecord> &records, const EventListModel::EventRecord &hit)
+{
+    auto& burstRow = _burstRows[(static_cast<quint64>(hit.stockExchangeId) << 32) | hit.symbolId];
+    if (burstRow.index != 0 && hit.time - burstRow.lastTime <= BURST_WINDOW)
     {
-        if (index >= count)
+        //событие серии может быть в той же пачке и еще не добавлено в список
+        const auto it_records = std::lower_bound(records.begin(), records.end(), burstRow.index,
+                                                 [](const auto& eventRecord, quint64 index)
+                                                 {
+                                                     return eventRecord.index < index;
+                                                 });
+        auto isMerged = false;
+        if (it_records != records.end() && it_records->index == burstRow.index)
         {
-            break;
+            EventListModel::mergeBurst(*it_records, hit);
+            isMerged = true;
         }
-
-        ++index;
-
+        else
         {
-            auto candlestick = new QCandlestickSet(kline->closeTime);
-
-            candlestick->setHigh(kline->high);
-            candlestick->setLow(kline->low);
-            candlestick->setOpen(kline->open);
-            candlestick->setClose(kline->open != kline->close ? kline->close : kline->close + 0.001 * kline->close);
-            auto pen = _series->pen();
-            pen.setColor(kline->open <= kline->close ? QColor(Qt::green) : QColor(Qt::red));
-            candlestick->setPen(pen);
-
-            candlestickList.push_back(candlestick);
+            isMerged = _eventListModel->mergeBurst(burstRow.index, hit);
         }
 
+        if (isMerged)
         {
-            auto candlestickVolume = new QCandlestickSet(kline->closeTime);
-            candlestickVolume->setOpen(kline->volume);
-            candlestickVolume->setHigh(kline->volume);
-            candlestickVolume->setLow(0);
-            candlestickVolume->setClose(0);
-            auto penVolume = _seriesVolume->pen();
-            penVolume.setColor(QColor(61, 56, 70));
-            candlestickVolume->setPen(penVolume);
-
-            candlestickVolumeList.push_back(candlestickVolume);
-        }
+            auto& hits = _burstHits[burstRow.index];
+            if (hits.empty())
+            {
+                hits.push_back(burstRow.index);
+            }
+            hits.push_back(hit.index);
+
+            //первое детектирование хранится вместе со строкой, из середины длинной серии удаляются самые старые.
+            //отображаемое детектирование не удаляется, чтобы от него можно было перейти к соседним
+            if (hits.size() > MAX_BURST_HITS)
+            {
+                const auto position = burstRow.index == _currentKLineIndex && hits[1] == _currentHitIndex ? 2 : 1;
+                _getKLineDetectData.erase(hits[position]);
+                _chartDataCache.remove(hits[position]);
+                hits.erase(hits.begin() + position);
+            }
 
-        max = std::max(max, kline->high);
-        min = std::min(min, kline->low);
-        maxVolume = std::max(maxVolume, kline->volume);
+            burstRow.lastTime = hit.time;
 
-        lastKLine= kline;
+            return burstRow.index;
+        }
     }
 
-    _reviewChartView->hide();
+    //начало новой серии. Если событие серии уже вытеснено, детектирование тоже начинает новую серию
+    burstRow.index = hit.index;
+    burstRow.lastTime = hit.time;
+
+    return 0;
+}
 
-    auto axisX = qobject_cast<QDateTimeAxis*>(_reviewChartView->chart()->axes(Qt::Horizontal).at(0));
-    axisX->setMax(QDateTime::fromMSecsSinceEpoch(firstKLine->closeTime + static_cast<qint64>(klineId.type) * 5));
-    axisX->setMin(QDateTime::fromMSecsSinceEpoch(lastKLine->closeTime- static_cast<qint64>(klineId.type)));
-    axisX->setTickCount(5);
+bool MainWindow::addToGroup(std::vector<EventListModel::EventRecord> &records, quint64 groupIndex)
+{
+    Q_ASSERT(!records.empty());
+
+    //первое событие группы может быть в той же пачке и еще не добавлено в список
+    const auto it_records = std::lower_bound(records.begin(), records.end(), groupIndex,
+                                             [](const auto& eventRecord, quint64 index)
+                                             {
+                                                 return eventRecord.index < index;
+                                             });
+    const auto isLeaderInRecords = it_records != records.end() && it_records->index == groupIndex;
+
+    auto it_eventGroups = _eventGroups.find(groupIndex);
+    if (it_eventGroups == _eventGroups.end())
+    {
+        //группа создается первым присоединенным событием. Если первое событие уже вытеснено, группа в списке
+        //закрыта: ее запись не создается заново, иначе она никогда не была бы удалена
+        if (!isLeaderInRecords && _eventListModel->row(groupIndex) < 0)
+        {
+            return false;
+        }
 
-    auto axisY = qobject_cast<QValueAxis*>(_reviewChartView->chart()->axes(Qt::Vertical).at(0));
-    const auto fivePercent = (max - min) / 3.0;
-    axisY->setMax(max  +  fivePercent);
-    axisY->setMin(min -  fivePercent);
+        it_eventGroups = _eventGroups.emplace(groupIndex, std::vector<quint64>{groupIndex}).first;
+    }
 
-    auto axisY2 = qobject_cast<QValueAxis*>(_reviewChartView->chart()->axes(Qt::Vertical).at(1));
-    axisY2->setMax(maxVolume * 2);
-    axisY2->setMin(-0.01f);
+    auto& group = it_eventGroups->second;
+    auto& record = records.back();
+    record.groupIndex = groupIndex;
+    group.push_back(record.index);
 
-    _reviewSeries->clear();
-    _reviewSeriesVolume->clear();
+    const auto groupSize = static_cast<quint8>(std::min<size_t>(group.size(), std::numeric_limits<quint8>::max()));
 
-    _reviewSeries->append(candlestickList);
-    _reviewSeriesVolume->append(candlestickVolumeList);
+    if (isLeaderInRecords)
+    {
+        it_records->groupIndex = groupIndex;
+        it_records->groupSize = groupSize;
+    }
+    else
+    {
+        _eventListModel->setGroupSize(groupIndex, groupSize);
+    }
 
-    _reviewChartView->show();
+    return true;
 }
 
-QListWidgetItem* MainWindow::addDetectToEventList(const TradingCatCommon::Detector::PKLineDetectData &detectData)
+void MainWindow::appendMessage(EventListModel::EEventType type, const QString &text)
 {
-    Q_ASSERT(!detectData->history->empty());
-    Q_ASSERT(!detectData->reviewHistory->empty());
-    Q_ASSERT(!detectData->stockExchangeId.isEmpty());
+    forgetEvents(_eventListModel->appendMessage(type, text));
+}
 
-    const auto& kline = detectData->history->front();
-    const auto stockExchangeName = detectData->stockExchangeId.toString();
+void MainWindow::restoreSession()
+{
+    const auto restoreData = _sessionStore.restore(SESSION_RESTORE_TIME_BUDGET);
 
-    const QString text = QString("%1->%2 Delta=%3 Volume=%4")
-                             .arg(detectData->stockExchangeId.toString())
-                             .arg(kline->id.symbol.name)
-                             .arg(detectData->delta)
-                             .arg(detectData->volume);
+    std::vector<EventListModel::EventRecord> records;
+    records.reserve(restoreData.detected.size());
 
-    qInfo() << "Detect:" << detectData->msg;
+    const auto isCoalesceBursts = _localCnf.coalesceBursts();
 
-    auto item = new QListWidgetItem(text);
-    item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+    quint64 currentIndex = 0;
+    for (qsizetype position = 0; position < static_cast<qsizetype>(restoreData.detected.size()); ++position)
+    {
+        auto record = makeDetectRecord(restoreData.detected[position]);
 
-    static quint64 lastIDKLine = 0;
+        auto index = isCoalesceBursts ? coalesceBurst(records, record) : 0;
+        if (index == 0)
+        {
+            index = record.index;
+            records.push_back(std::move(record));
+        }
 
-    item->setData(INDEX_ROLE, ++lastIDKLine);
-    item->setData(KLINE_NAME_ROLE, kline->id.symbol.name);
-    _getKLineDetectData.emplace(lastIDKLine, detectData);
+        //без сохраненного выбора выбираем самое новое событие
+        if (position == restoreData.currentPosition || (restoreData.currentPosition < 0 && position + 1 == static_cast<qsizetype>(restoreData.detected.size())))
+        {
+            currentIndex = index;
+        }
+    }
 
-    item->setForeground(stockExchangeColor(detectData->stockExchangeId));
+    appendEvents(std::move(records));
 
-    const auto isDetected = isLastDetected(detectData->stockExchangeId, kline->id, kline->closeTime);
-    if (kline->open <= kline->close)
+    const auto currentRow = _eventFilterModel->row(currentIndex);
+    if (currentRow >= 0)
     {
-        item->setIcon(isDetected ? QIcon(":/image/img/increase_star.png") : QIcon(":/image/img/increase.png"));
+        selectEvent(currentRow);
+
+        ui->eventsList->scrollTo(_eventFilterModel->index(currentRow, 0));
     }
-    else
+
+    Profiler::instance().mark("firstScreen");
+
+    const auto firstScreenTime = _startTimer.elapsed();
+    if (firstScreenTime > FIRST_SCREEN_TIME_BUDGET)
     {
-        item->setIcon(isDetected ? QIcon(":/image/img/decrease_star.png") : QIcon(":/image/img/decrease.png"));
+        qWarning() << "Time to first usable screen" << firstScreenTime << "ms exceeds budget" << FIRST_SCREEN_TIME_BUDGET << "ms";
     }
-
-    while (ui->eventsList->count() >= MAX_ITEM_COUNT)
+    else
     {
-        auto item = ui->eventsList->takeItem(0);
-        const auto index = item->data(INDEX_ROLE);
-        if (!index.isNull())
-        {
-            _getKLineDetectData.erase(index.toULongLong());
-        }
-
-        delete item;
+        qInfo() << "Time to first usable screen" << firstScreenTime << "ms";
     }
-
-    ui->eventsList->addItem(item);
-
-    return item;
 }
 
 void MainWindow::setHistoryCountButton(LocalConfig::EHistoryKLineCount count)
@@ -1040,6 +1446,11 @@ void MainWindow::setHistoryCountButton(LocalConfig::EHistoryKLineCount count)
         Q_ASSERT(false);
     }
 
+    if (_chart != nullptr)
+    {
+        _chart->setPaneKLinesCount(0, static_cast<qsizetype>(_viewCount));
+    }
+
     _localCnf.setHistoryKLineCount(count);
 }
 
@@ -1070,101 +1481,47 @@ void MainWindow::setReviewHistoryCountButton(LocalConfig::EReviewHistoryKLineCou
         Q_ASSERT(false);
     }
 
-    _localCnf.setReviewHistoryKLineCount(count);
-}
-
-void MainWindow::updateHistoryChart(quint64 index)
-{
-    if (index != 0)
+    if (_reviewChart != nullptr)
     {
-        const auto klineData = _getKLineDetectData.at(_currentKLineIndex);
-
-        showChart(klineData->history, klineData->stockExchangeId);
+        _reviewChart->setPaneKLinesCount(0, static_cast<qsizetype>(_reviewCount));
     }
-}
-
-void MainWindow::updateReviewHistoryChart(quint64 index)
-{
-    if (index != 0)
-    {
-        const auto klineData = _getKLineDetectData.at(_currentKLineIndex);
 
-        showReviewChart(klineData->reviewHistory, klineData->stockExchangeId);
-    }
+    _localCnf.setReviewHistoryKLineCount(count);
 }
 
-QComboBox* MainWindow::makeStockExchangeComboBox(const QString &stockExchange) const
+QComboBox* MainWindow::makeStockExchangeComboBox(const QString &stockExchange)
 {
     auto stockExchangeComboBox = new QComboBox();
-    stockExchangeComboBox->setFont(QApplication::font());
     stockExchangeComboBox->setEditable(false);
+    stockExchangeComboBox->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    stockExchangeComboBox->setMinimumContentsLength(COMBOBOX_MIN_CONTENTS_LENGTH);
     stockExchangeComboBox->view()->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    stockExchangeComboBox->setModel(_stockExchangeListModel);
 
-    stockExchangeComboBox->addItem(*STOCKEXCHANGE_NAME_ALL);
-
-    QStringList stockExchangeNames;
-    for (const auto& stockExchangeData: _stockExchengeData)
-    {
-        stockExchangeNames.push_back(stockExchangeData.first.name);
-    }
-    stockExchangeNames.sort();
-
-    for (const auto& stockExchangeName: stockExchangeNames)
-    {
-        stockExchangeComboBox->addItem(QIcon(QString(":/image/img/%1.png").arg(stockExchangeName)), stockExchangeName);
-    }
-
-    stockExchangeComboBox->setCurrentText(stockExchange);
+    //отображается имя для пользователя, поэтому строка ищется по имени биржи от сервера
+    const auto row = stockExchangeComboBox->findData(stockExchange, StockExchangeListModel::STOCK_EXCHANGE_NAME_ROLE);
+    stockExchangeComboBox->setCurrentIndex(row != -1 ? row : 0);
 
     return stockExchangeComboBox;
 }
 
-QComboBox *MainWindow::makeSymbolComboBox(const TradingCatCommon::KLineID &klineId) const
+QComboBox *MainWindow::makeSymbolComboBox(const TradingCatCommon::KLineID &klineId)
 {
+    //редактор использует общую модель каталога символов, поэтому создание строки не зависит от количества символов
     auto symbolComboBox = new QComboBox();
-    symbolComboBox->setFont(QApplication::font());
-    symbolComboBox->setEditable(false);
-
-    symbolComboBox->addItem(*SYMBOL_NAME_ALL, QVariant(*SYMBOL_NAME_ALL));
-
-    std::vector<KLineID> klinesIdList;
-    if (!klineId.isEmpty())
-    {
-        klinesIdList.push_back(klineId);
-    }
-
-    for(const auto& stockExchengeData: _stockExchengeData)
-    {
-        for (const auto& klineIdInStock: *stockExchengeData.second)
-        {
-            if (klineIdInStock.type == TradingCatCommon::KLineType::MIN1)
-            {
-                klinesIdList.push_back(klineIdInStock);
-            }
-        }
-    }
-
-    std::sort(klinesIdList.begin(), klinesIdList.end(),
-              [](const auto& klineIdLeft, const auto& klineIdRight)
-              {
-                  return klineIdLeft.symbol.name < klineIdRight.symbol.name;
-              });
+    symbolComboBox->setEditable(true);
+    symbolComboBox->setInsertPolicy(QComboBox::NoInsert);
+    symbolComboBox->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLength);
+    symbolComboBox->setMinimumContentsLength(COMBOBOX_MIN_CONTENTS_LENGTH);
+    symbolComboBox->setModel(_symbolListModel);
 
-    klinesIdList.erase(std::unique(klinesIdList.begin(), klinesIdList.end()), klinesIdList.end());
-
-    for (const auto& klineIdInStock: klinesIdList)
-    {
-        symbolComboBox->addItem(klineIdInStock.baseName(), QVariant(klineIdInStock.symbol.name));
-    }
+    auto completer = symbolComboBox->completer();
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    completer->setFilterMode(Qt::MatchStartsWith);
+    completer->setCompletionMode(QCompleter::PopupCompletion);
 
-    if (!klineId.isEmpty())
-    {
-        symbolComboBox->setCurrentText(klineId.baseName());
-    }
-    else
-    {
-        symbolComboBox->setCurrentText(*SYMBOL_NAME_ALL);
-    }
+    const auto row = !klineId.isEmpty() ? _symbolListModel->ensureSymbol(InternTable::instance().symbol(klineId.symbol)) : 0;
+    symbolComboBox->setCurrentIndex(row);
 
     return symbolComboBox;
 }
@@ -1200,6 +1557,10 @@ void MainWindow::makeFilterTab()
 
         ui->addPushButton->setEnabled(true);
     }
+
+    _isFilterTabBuilt = true;
+
+    Profiler::instance().mark("filterTabBuilt");
 }
 
 void MainWindow::clearFilterTab()
@@ -1209,6 +1570,8 @@ void MainWindow::clearFilterTab()
 
     ui->addPushButton->setEnabled(false);
     ui->removePushButton->setEnabled(false);
+
+    _isFilterTabBuilt = false;
 }
 
 void MainWindow::makeBlackListTab()
@@ -1241,6 +1604,10 @@ void MainWindow::makeBlackListTab()
 
         ui->addBlackListPushButton->setEnabled(true);
     }
+
+    _isBlackListTabBuilt = true;
+
+    Profiler::instance().mark("blackListTabBuilt");
 }
 
 void MainWindow::clearBlackListTab()
@@ -1250,6 +1617,8 @@ void MainWindow::clearBlackListTab()
 
     ui->addBlackListPushButton->setEnabled(false);
     ui->removeBlackListPushButton->setEnabled(false);
+
+    _isBlackListTabBuilt = false;
 }
 
 void MainWindow::addFilterRow(const QString &stockExchange, double delta, double volume)
@@ -1277,11 +1646,18 @@ void MainWindow::addFilterRow(const QString &stockExchange, double delta, double
 
     filterTableWidget->insertRow(filterTableWidget->rowCount());
     const auto currentRow = filterTableWidget->rowCount() - 1;
-    filterTableWidget->setCellWidget(currentRow, 0, makeStockExchangeComboBox(stockExchange));
+    auto stockExchangeComboBox = makeStockExchangeComboBox(stockExchange);
+
+    filterTableWidget->setCellWidget(currentRow, 0, stockExchangeComboBox);
     filterTableWidget->setCellWidget(currentRow, 1, deltaSpinBox);
     filterTableWidget->setCellWidget(currentRow, 2, volumeSpinBox);
     filterTableWidget->setCellWidget(currentRow, 3, removeButton);
 
+    //изменения строки сразу применяются к списку событий
+    connect(stockExchangeComboBox, SIGNAL(currentIndexChanged(int)), SLOT(filterTablesChanged()));
+    connect(deltaSpinBox, SIGNAL(valueChanged(double)), SLOT(filterTablesChanged()));
+    connect(volumeSpinBox, SIGNAL(valueChanged(double)), SLOT(filterTablesChanged()));
+
     showRemovePushButton();
 }
 
@@ -1303,10 +1679,17 @@ void MainWindow::addBlackListRow(const QString& stockExchange, const TradingCatC
 
     blackListTableWidget->insertRow(blackListTableWidget->rowCount());
     const auto currentRow = blackListTableWidget->rowCount() - 1;
-    blackListTableWidget->setCellWidget(currentRow, 0, makeStockExchangeComboBox(stockExchange));
-    blackListTableWidget->setCellWidget(currentRow, 1, makeSymbolComboBox(klineId));
+    auto stockExchangeComboBox = makeStockExchangeComboBox(stockExchange);
+    auto symbolComboBox = makeSymbolComboBox(klineId);
+
+    blackListTableWidget->setCellWidget(currentRow, 0, stockExchangeComboBox);
+    blackListTableWidget->setCellWidget(currentRow, 1, symbolComboBox);
     blackListTableWidget->setCellWidget(currentRow, 2, removeButton);
 
+    //изменения строки сразу применяются к списку событий
+    connect(stockExchangeComboBox, SIGNAL(currentIndexChanged(int)), SLOT(filterTablesChanged()));
+    connect(symbolComboBox, SIGNAL(currentIndexChanged(int)), SLOT(filterTablesChanged()));
+
     showRemoveBlackListPushButton();
 }
 
@@ -1314,110 +1697,3 @@ void MainWindow::showRemoveBlackListPushButton()
 {
     ui->removeBlackListPushButton->setEnabled(ui->blackListTableWidget->rowCount() != 0);
 }
-
-QColor MainWindow::stockExchangeColor(const TradingCatCommon::StockExchangeID &stockExchangeId)
-{
-    const auto& stockExchangeName = stockExchangeId.name;
-
-    //Spot
-    if (stockExchangeName == "MEXC")
-    {
-        return Qt::yellow; //желтый
-    }
-    else if (stockExchangeName == "KUCOIN")
-    {
-        return QColor(246, 97, 81);  //красный
-    }
-    else if (stockExchangeName == "GATE")
-    {
-        return QColor(153, 193, 241);  //голубой
-    }
-    else if (stockExchangeName == "BYBIT")
-    {
-        return QColor(97, 53, 131); //фиолетовый
-    }
-    else if (stockExchangeName == "BITMART")
-    {
-        return QColor(47, 93, 200); //синий
-    }
-    else if (stockExchangeName == "BINANCE")
-    {
-        return QColor(46, 194, 126); // светло зеленый
-    }
-    else if (stockExchangeName == "BITGET")
-    {
-        return QColor(200, 200, 200); //серый
-    }
-    else if (stockExchangeName == "BINGX")
-    {
-        return QColor(220, 138, 221); // розовый
-    }
-    else if (stockExchangeName == "OKX")
-    {
-        return QColor(255, 163, 72); // оранжевый
-    }
-    else if (stockExchangeName == "HTX")
-    {
-        return QColor(5, 55, 155); // синий
-    }
-    else if (stockExchangeName == "LBANK")
-    {
-        return QColor(0, 200, 0); // зеленый
-    }
-
-    //Futures
-    else if (stockExchangeName == "KUCOIN_FUTURES")
-    {
-        return QColor(246, 127, 110);  //красный
-    }
-    else if (stockExchangeName == "BITGET_FUTURES")
-    {
-        return QColor(200, 230, 230); //серый
-    }
-    else if (stockExchangeName == "GATE_FUTURES")
-    {
-        return QColor(153, 223, 255); //серый
-    }
-    else if (stockExchangeName == "BYBIT_FUTURES")
-    {
-        return QColor(97, 83, 161); //фиолетовый
-    }
-    else if (stockExchangeName == "MEXC_FUTURES")
-    {
-        return Qt::darkYellow; //желтый
-    }
-    else if (stockExchangeName == "BINGX_FUTURES")
-    {
-        return QColor(200, 108, 201); // розовый
-    }
-    else if (stockExchangeName == "BITMART_FUTURES")
-    {
-        return QColor(67, 113, 220); //синий
-    }
-
-    else
-    {
-        return Qt::gray;
-    }
-}
-
-bool MainWindow::isLastDetected(const TradingCatCommon::StockExchangeID &stockExchangeId, const TradingCatCommon::KLineID &klineId, qint64 time)
-{
-    Q_UNUSED(stockExchangeId);
-
-    const auto hash = std::hash<QString>()(klineId.baseName());  //+ 49831 * std::hash<TradingCatCommon::StockExchangeID>()(stockExchangeId);
-    const auto it_lastDetected = _lastDetected.find(hash);
-    if (it_lastDetected == _lastDetected.end())
-    {
-        _lastDetected.emplace(hash, time);
-
-        return false;
-    }
-
-    auto& klineTime = it_lastDetected->second;
-    const auto result = (time - klineTime) < LAST_DETECT_TIMEOUT;
-    klineTime= time;
-
-    return result;
-}
-
@@ -6,15 +6,14 @@
 //Qt
 #include <QKeyEvent>
 #include <QMainWindow>
-#include <QChart>
-#include <QChartView>
-#include <QCandlestickSeries>
-#include <QListWidgetItem>
+#include <QModelIndex>
 #include <QSet>
 #include <QMap>
 #include <QHash>
 #include <QComboBox>
 #include <QThread>
+#include <QElapsedTimer>
+#include <QTimer>
 
 //EM
 #include <emscripten/html5.h>
@@ -28,6 +27,25 @@
 #include "networkcore.h"
 #include "localconfig.h"
 #include "eventlistmenu.h"
+#include "sessionstore.h"
+#include "repeatdetector.h"
+#include "interntable.h"
+#include "exchangeregistry.h"
+#include "eventlistmodel.h"
+#include "eventfiltermodel.h"
+#include "detectrules.h"
+#include "stockexchangelistmodel.h"
+#include "symbollistmodel.h"
+#include "chartdatacache.h"
+#include "multipanechart.h"
+#include "profileroverlay.h"
+#include "fontloader.h"
+#include "detectstatistics.h"
+#include "statisticswidget.h"
+#include "correlationgrouper.h"
+#include "detectjournal.h"
+#include "journalwidget.h"
+#include "detectexporter.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -75,14 +93,21 @@ private slots:
 
     //Main tab
     void detectorSplitterSplitterMoved(int pos, int index);
-    void eventListItemClicked(QListWidgetItem *item);
+    void eventListItemClicked(const QModelIndex& index);
+    void eventFilterChanged();
+    void filterTablesChanged();
+    void keyRepeatTimerTimeout();
+    void prefetchTimerTimeout();
+    void detectExporterFinished(const QString& fileName, qsizetype count);
 
     void checkStateChangedAutoScrollCB(Qt::CheckState state);
+    void checkStateChangedCoalesceBurstsCB(Qt::CheckState state);
 
     void historyMaxPBClicked();
     void history30minPBClicked();
     void history1hourPBClicked();
     void history2hoursPBClicked();
+    void historyKLineTypeCBCurrentIndexChanged(int index);
 
     void reviewHistory2hoursPBClicked();
     void reviewHistory6hoursPBClicked();
@@ -101,8 +126,16 @@ private slots:
     void clickedItemEventListMenu(EventListMenu::EMenuItemType type, quint64 index);
 
 private:
-    void makeChart();
-    void makeReviewChart();
+    void makeCharts();
+
+    /*!
+        Перестраивает настройки пользователя по уже построенным таблицам фильтров и черного списка
+        и сразу применяет их к списку событий
+        @return true - настройки перестроены. false - таблицы еще не строились и настройки не изменились
+    */
+    bool updateUserConfig();
+    void applyDetectRules();
+    void keepCurrentEventSelected();
 
     void makeFilterTab();
     void clearFilterTab();
@@ -112,18 +145,83 @@ private:
 
     void sendLogMsg(Common::MSG_CODE category, const QString& msg);
 
-    void showChart(const TradingCatCommon::PKLinesList& klinesData, const TradingCatCommon::StockExchangeID& stockExchangeID);
-    void showReviewChart(const TradingCatCommon::PKLinesList& klinesData, const TradingCatCommon::StockExchangeID& stockExchangeID);
+    EventListModel::EventRecord makeDetectRecord(const TradingCatCommon::Detector::PKLineDetectData& detectData);
+    void appendEvents(std::vector<EventListModel::EventRecord>&& records);
+
+    /*!
+        Добавляет последнее событие пачки в группу детектирований на разных биржах
+        @param records - пачка новых событий. Последнее событие - добавляемое
+        @param groupIndex - ИД первого события группы
+        @return true - событие добавлено в группу. false - первое событие группы уже вытеснено из списка
+    */
+    bool addToGroup(std::vector<EventListModel::EventRecord>& records, quint64 groupIndex);
+    void appendMessage(EventListModel::EEventType type, const QString& text);
+
+    /*!
+        Удаляет данные вытесненных из списка событий
+        @param evicted - ИД вытесненных событий
+    */
+    void forgetEvents(const std::vector<quint64>& evicted);
+
+    /*!
+        Объединяет повторное детектирование символа на бирже с последним событием серии, если оно получено
+        не позже BURST_WINDOW после предыдущего детектирования серии
+        @param records - пачка новых событий. Событие серии может быть в пачке
+        @param hit - повторное детектирование
+        @return ИД события серии или 0, если детектирование начинает новую серию и добавляется отдельной строкой
+    */
+    quint64 coalesceBurst(std::vector<EventListModel::EventRecord>& records, const EventListModel::EventRecord& hit);
+
+    /*!
+        @param index - ИД события
+        @return ИД последнего детектирования серии события или index, если детектирования не объединялись
+    */
+    quint64 latestBurstHit(quint64 index) const;
+
+    /*!
+        Переходит к предыдущему или следующему детектированию серии текущего события
+        @param step - направление: -1 - к предыдущему, 1 - к следующему
+        @return true - текущее событие объединяет серию детектирований
+    */
+    bool stepBurstHit(int step);
+
+    void selectEvent(int row);
+
+    /*!
+        Отображает на графиках детектирование события
+        @param eventRecord - событие
+        @param hitIndex - ИД детектирования серии события или ИД события
+    */
+    void showDetect(const EventListModel::EventRecord& eventRecord, quint64 hitIndex);
+
+    /*!
+        Раскрывает или сворачивает группу детектирований, в которую входит событие
+        @param index - ИД события
+    */
+    void toggleEventGroup(quint64 index);
 
-    QListWidgetItem* addDetectToEventList(const TradingCatCommon::Detector::PKLineDetectData& detectData);
+    /*!
+        Выгружает в файл все события списка, включая все детектирования объединенных серий
+        @param format - формат файла
+    */
+    void exportEvents(DetectExporter::EFormat format);
+
+    /*!
+        Ищет ближайшую строку события детектирования
+        @param row - строка, с которой начинается поиск
+        @param step - направление поиска: -1 - вверх, 1 - вниз
+        @return номер строки или -1 если строка не найдена
+    */
+    int findDetectRow(int row, int step) const;
+    quint64 currentEventIndex() const;
+
+    void restoreSession();
 
     void setHistoryCountButton(LocalConfig::EHistoryKLineCount count);
     void setReviewHistoryCountButton(LocalConfig::EReviewHistoryKLineCount count);
-    void updateHistoryChart(quint64 index);
-    void updateReviewHistoryChart(quint64 index);
 
-    QComboBox* makeStockExchangeComboBox(const QString& stockExchange) const;
-    QComboBox* makeSymbolComboBox(const TradingCatCommon::KLineID &klineId) const;
+    QComboBox* makeStockExchangeComboBox(const QString& stockExchange);
+    QComboBox* makeSymbolComboBox(const TradingCatCommon::KLineID &klineId);
 
     void addFilterRow(const QString& stockExchange, double delta, double volume);
     void showRemovePushButton();
@@ -131,16 +229,17 @@ private:
     void addBlackListRow(const QString& stockExchange, const TradingCatCommon::KLineID &klineId);
     void showRemoveBlackListPushButton();
 
-    QColor stockExchangeColor(const TradingCatCommon::StockExchangeID& stockExchangeId);
-
-    bool isLastDetected(const TradingCatCommon::StockExchangeID& stockExchangeId, const TradingCatCommon::KLineID& klineId, qint64 time);
-
 private:
     Ui::MainWindow *ui;
 
     EventListMenu* _eventListMenu = nullptr;     ///< контекстное меню списка событий
+    EventListModel* _eventListModel = nullptr;   ///< модель списка событий
+    EventFilterModel* _eventFilterModel = nullptr; ///< фильтр списка событий. Строки списка событий - строки этой модели
 
     LocalConfig _localCnf;
+    SessionStore _sessionStore;  ///< события текущей сессии, сохраняемые между перезагрузками страницы
+
+    QElapsedTimer _startTimer;   ///< время с момента запуска приложения
 
     struct NetworcCoreThread
     {
@@ -158,24 +257,54 @@ private:
 
     std::unique_ptr<NetworcCoreThread> _networkCore;
 
-    std::unordered_map<TradingCatCommon::StockExchangeID, TradingCatCommon::PKLinesIDList> _stockExchengeData;
+    std::unordered_map<InternTable::ID, TradingCatCommon::PKLinesIDList> _stockExchengeData; ///< список доступных свечей. Ключ - ИД биржи в InternTable
+    std::vector<InternTable::ID> _stockExchangeSymbols;      ///< ИД символов MIN1 свечей всех бирж без повторов
+    ExchangeRegistry _exchangeRegistry;                      ///< справочник бирж
+    StockExchangeListModel* _stockExchangeListModel = nullptr; ///< общий список бирж для редакторов таблиц фильтров
+    SymbolListModel* _symbolListModel = nullptr;             ///< общий каталог символов для редакторов черного списка
 
     bool _login = false;
+    bool _isFilterTabBuilt = false;     ///< таблица фильтров заполнена по текущим настройкам
+    bool _isBlackListTabBuilt = false;  ///< таблица черного списка заполнена по текущим настройкам
     TradingCatCommon::UserConfig _userConfig; //текущие настройки пользователя
 
-    QCandlestickSeries *_series = nullptr;
-    QCandlestickSeries *_seriesVolume = nullptr;
-    QChartView *_chartView = nullptr;
+    MultiPaneChart *_chart = nullptr;
     LocalConfig::EHistoryKLineCount _viewCount = LocalConfig::EHistoryKLineCount::MAX;
+    LocalConfig::EHistoryKLineType _viewKLineType = LocalConfig::EHistoryKLineType::MIN1;
 
-    QCandlestickSeries *_reviewSeries = nullptr;
-    QCandlestickSeries *_reviewSeriesVolume = nullptr;
-    QChartView *_reviewChartView = nullptr;
+    MultiPaneChart *_reviewChart = nullptr;
     LocalConfig::EReviewHistoryKLineCount _reviewCount = LocalConfig::EReviewHistoryKLineCount::MAX;
 
+    ChartDataCache _chartDataCache;  ///< подготовленные для графиков свечи событий
+
     quint64 _currentKLineIndex = 0;
-    std::unordered_map<quint64, TradingCatCommon::Detector::PKLineDetectData> _getKLineDetectData;//список отфильтрованных свечей поступивших от сервера
+    quint64 _currentHitIndex = 0;        ///< отображаемое детектирование серии текущего события
+    quint64 _pendingKLineIndex = 0;      ///< событие, выбранное клавишами во время автоповтора и еще не отображенное
+    QTimer* _keyRepeatTimer = nullptr;   ///< таймер объединения автоповторов клавиш вверх/вниз
+    QTimer* _prefetchTimer = nullptr;    ///< таймер подготовки данных графиков соседних событий
+    std::unordered_map<quint64, TradingCatCommon::Detector::PKLineDetectData> _getKLineDetectData;//список отфильтрованных свечей поступивших от сервера. Ключ - ИД события в _eventListModel или ИД детектирования серии
+
+    RepeatDetector _repeatDetector; ///< статистика повторных детектирований свечей за последний час
+    DetectStatistics _detectStatistics;                 ///< скользящая статистика детектирований за 5 минут, час и сутки
+    StatisticsWidget* _statisticsWidget = nullptr;      ///< содержимое вкладки статистики. Создается при первом открытии
+
+    DetectJournal* _detectJournal = nullptr;            ///< постоянный журнал всех событий детектирования
+    JournalWidget* _journalWidget = nullptr;            ///< содержимое вкладки журнала. Создается при первом открытии
+    DetectExporter* _detectExporter = nullptr;          ///< выгрузка событий в файл
+
+    CorrelationGrouper _correlationGrouper;                                  ///< объединение одновременных детектирований монеты на разных биржах
+    std::unordered_map<quint64, std::vector<quint64>> _eventGroups;          ///< ИД событий групп. Ключ - ИД первого события группы
+
+    struct BurstRow
+    {
+        quint64 index = 0;      ///< ИД события серии
+        qint64 lastTime = 0;    ///< время последнего детектирования серии, мс
+    };
+
+    std::unordered_map<quint64, BurstRow> _burstRows;                        ///< последние события серий. Ключ - ИД биржи и ИД символа
+    std::unordered_map<quint64, std::vector<quint64>> _burstHits;            ///< ИД детектирований объединенных серий по порядку, первое - ИД события. Ключ - ИД события
 
-    std::unordered_map<qint64, qint64> _lastDetected; ///< Список последних фотфильтрованных свечей. Ключ - хэш ИД свечи, значене - время детектирования
+    FontLoader* _fontLoader = nullptr;           ///< отложенная загрузка шрифта для не латинских имен символов
+    ProfilerOverlay* _profilerOverlay = nullptr; ///< панель профилировщика. Переключается клавишей F2
 };
 
@@ -0,0 +1,172 @@
+#include "multipanechart.h"
+
+using namespace TradingCatCommon;
+
+MultiPaneChart::MultiPaneChart(ChartDataCache &chartDataCache, QWidget *parent /* = nullptr */)
+    : QWidget(parent)
+    , _chartDataCache(chartDataCache)
+{
+    _layout = new QVBoxLayout(this);
+    _layout->setContentsMargins(0, 0, 0, 0);
+    _layout->setSpacing(0);
+}
+
+qsizetype MultiPaneChart::addPane(ChartDataCache::ESource source, const Style &style, qsizetype count)
+{
+    Q_ASSERT(count > 0);
+
+    Pane pane;
+    pane.chart = new CandlestickChart(this);
+    pane.chart->setBodyWidth(style.bodyWidth);
+    pane.chart->setIndicators(style.indicators);
+    pane.source = source;
+    pane.style = style;
+    pane.count = count;
+
+    _layout->addWidget(pane.chart);
+
+    connect(pane.chart, SIGNAL(maxKLinesCountChanged()), SLOT(paneMaxKLinesCountChanged()));
+
+    _panes.push_back(pane);
+
+    if (_detectData)
+    {
+        showPane(_panes.back());
+    }
+
+    return static_cast<qsizetype>(_panes.size()) - 1;
+}
+
+qsizetype MultiPaneChart::paneCount() const noexcept
+{
+    return static_cast<qsizetype>(_panes.size());
+}
+
+void MultiPaneChart::setPaneKLinesCount(qsizetype pane, qsizetype count)
+{
+    Q_ASSERT(pane >= 0 && pane < paneCount());
+    Q_ASSERT(count > 0);
+
+    auto& currentPane = _panes[pane];
+    if (currentPane.count == count)
+    {
+        return;
+    }
+
+    currentPane.count = count;
+
+    if (_detectData)
+    {
+        showPane(currentPane);
+    }
+}
+
+void MultiPaneChart::setPaneKLinesDuration(qsizetype pane, qint64 duration)
+{
+    Q_ASSERT(pane >= 0 && pane < paneCount());
+    Q_ASSERT(duration >= 0);
+
+    auto& currentPane = _panes[pane];
+    if (currentPane.duration == duration)
+    {
+        return;
+    }
+
+    currentPane.duration = duration;
+
+    if (_detectData)
+    {
+        showPane(currentPane);
+    }
+}
+
+void MultiPaneChart::setDetect(quint64 eventIndex, const TradingCatCommon::Detector::PKLineDetectData &detectData, const OverlayDetects& overlays /* = {} */)
+{
+    Q_ASSERT(eventIndex != 0);
+    Q_CHECK_PTR(detectData);
+
+    _eventIndex = eventIndex;
+    _detectData = detectData;
+    _overlays = overlays;
+
+    for (auto& pane: _panes)
+    {
+        showPane(pane);
+    }
+}
+
+void MultiPaneChart::prefetch(quint64 eventIndex, const TradingCatCommon::Detector::PKLineDetectData &detectData)
+{
+    Q_ASSERT(eventIndex != 0);
+    Q_CHECK_PTR(detectData);
+
+    for (const auto& pane: _panes)
+    {
+        paneKLines(pane, eventIndex, detectData);
+    }
+}
+
+void MultiPaneChart::paneMaxKLinesCountChanged()
+{
+    if (!_detectData)
+    {
+        return;
+    }
+
+    const auto chart = qobject_cast<CandlestickChart*>(sender());
+    for (auto& pane: _panes)
+    {
+        if (pane.chart == chart)
+        {
+            showPane(pane);
+
+            break;
+        }
+    }
+}
+
+void MultiPaneChart::showPane(Pane &pane)
+{
+    Q_CHECK_PTR(pane.chart);
+    Q_CHECK_PTR(_detectData);
+
+    const auto& klinesData = pane.source == ChartDataCache::ESource::HISTORY ? _detectData->history : _detectData->reviewHistory;
+
+    Q_ASSERT(!klinesData->empty());
+
+    const auto& klineId = klinesData->front()->id;
+    const auto klineType = pane.duration > static_cast<qint64>(klineId.type) ? static_cast<KLineType>(pane.duration) : klineId.type;
+
+    if (pane.style.isStockExchangeInTitle)
+    {
+        pane.chart->setTitle(QString("%1: %2 %3")
+                                 .arg(_detectData->stockExchangeId.name)
+                                 .arg(klineId.symbol.name)
+                                 .arg(KLineTypeToString(klineType)));
+    }
+    else
+    {
+        pane.chart->setTitle(QString("%1 %2")
+                                 .arg(klineId.symbol.name)
+                                 .arg(KLineTypeToString(klineType)));
+    }
+
+    std::vector<CandlestickChart::Overlay> overlays;
+    overlays.reserve(_overlays.size());
+    for (const auto& [overlayIndex, overlayData]: _overlays)
+    {
+        overlays.push_back({overlayData->stockExchangeId.name, paneKLines(pane, overlayIndex, overlayData)});
+    }
+    pane.chart->setOverlays(std::move(overlays));
+
+    pane.chart->setKLines(paneKLines(pane, _eventIndex, _detectData));
+}
+
+PKLineBuffer MultiPaneChart::paneKLines(const Pane &pane, quint64 eventIndex, const TradingCatCommon::Detector::PKLineDetectData &detectData)
+{
+    const auto& klinesData = pane.source == ChartDataCache::ESource::HISTORY ? detectData->history : detectData->reviewHistory;
+
+    const auto stockExchangeId = InternTable::instance().stockExchange(detectData->stockExchangeId);
+
+    return _chartDataCache.get(eventIndex, pane.source, stockExchangeId, klinesData, pane.duration, pane.count, pane.chart->maxKLinesCount());
+}
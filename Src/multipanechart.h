@@ -0,0 +1,115 @@
+#pragma once
+
+//STL
+#include <vector>
+#include <utility>
+
+//Qt
+#include <QWidget>
+#include <QVBoxLayout>
+
+//My
+#include <TradingCatCommon/detector.h>
+
+#include "candlestickchart.h"
+#include "chartdatacache.h"
+
+/*!
+    График события детектирования из нескольких синхронизированных панелей, расположенных друг под другом.
+    Все панели отображают одно и то же событие и обновляются вместе. Данные панелей берутся из общего
+    ChartDataCache, поэтому панели с одинаковыми источником и окном используют один и тот же буфер свечей
+    и его диапазоны значений
+*/
+class MultiPaneChart
+    : public QWidget
+{
+    Q_OBJECT
+
+public:
+    struct Style
+    {
+        qreal bodyWidth = 0.7;                 ///< ширина тела свечи относительно шага между свечами
+        bool isStockExchangeInTitle = true;    ///< выводить имя биржи в заголовке
+        CandlestickChart::Indicators indicators; ///< отображаемые индикаторы
+    };
+
+    using OverlayDetects = std::vector<std::pair<quint64, TradingCatCommon::Detector::PKLineDetectData>>; ///< ИД и данные событий
+
+public:
+    /*!
+        Конструктор
+        @param chartDataCache - общий кэш данных графиков. Должен существовать все время жизни графика
+        @param parent - родительский виджет
+    */
+    explicit MultiPaneChart(ChartDataCache& chartDataCache, QWidget* parent = nullptr);
+
+    /*!
+        Добавляет панель
+        @param source - источник свечей панели
+        @param style - оформление панели
+        @param count - количество отображаемых свечей
+        @return номер панели
+    */
+    qsizetype addPane(ChartDataCache::ESource source, const Style& style, qsizetype count);
+
+    qsizetype paneCount() const noexcept;
+
+    /*!
+        Изменяет количество отображаемых свечей панели и перерисовывает ее
+        @param pane - номер панели
+        @param count - количество отображаемых свечей
+    */
+    void setPaneKLinesCount(qsizetype pane, qsizetype count);
+
+    /*!
+        Изменяет интервал свечей панели и перерисовывает ее. Свечи истории объединяются в свечи этого интервала
+        @param pane - номер панели
+        @param duration - интервал свечей, мс. 0 или не больше интервала истории - свечи истории без изменений
+    */
+    void setPaneKLinesDuration(qsizetype pane, qint64 duration);
+
+    /*!
+        Отображает событие детектирования во всех панелях
+        @param eventIndex - ИД события детектирования
+        @param detectData - данные события
+        @param overlays - события, свечи которых рисуются поверх свечей события
+    */
+    void setDetect(quint64 eventIndex, const TradingCatCommon::Detector::PKLineDetectData& detectData, const OverlayDetects& overlays = {});
+
+    /*!
+        Заранее готовит данные всех панелей для события детектирования, не изменяя отображение
+        @param eventIndex - ИД события детектирования
+        @param detectData - данные события
+    */
+    void prefetch(quint64 eventIndex, const TradingCatCommon::Detector::PKLineDetectData& detectData);
+
+private slots:
+    void paneMaxKLinesCountChanged();
+
+private:
+    MultiPaneChart() = delete;
+    Q_DISABLE_COPY_MOVE(MultiPaneChart);
+
+    struct Pane
+    {
+        CandlestickChart* chart = nullptr;
+        ChartDataCache::ESource source = ChartDataCache::ESource::HISTORY;
+        Style style;
+        qsizetype count = 0;
+        qint64 duration = 0;  ///< интервал свечей, мс. 0 - интервал истории
+    };
+
+    void showPane(Pane& pane);
+    PKLineBuffer paneKLines(const Pane& pane, quint64 eventIndex, const TradingCatCommon::Detector::PKLineDetectData& detectData);
+
+private:
+    ChartDataCache& _chartDataCache;
+
+    QVBoxLayout* _layout = nullptr;
+    std::vector<Pane> _panes;
+
+    quint64 _eventIndex = 0;  ///< ИД отображаемого события. 0 - событие не выбрано
+    TradingCatCommon::Detector::PKLineDetectData _detectData;
+    OverlayDetects _overlays;  ///< события, отображаемые поверх отображаемого события
+
+};
@@ -1,3 +1,6 @@
+//STL
+#include <algorithm>
+
 //Qt
 #include <QUrl>
 #include <QTimer>
@@ -18,6 +21,45 @@ Q_GLOBAL_STATIC_WITH_ARGS(const QUrl, SERVER_URL, (QUrl("https://tradingcat.ru")
 Q_GLOBAL_STATIC_WITH_ARGS(const QUrl, SERVER_URL, (QUrl("http://localhost:59923")));
 #endif
 
+//static
+qsizetype NetworkCore::maxAnswerSize(PackageType type)
+{
+    switch (type)
+    {
+    case PackageType::LOGIN:
+    case PackageType::CONFIG:
+    case PackageType::LOGOUT:
+        return 1024 * 1024;
+    case PackageType::STOCKEXCHANGES:
+        return 4 * 1024 * 1024;
+    case PackageType::KLINESIDLIST:
+        return 32 * 1024 * 1024;
+    case PackageType::DETECT:
+        return 128 * 1024 * 1024;
+    default:
+        Q_ASSERT(false);
+    }
+
+    return 0;
+}
+
+static QString packageTypeName(PackageType type)
+{
+    switch (type)
+    {
+    case PackageType::LOGIN: return "Login";
+    case PackageType::STOCKEXCHANGES: return "StockExchanges";
+    case PackageType::KLINESIDLIST: return "KLinesIDList";
+    case PackageType::CONFIG: return "Config";
+    case PackageType::LOGOUT: return "Logout";
+    case PackageType::DETECT: return "Detect";
+    default:
+        Q_ASSERT(false);
+    }
+
+    return "Undefined";
+}
+
 NetworkCore::NetworkCore(const LocalConfig &cfg)
     : _cfg(cfg)
 {
@@ -84,6 +126,17 @@ void NetworkCore::getAnswerHttp(const QByteArray& answer, quint64 id)
 
     _sentQuery.erase(it_sentQuery);
 
+    if (!checkAnswer(type, answer))
+    {
+        _sessionId = 0;
+
+        emit logout();
+
+        QTimer::singleShot(SEND_INTERVAL, this, [this](){ sendLogin(); });
+
+        return;
+    }
+
     bool res = false;
     switch (type)
     {
@@ -313,6 +366,38 @@ void NetworkCore::sendDetect()
     sendHTTPRequest(query);
 }
 
+bool NetworkCore::checkAnswer(TradingCatCommon::PackageType type, const QByteArray &answer)
+{
+    const auto maxSize = maxAnswerSize(type);
+    if (answer.size() > maxSize)
+    {
+        emit sendLogMsg(MSG_CODE::WARNING_CODE, QString("%1: Answer is too large: %2 bytes. Maximum: %3 bytes")
+                                                              .arg(packageTypeName(type))
+                                                              .arg(answer.size())
+                                                              .arg(maxSize));
+
+        return false;
+    }
+
+    //ответ должен быть JSON объектом. Все остальное отбрасываем без запуска разбора
+    const auto it_begin = std::find_if(answer.begin(), answer.end(),
+                                       [](char ch)
+                                       {
+                                           return ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n';
+                                       });
+    if (it_begin == answer.end() || *it_begin != '{')
+    {
+        emit sendLogMsg(MSG_CODE::WARNING_CODE, QString("%1: Answer is not a JSON object. Size: %2 bytes. Data: %3")
+                                                              .arg(packageTypeName(type))
+                                                              .arg(answer.size())
+                                                              .arg(answer.first(std::min<qsizetype>(answer.size(), 256))));
+
+        return false;
+    }
+
+    return true;
+}
+
 bool NetworkCore::parseLogin(const QByteArray &answer)
 {
     TradingCatCommon::Package<LoginAnswer> package(answer);
@@ -430,6 +515,13 @@ bool NetworkCore::parseKLinesIdList(const QByteArray &answer)
     const auto& klinesId = data.klinesIdList();
     const auto& stockExchangeID = data.stockExchangeId();
 
+    if (!klinesId)
+    {
+        emit sendLogMsg(MSG_CODE::WARNING_CODE, QString("KLinesIDList: KLines ID list is missing. Stock exchange: %1").arg(stockExchangeID.toString()));
+
+        return false;
+    }
+
     const auto it_unGetKLinesId =  _unGetKLinesId.find(stockExchangeID);
     if (it_unGetKLinesId == _unGetKLinesId.end())
     {
@@ -554,7 +646,21 @@ bool NetworkCore::parseDetect(const QByteArray &answer)
         return false;
     }
 
-    const auto& detectData = data.klinesDetectedList();
+    //в детектирование должны входить обе истории свечей и биржа, иначе событие нельзя отобразить
+    auto detectData = data.klinesDetectedList();
+    const auto removed = std::erase_if(detectData.detected,
+                                       [](const auto& detect)
+                                       {
+                                           return !detect
+                                                  || !detect->history || detect->history->empty()
+                                                  || !detect->reviewHistory || detect->reviewHistory->empty()
+                                                  || detect->stockExchangeId.isEmpty();
+                                       });
+    if (removed > 0)
+    {
+        emit sendLogMsg(MSG_CODE::WARNING_CODE, QString("Detect: Skip %1 malformed detections").arg(removed));
+    }
+
     if (detectData.detected.empty())
     {
         emit sendLogMsg(MSG_CODE::INFORMATION_CODE, QString("Detect: Successfully. Detect data list is empty. Skip. Server message: %1").arg(data.message()));
@@ -22,6 +22,8 @@ class NetworkCore
 {
     Q_OBJECT
 
+    friend class ParserBench;  ///< разбор ответов проверяется и замеряется в Bench/ParserBench
+
 public:
     explicit NetworkCore(const LocalConfig& cfg);
     ~NetworkCore() override;
@@ -87,6 +89,20 @@ private:
     void sendLogout();
     void sendDetect();
 
+    /*!
+        Проверяет ответ сервера до разбора: размер и то, что ответ является JSON объектом
+        @param type - тип запроса
+        @param answer - данные ответа
+        @return true - ответ можно разбирать
+    */
+    bool checkAnswer(TradingCatCommon::PackageType type, const QByteArray& answer);
+
+    /*!
+        @param type - тип запроса
+        @return максимальный размер ответа, байт
+    */
+    static qsizetype maxAnswerSize(TradingCatCommon::PackageType type);
+
     bool parseLogin(const QByteArray& answer);
     bool parseStockExchanges(const QByteArray& answer);
     bool parseKLinesIdList(const QByteArray& answer);
@@ -0,0 +1,252 @@
+//STL
+#include <algorithm>
+
+//Qt
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+#include "profiler.h"
+
+constexpr static const int LAG_TIMER_INTERVAL = 100; //ms
+
+//static
+Profiler &Profiler::instance()
+{
+    static Profiler profiler;
+
+    return profiler;
+}
+
+const char* Profiler::sectionName(ESection section) noexcept
+{
+    switch (section)
+    {
+    case ESection::KLINE_DETECT: return "klineDetectNetworkCore";
+    case ESection::APPEND_EVENTS: return "appendEvents";
+    case ESection::SHOW_CHART: return "showChart";
+    case ESection::SHOW_REVIEW_CHART: return "showReviewChart";
+    case ESection::MAIN_TAB_CHANGED: return "mainTabWidgetCurrentChanged";
+    case ESection::RESIZE: return "resizeEvent";
+    case ESection::CHART_PAINT: return "chartPaint";
+    case ESection::EVENT_LOOP_LAG: return "eventLoopLag";
+    case ESection::FRAME: return "frame";
+    case ESection::COUNT:
+    default:
+        Q_ASSERT(false);
+    }
+
+    return "";
+}
+
+EM_BOOL Profiler::animationFrame(double time, void *userData)
+{
+    auto profiler = static_cast<Profiler*>(userData);
+    if (!profiler->_isEnabled)
+    {
+        profiler->_lastFrameTime = 0.0;
+        profiler->_isFrameLoopRunning = false;
+
+        return EM_FALSE;
+    }
+
+    if (profiler->_lastFrameTime > 0.0)
+    {
+        const auto duration = static_cast<qint64>((time - profiler->_lastFrameTime) * 1000000.0);
+        profiler->addSample(ESection::FRAME, profiler->now() - duration, duration);
+    }
+
+    profiler->_lastFrameTime = time;
+
+    return EM_TRUE;
+}
+
+//Scope
+Profiler::Scope::Scope(ESection section)
+    : _section(section)
+    , _start(Profiler::instance().isEnabled() ? Profiler::instance().now() : -1)
+{
+}
+
+Profiler::Scope::~Scope()
+{
+    if (_start < 0)
+    {
+        return;
+    }
+
+    auto& profiler = Profiler::instance();
+    profiler.addSample(_section, _start, profiler.now() - _start);
+}
+
+//class
+Profiler::Profiler()
+{
+    _clock.start();
+
+    _milestones.reserve(MILESTONES_COUNT);
+
+    _lagTimer.setSingleShot(true);
+    _lagTimer.setInterval(LAG_TIMER_INTERVAL);
+    _lagTimer.callOnTimeout([this](){ lagTimerTimeout(); });
+}
+
+void Profiler::mark(const char *name)
+{
+    Q_CHECK_PTR(name);
+
+    if (static_cast<qsizetype>(_milestones.size()) >= MILESTONES_COUNT)
+    {
+        return;
+    }
+
+    const auto time = now();
+    _milestones.push_back({name, time});
+
+    qInfo() << "Startup milestone" << name << static_cast<double>(time) / 1000000.0 << "ms";
+}
+
+const std::vector<Profiler::Milestone> &Profiler::milestones() const noexcept
+{
+    return _milestones;
+}
+
+bool Profiler::isEnabled() const noexcept
+{
+    return _isEnabled;
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    if (_isEnabled == enabled)
+    {
+        return;
+    }
+
+    _isEnabled = enabled;
+
+    if (_isEnabled)
+    {
+        _lagTimerStart = now();
+        _lagTimer.start();
+
+        //цикл кадров останавливается сам на первом кадре после выключения профилировщика. Если выключение
+        //и включение произошли между кадрами, цикл еще работает и второй не запускается
+        if (!_isFrameLoopRunning)
+        {
+            _isFrameLoopRunning = true;
+
+            emscripten_request_animation_frame_loop(Profiler::animationFrame, this);
+        }
+    }
+    else
+    {
+        _lagTimer.stop();
+    }
+}
+
+qint64 Profiler::now() const
+{
+    return _clock.nsecsElapsed();
+}
+
+void Profiler::addSample(ESection section, qint64 start, qint64 duration)
+{
+    auto& samples = _samples[static_cast<size_t>(section)];
+
+    samples.samples[samples.next] = {start, duration};
+    samples.next = (samples.next + 1) % SAMPLES_COUNT;
+    samples.count = std::min(samples.count + 1, SAMPLES_COUNT);
+}
+
+Profiler::Statistic Profiler::statistic(ESection section) const
+{
+    const auto& samples = _samples[static_cast<size_t>(section)];
+
+    Statistic result;
+    result.count = samples.count;
+    if (samples.count == 0)
+    {
+        return result;
+    }
+
+    std::vector<qint64> durations;
+    durations.reserve(samples.count);
+    for (qsizetype position = 0; position < samples.count; ++position)
+    {
+        durations.push_back(samples.samples[position].duration);
+    }
+
+    const auto percentile = [&durations](double rank)
+    {
+        const auto it_nth = durations.begin() + static_cast<qsizetype>(rank * static_cast<double>(durations.size() - 1));
+        std::nth_element(durations.begin(), it_nth, durations.end());
+
+        return static_cast<double>(*it_nth) / 1000000.0;
+    };
+
+    result.p50 = percentile(0.5);
+    result.p99 = percentile(0.99);
+    result.max = static_cast<double>(*std::max_element(durations.begin(), durations.end())) / 1000000.0;
+
+    return result;
+}
+
+QByteArray Profiler::chromeTrace() const
+{
+    QJsonArray traceEvents;
+
+    for (quint8 section = 0; section < static_cast<quint8>(ESection::COUNT); ++section)
+    {
+        const auto& samples = _samples[section];
+        const auto name = QString(sectionName(static_cast<ESection>(section)));
+
+        //от самого старого замера к самому новому
+        const auto first = (samples.next - samples.count + SAMPLES_COUNT) % SAMPLES_COUNT;
+        for (qsizetype position = 0; position < samples.count; ++position)
+        {
+            const auto& sample = samples.samples[(first + position) % SAMPLES_COUNT];
+
+            QJsonObject traceEvent;
+            traceEvent.insert("name", name);
+            traceEvent.insert("ph", "X");
+            traceEvent.insert("pid", 1);
+            traceEvent.insert("tid", section + 1);
+            traceEvent.insert("ts", static_cast<double>(sample.start) / 1000.0);
+            traceEvent.insert("dur", static_cast<double>(sample.duration) / 1000.0);
+
+            traceEvents.append(traceEvent);
+        }
+    }
+
+    for (const auto& milestone: _milestones)
+    {
+        QJsonObject traceEvent;
+        traceEvent.insert("name", milestone.name);
+        traceEvent.insert("ph", "i");
+        traceEvent.insert("s", "g");
+        traceEvent.insert("pid", 1);
+        traceEvent.insert("tid", 0);
+        traceEvent.insert("ts", static_cast<double>(milestone.time) / 1000.0);
+
+        traceEvents.append(traceEvent);
+    }
+
+    QJsonObject trace;
+    trace.insert("traceEvents", traceEvents);
+    trace.insert("displayTimeUnit", "ms");
+
+    return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+}
+
+void Profiler::lagTimerTimeout()
+{
+    const auto current = now();
+    const auto lag = std::max<qint64>(0, current - _lagTimerStart - static_cast<qint64>(LAG_TIMER_INTERVAL) * 1000000);
+
+    addSample(ESection::EVENT_LOOP_LAG, current - lag, lag);
+
+    _lagTimerStart = current;
+    _lagTimer.start();
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+//STL
+#include <array>
+#include <vector>
+
+//Qt
+#include <QtGlobal>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTimer>
+
+//EM
+#include <emscripten/html5.h>
+
+/*!
+    Сбор времени выполнения горячих участков UI, задержки цикла событий, времени кадра и этапов запуска.
+    Отсчет времени начинается с первого обращения к instance(), поэтому его нужно выполнить в начале main().
+    По каждому участку хранится ограниченное количество последних замеров, поэтому память не растет.
+    Замеры выполняются только когда профилировщик включен. Используется только из основного потока
+*/
+class Profiler
+{
+public:
+    enum class ESection: quint8
+    {
+        KLINE_DETECT = 0,      ///< MainWindow::klineDetectNetworkCore
+        APPEND_EVENTS,         ///< добавление событий в список
+        SHOW_CHART,            ///< отображение основного графика
+        SHOW_REVIEW_CHART,     ///< отображение графика обзора
+        MAIN_TAB_CHANGED,      ///< MainWindow::mainTabWidgetCurrentChanged
+        RESIZE,                ///< MainWindow::resizeEvent
+        CHART_PAINT,           ///< отрисовка графика
+        EVENT_LOOP_LAG,        ///< задержка срабатывания таймера цикла событий
+        FRAME,                 ///< интервал между кадрами браузера
+        COUNT
+    };
+
+    /*!
+        Замер времени выполнения блока кода. Время записывается при выходе из блока
+    */
+    class Scope
+    {
+    public:
+        explicit Scope(ESection section);
+        ~Scope();
+
+    private:
+        Scope() = delete;
+        Q_DISABLE_COPY_MOVE(Scope);
+
+    private:
+        const ESection _section;
+        const qint64 _start = -1;  ///< время начала, нс. -1 - профилировщик выключен
+    };
+
+    struct Statistic
+    {
+        qsizetype count = 0;  ///< количество замеров в окне
+        double p50 = 0.0;     ///< медиана, мс
+        double p99 = 0.0;     ///< 99-й перцентиль, мс
+        double max = 0.0;     ///< максимум, мс
+    };
+
+    struct Milestone
+    {
+        const char* name = nullptr;  ///< имя этапа. Строка должна жить все время работы приложения
+        qint64 time = 0;             ///< время от запуска профилировщика, нс
+    };
+
+    static constexpr qsizetype SAMPLES_COUNT = 512;  ///< количество хранимых замеров по каждому участку
+    static constexpr qsizetype MILESTONES_COUNT = 64; ///< максимальное количество этапов запуска
+
+    static Profiler& instance();
+    static const char* sectionName(ESection section) noexcept;
+
+public:
+    bool isEnabled() const noexcept;
+
+    /*!
+        Включает или выключает замеры. При включении запускается замер задержки цикла событий и времени кадра
+        @param enabled - true - включить
+    */
+    void setEnabled(bool enabled);
+
+    /*!
+        @return текущее время профилировщика, нс
+    */
+    qint64 now() const;
+
+    /*!
+        Добавляет замер
+        @param section - участок
+        @param start - время начала, нс
+        @param duration - длительность, нс
+    */
+    void addSample(ESection section, qint64 start, qint64 duration);
+
+    /*!
+        Отмечает этап запуска приложения. Этапы записываются всегда, даже если профилировщик выключен
+        @param name - имя этапа. Строка должна жить все время работы приложения
+    */
+    void mark(const char* name);
+
+    const std::vector<Milestone>& milestones() const noexcept;
+
+    /*!
+        @param section - участок
+        @return статистика по последним замерам участка
+    */
+    Statistic statistic(ESection section) const;
+
+    /*!
+        @return все хранимые замеры и этапы запуска в формате Chrome trace event (JSON), пригодном для chrome://tracing и Perfetto
+    */
+    QByteArray chromeTrace() const;
+
+private:
+    Profiler();
+    Q_DISABLE_COPY_MOVE(Profiler);
+
+    struct Sample
+    {
+        qint64 start = 0;     ///< нс
+        qint64 duration = 0;  ///< нс
+    };
+
+    struct Samples
+    {
+        std::array<Sample, SAMPLES_COUNT> samples;
+        qsizetype next = 0;   ///< позиция следующего замера
+        qsizetype count = 0;  ///< количество замеров
+    };
+
+    static EM_BOOL animationFrame(double time, void* userData);
+
+    void lagTimerTimeout();
+
+private:
+    bool _isEnabled = false;
+
+    QElapsedTimer _clock;
+    std::array<Samples, static_cast<size_t>(ESection::COUNT)> _samples;
+    std::vector<Milestone> _milestones;  ///< этапы запуска в порядке возникновения
+
+    QTimer _lagTimer;            ///< таймер замера задержки цикла событий
+    qint64 _lagTimerStart = 0;   ///< время запуска таймера задержки, нс
+    double _lastFrameTime = 0.0; ///< время предыдущего кадра браузера, мс. 0 - кадров еще не было
+    bool _isFrameLoopRunning = false;  ///< цикл кадров запущен и еще не остановлен
+
+};
@@ -0,0 +1,138 @@
+//Qt
+#include <QGridLayout>
+#include <QPushButton>
+#include <QFileDialog>
+#include <QStringList>
+
+#include "profileroverlay.h"
+
+constexpr static const int UPDATE_INTERVAL = 500; //ms
+
+ProfilerOverlay::ProfilerOverlay(QWidget *parent)
+    : QWidget(parent)
+{
+    Q_CHECK_PTR(parent);
+
+    setAttribute(Qt::WA_StyledBackground);
+    setStyleSheet("ProfilerOverlay { background-color: rgba(0, 0, 0, 180); } QLabel { color: white; font-family: monospace; }");
+
+    auto layout = new QGridLayout(this);
+    layout->setContentsMargins(8, 8, 8, 8);
+    layout->setHorizontalSpacing(12);
+
+    const auto makeLabel = [this](const QString& text)
+    {
+        auto label = new QLabel(text, this);
+        label->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+
+        return label;
+    };
+
+    layout->addWidget(new QLabel("Section", this), 0, 0);
+    layout->addWidget(makeLabel("Count"), 0, 1);
+    layout->addWidget(makeLabel("p50, ms"), 0, 2);
+    layout->addWidget(makeLabel("p99, ms"), 0, 3);
+    layout->addWidget(makeLabel("Max, ms"), 0, 4);
+
+    for (quint8 section = 0; section < static_cast<quint8>(Profiler::ESection::COUNT); ++section)
+    {
+        const auto row = section + 1;
+        auto& labels = _labels[section];
+
+        layout->addWidget(new QLabel(Profiler::sectionName(static_cast<Profiler::ESection>(section)), this), row, 0);
+
+        labels.count = makeLabel("0");
+        labels.p50 = makeLabel("-");
+        labels.p99 = makeLabel("-");
+        labels.max = makeLabel("-");
+
+        layout->addWidget(labels.count, row, 1);
+        layout->addWidget(labels.p50, row, 2);
+        layout->addWidget(labels.p99, row, 3);
+        layout->addWidget(labels.max, row, 4);
+    }
+
+    const auto lastRow = static_cast<int>(Profiler::ESection::COUNT) + 1;
+
+    _milestonesLabel = new QLabel(this);
+    layout->addWidget(_milestonesLabel, lastRow, 0, 1, 5);
+
+    auto exportPushButton = new QPushButton("Export trace", this);
+    layout->addWidget(exportPushButton, lastRow + 1, 0, 1, 5);
+
+    QObject::connect(exportPushButton, SIGNAL(clicked()), SLOT(exportPushButtonClicked()));
+
+    _updateTimer = new QTimer(this);
+    _updateTimer->setInterval(UPDATE_INTERVAL);
+
+    QObject::connect(_updateTimer, SIGNAL(timeout()), SLOT(updateTimerTimeout()));
+
+    hide();
+}
+
+void ProfilerOverlay::toggle()
+{
+    const auto enabled = isHidden();
+
+    Profiler::instance().setEnabled(enabled);
+
+    if (enabled)
+    {
+        updateTimerTimeout();
+
+        adjustSize();
+        move(parentWidget()->width() - width() - 8, 8);
+        raise();
+        show();
+
+        _updateTimer->start();
+    }
+    else
+    {
+        _updateTimer->stop();
+
+        hide();
+    }
+}
+
+void ProfilerOverlay::updateTimerTimeout()
+{
+    const auto& profiler = Profiler::instance();
+
+    for (quint8 section = 0; section < static_cast<quint8>(Profiler::ESection::COUNT); ++section)
+    {
+        const auto statistic = profiler.statistic(static_cast<Profiler::ESection>(section));
+        auto& labels = _labels[section];
+
+        labels.count->setText(QString::number(statistic.count));
+        if (statistic.count == 0)
+        {
+            continue;
+        }
+
+        labels.p50->setText(QString::number(statistic.p50, 'f', 2));
+        labels.p99->setText(QString::number(statistic.p99, 'f', 2));
+        labels.max->setText(QString::number(statistic.max, 'f', 2));
+    }
+
+    //этапы запуска только добавляются, поэтому текст перестраивается только при появлении новых
+    const auto& milestones = profiler.milestones();
+    if (static_cast<qsizetype>(milestones.size()) != _milestonesCount)
+    {
+        _milestonesCount = static_cast<qsizetype>(milestones.size());
+
+        QStringList lines;
+        for (const auto& milestone: milestones)
+        {
+            lines.push_back(QString("%1: %2 ms").arg(milestone.name).arg(static_cast<double>(milestone.time) / 1000000.0, 0, 'f', 1));
+        }
+
+        _milestonesLabel->setText(lines.join('\n'));
+        adjustSize();
+    }
+}
+
+void ProfilerOverlay::exportPushButtonClicked()
+{
+    QFileDialog::saveFileContent(Profiler::instance().chromeTrace(), "trace.json");
+}
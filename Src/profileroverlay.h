@@ -0,0 +1,54 @@
+#pragma once
+
+//STL
+#include <array>
+
+//Qt
+#include <QWidget>
+#include <QLabel>
+#include <QTimer>
+
+//My
+#include "profiler.h"
+
+/*!
+    Полупрозрачная панель поверх главного окна со статистикой профилировщика (p50/p99/max по участкам),
+    этапами запуска и кнопкой выгрузки замеров в формате Chrome trace. Пока панель видна, профилировщик включен
+*/
+class ProfilerOverlay
+    : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ProfilerOverlay(QWidget *parent);
+
+    /*!
+        Показывает или скрывает панель и включает или выключает профилировщик
+    */
+    void toggle();
+
+private slots:
+    void updateTimerTimeout();
+    void exportPushButtonClicked();
+
+private:
+    ProfilerOverlay() = delete;
+    Q_DISABLE_COPY_MOVE(ProfilerOverlay);
+
+    struct SectionLabels
+    {
+        QLabel* count = nullptr;
+        QLabel* p50 = nullptr;
+        QLabel* p99 = nullptr;
+        QLabel* max = nullptr;
+    };
+
+private:
+    std::array<SectionLabels, static_cast<size_t>(Profiler::ESection::COUNT)> _labels;
+    QLabel* _milestonesLabel = nullptr;  ///< этапы запуска
+    qsizetype _milestonesCount = 0;      ///< количество отображаемых этапов запуска
+
+    QTimer* _updateTimer = nullptr;  ///< таймер обновления статистики
+
+};
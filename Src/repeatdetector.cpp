@@ -0,0 +1,182 @@
+//STL
+#include <algorithm>
+#include <limits>
+
+#include "repeatdetector.h"
+
+static const quint32 LEVEL2_HITS_15MIN = 3;
+static const quint32 LEVEL3_HITS_1HOUR = 6;
+
+quint8 RepeatDetector::Result::starLevel() const noexcept
+{
+    if (hits1hour >= LEVEL3_HITS_1HOUR)
+    {
+        return 3;
+    }
+    if (hits15min >= LEVEL2_HITS_15MIN)
+    {
+        return 2;
+    }
+
+    return isRepeat ? 1 : 0;
+}
+
+RepeatDetector::Result RepeatDetector::add(InternTable::ID stockExchangeId, InternTable::ID symbolId, qint64 time)
+{
+    const auto minute = time / SLOT_DURATION;
+
+    Result result;
+
+    //слишком старое детектирование уже вышло за пределы колеса
+    if (minute + WHEEL_SIZE <= _wheelMinute)
+    {
+        return result;
+    }
+
+    advance(minute);
+
+    const auto key = makeKey(stockExchangeId, symbolId);
+    auto [it_entries, isNew] = _entries.try_emplace(key);
+    auto& entry = it_entries->second;
+
+    bool isMoved = isNew;
+    if (isNew)
+    {
+        entry.firstSeen = time;
+        entry.lastSeen = time;
+        entry.lastMinute = minute;
+        entry.streak = 1;
+    }
+    else
+    {
+        result.isRepeat = (time - entry.lastSeen) < STREAK_TIMEOUT;
+        if (result.isRepeat)
+        {
+            ++entry.streak;
+        }
+        else
+        {
+            entry.firstSeen = time;
+            entry.streak = 1;
+        }
+
+        if (minute > entry.lastMinute)
+        {
+            //обнуляем счетчики минут, прошедших с последнего детектирования
+            const auto steps = std::min<qint64>(minute - entry.lastMinute, WHEEL_SIZE);
+            for (qint64 step = 1; step <= steps; ++step)
+            {
+                entry.counts[(entry.lastMinute + step) % WHEEL_SIZE] = 0;
+            }
+
+            entry.lastMinute = minute;
+            isMoved = true;
+        }
+
+        entry.lastSeen = std::max(entry.lastSeen, time);
+    }
+
+    if (entry.lastMinute - minute < WHEEL_SIZE)
+    {
+        auto& count = entry.counts[minute % WHEEL_SIZE];
+        if (count < std::numeric_limits<quint16>::max())
+        {
+            ++count;
+        }
+    }
+
+    if (isMoved)
+    {
+        _wheel[entry.lastMinute % WHEEL_SIZE].push_back(key);
+    }
+
+    result.firstSeen = entry.firstSeen;
+    result.streak = entry.streak;
+    result.hits5min = entryHits(entry, minute, 5);
+    result.hits15min = entryHits(entry, minute, 15);
+    result.hits1hour = entryHits(entry, minute, WHEEL_SIZE);
+
+    return result;
+}
+
+quint32 RepeatDetector::hits(InternTable::ID stockExchangeId, InternTable::ID symbolId, qint64 time, qsizetype minutes) const
+{
+    const auto it_entries = _entries.find(makeKey(stockExchangeId, symbolId));
+    if (it_entries == _entries.end())
+    {
+        return 0;
+    }
+
+    return entryHits(it_entries->second, time / SLOT_DURATION, minutes);
+}
+
+qsizetype RepeatDetector::size() const noexcept
+{
+    return static_cast<qsizetype>(_entries.size());
+}
+
+void RepeatDetector::clear()
+{
+    _entries.clear();
+    for (auto& slot: _wheel)
+    {
+        slot.clear();
+    }
+    _wheelMinute = 0;
+}
+
+RepeatDetector::Key RepeatDetector::makeKey(InternTable::ID stockExchangeId, InternTable::ID symbolId) noexcept
+{
+    return (static_cast<Key>(stockExchangeId) << 32) | symbolId;
+}
+
+quint32 RepeatDetector::entryHits(const Entry &entry, qint64 minute, qsizetype minutes)
+{
+    Q_ASSERT(minutes > 0 && minutes <= WHEEL_SIZE);
+
+    //счетчики после entry.lastMinute равны нулю, а старше entry.lastMinute - WHEEL_SIZE уже перезаписаны
+    const auto from = std::max(minute - minutes + 1, entry.lastMinute - WHEEL_SIZE + 1);
+    const auto to = std::min(minute, entry.lastMinute);
+
+    quint32 result = 0;
+    for (auto current = from; current <= to; ++current)
+    {
+        result += entry.counts[current % WHEEL_SIZE];
+    }
+
+    return result;
+}
+
+void RepeatDetector::advance(qint64 minute)
+{
+    if (_wheelMinute == 0)
+    {
+        _wheelMinute = minute;
+
+        return;
+    }
+
+    if (minute <= _wheelMinute)
+    {
+        return;
+    }
+
+    //освобождаем слоты, которые будут заняты новыми минутами, удаляя пары без детектирований за весь период колеса
+    const auto steps = std::min<qint64>(minute - _wheelMinute, WHEEL_SIZE);
+    for (qint64 step = 1; step <= steps; ++step)
+    {
+        auto& slot = _wheel[(_wheelMinute + step) % WHEEL_SIZE];
+        for (const auto key: slot)
+        {
+            const auto it_entries = _entries.find(key);
+            if (it_entries != _entries.end() && it_entries->second.lastMinute <= minute - WHEEL_SIZE)
+            {
+                _entries.erase(it_entries);
+            }
+        }
+
+        slot.clear();
+    }
+
+    _wheelMinute = minute;
+}
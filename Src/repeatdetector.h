@@ -0,0 +1,96 @@
+#pragma once
+
+//STL
+#include <array>
+#include <vector>
+#include <unordered_map>
+
+//Qt
+#include <QtGlobal>
+
+//My
+#include "interntable.h"
+
+/*!
+    Учет повторных детектирований одной и той же свечи на одной бирже.
+    Хранит по каждой паре (биржа, символ) поминутные счетчики за последний час. Пары, которые не детектировались
+    дольше часа удаляются по мере поворота колеса времени, поэтому объем памяти ограничен количеством пар,
+    активных за последний час.
+*/
+class RepeatDetector
+{
+public:
+    static constexpr qsizetype WHEEL_SIZE = 60;          ///< глубина истории, минут
+    static constexpr qint64 SLOT_DURATION = 60 * 1000;   ///< длительность одного слота, мс
+    static constexpr qint64 STREAK_TIMEOUT = 5 * 60 * 1000; ///< максимальный интервал между детектированиями одной серии, мс
+
+    struct Result
+    {
+        bool isRepeat = false;  ///< предыдущее детектирование было не позднее STREAK_TIMEOUT назад
+        qint64 firstSeen = 0;   ///< время начала текущей серии детектирований, мс
+        quint32 streak = 0;     ///< количество детектирований в текущей серии
+        quint32 hits5min = 0;   ///< количество детектирований за последние 5 минут
+        quint32 hits15min = 0;  ///< количество детектирований за последние 15 минут
+        quint32 hits1hour = 0;  ///< количество детектирований за последний час
+
+        /*!
+            @return уровень "звездности" события от 0 (первое детектирование) до 3 (частые повторы)
+        */
+        quint8 starLevel() const noexcept;
+    };
+
+public:
+    RepeatDetector() = default;
+
+    /*!
+        Регистрирует детектирование
+        @param stockExchangeId - ИД биржи
+        @param symbolId - ИД символа
+        @param time - время детектирования, мс
+        @return статистика с учетом текущего детектирования
+    */
+    Result add(InternTable::ID stockExchangeId, InternTable::ID symbolId, qint64 time);
+
+    /*!
+        Количество детектирований за последние minutes минут
+        @param stockExchangeId - ИД биржи
+        @param symbolId - ИД символа
+        @param time - текущее время, мс
+        @param minutes - глубина, минут. Не более WHEEL_SIZE
+        @return количество детектирований
+    */
+    quint32 hits(InternTable::ID stockExchangeId, InternTable::ID symbolId, qint64 time, qsizetype minutes) const;
+
+    /*!
+        @return количество отслеживаемых пар (биржа, символ)
+    */
+    qsizetype size() const noexcept;
+
+    void clear();
+
+private:
+    Q_DISABLE_COPY_MOVE(RepeatDetector);
+
+    using Key = quint64;
+
+    struct Entry
+    {
+        qint64 firstSeen = 0;
+        qint64 lastSeen = 0;
+        qint64 lastMinute = 0;  ///< абсолютный номер минуты последнего детектирования
+        quint32 streak = 0;
+        std::array<quint16, WHEEL_SIZE> counts = {}; ///< поминутные счетчики. Индекс - минута % WHEEL_SIZE
+    };
+
+    static Key makeKey(InternTable::ID stockExchangeId, InternTable::ID symbolId) noexcept;
+    static quint32 entryHits(const Entry& entry, qint64 minute, qsizetype minutes);
+
+    void advance(qint64 minute);
+
+private:
+    std::unordered_map<Key, Entry> _entries;
+
+    std::array<std::vector<Key>, WHEEL_SIZE> _wheel; ///< пары, детектированные в соответсвующую минуту
+    qint64 _wheelMinute = 0;                         ///< абсолютный номер текущей минуты колеса
+
+};
@@ -0,0 +1,372 @@
+//Qt
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "sessionstore.h"
+
+using namespace emscripten;
+using namespace TradingCatCommon;
+
+static const quint64 CHUNK_SIZE = 10;  ///< количество событий в одном блоке
+static const quint64 MAX_EVENTS = 100; ///< максимальное количество сохраняемых событий
+static const quint64 MAX_CHUNKS = MAX_EVENTS / CHUNK_SIZE;
+
+constexpr static const int FLUSH_DELAY = 1000;   //ms
+
+static const quint8 RECORD_VERSION = 2;
+
+static SessionStore* sessionStoreInstance = nullptr;   ///< хранилище, записываемое при закрытии страницы
+
+Q_GLOBAL_STATIC_WITH_ARGS(const QString, INDEX_KEY, ("session_index"));
+Q_GLOBAL_STATIC_WITH_ARGS(const QString, CURRENT_KEY, ("session_current"));
+Q_GLOBAL_STATIC_WITH_ARGS(const QString, CHUNK_KEY, ("session_chunk_%1"));
+Q_GLOBAL_STATIC_WITH_ARGS(const QString, RECORD_SEPARATOR, (";"));
+
+// localStorage.setItem() бросает исключение при переполнении квоты. Перехватываем его на стороне JS
+EM_JS(int, sessionStoreSetItem, (const char* key, const char* value), {
+    try
+    {
+        window.localStorage.setItem(UTF8ToString(key), UTF8ToString(value));
+        return 1;
+    }
+    catch (e)
+    {
+        return 0;
+    }
+});
+
+static void writeKLines(QDataStream& stream, const PKLinesList& klines)
+{
+    Q_CHECK_PTR(klines);
+    Q_ASSERT(!klines->empty());
+
+    const auto& klineId = klines->front()->id;
+
+    stream << klineId.symbol.name << static_cast<qint64>(klineId.type) << static_cast<quint32>(klines->size());
+    for (const auto& kline: *klines)
+    {
+        stream << kline->closeTime << kline->open << kline->high << kline->low << kline->close << kline->volume;
+    }
+}
+
+static PKLinesList readKLines(QDataStream& stream)
+{
+    QString symbol;
+    qint64 type = 0;
+    quint32 count = 0;
+    stream >> symbol >> type >> count;
+
+    if (stream.status() != QDataStream::Ok || count == 0 || count > KLINES_COUNT_HISTORY * 2)
+    {
+        return nullptr;
+    }
+
+    const KLineID klineId(Symbol(symbol), static_cast<KLineType>(type));
+
+    auto klines = std::make_shared<KLinesList>();
+    for (quint32 i = 0; i < count; ++i)
+    {
+        auto kline = std::make_shared<KLine>();
+        kline->id = klineId;
+        stream >> kline->closeTime >> kline->open >> kline->high >> kline->low >> kline->close >> kline->volume;
+
+        klines->push_back(std::move(kline));
+    }
+
+    return stream.status() == QDataStream::Ok ? klines : nullptr;
+}
+
+//static
+const char* SessionStore::beforeUnload(int eventType, const void *reserved, void *userData)
+{
+    Q_UNUSED(eventType);
+    Q_UNUSED(reserved);
+    Q_UNUSED(userData);
+
+    if (sessionStoreInstance != nullptr)
+    {
+        sessionStoreInstance->flush();
+    }
+
+    return nullptr;
+}
+
+//class
+SessionStore::SessionStore()
+{
+    Q_ASSERT(sessionStoreInstance == nullptr);
+
+    sessionStoreInstance = this;
+
+    _localStorage = val::global("window")["localStorage"];
+
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(FLUSH_DELAY);
+    _flushTimer.callOnTimeout([this](){ flush(); });
+
+    //обработчик работает через sessionStoreInstance и не снимается: снятие удалило бы все обработчики beforeunload,
+    //в том числе обработчики LocalConfig и DetectJournal
+    emscripten_set_beforeunload_callback(nullptr, SessionStore::beforeUnload);
+
+    const auto index = loadValue(*INDEX_KEY).split(':');
+    if (index.size() == 2)
+    {
+        bool okHead = false;
+        bool okTail = false;
+        _head = index[0].toULongLong(&okHead);
+        _tail = index[1].toULongLong(&okTail);
+        if (!okHead || !okTail || _head > _tail)
+        {
+            _head = 0;
+            _tail = 0;
+        }
+    }
+
+    const auto tailChunk = loadValue(CHUNK_KEY->arg(_tail));
+    if (!tailChunk.isEmpty())
+    {
+        _tailRecords = tailChunk.split(*RECORD_SEPARATOR, Qt::SkipEmptyParts);
+    }
+}
+
+SessionStore::~SessionStore()
+{
+    flush();
+
+    sessionStoreInstance = nullptr;
+}
+
+SessionStore::RestoreResult SessionStore::restore(qint64 timeBudget)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    RestoreResult result;
+
+    //читаем блоки от новых к старым, чтобы при нехватке времени потерять самые старые события
+    std::vector<std::vector<Detector::PKLineDetectData>> chunks;
+    for (quint64 chunk = _tail + 1; chunk > _head; --chunk)
+    {
+        if (timer.elapsed() > timeBudget)
+        {
+            qWarning() << "Session restore: time budget exceeded. Skip" << chunk - _head << "chunk(s)";
+
+            break;
+        }
+
+        const auto records = chunk - 1 == _tail ? _tailRecords : loadValue(CHUNK_KEY->arg(chunk - 1)).split(*RECORD_SEPARATOR, Qt::SkipEmptyParts);
+
+        auto& detected = chunks.emplace_back();
+        detected.reserve(records.size());
+        for (const auto& record: records)
+        {
+            auto detectData = decode(record.toLatin1());
+            if (detectData)
+            {
+                detected.push_back(std::move(detectData));
+            }
+        }
+    }
+
+    const auto currentKey = loadValue(*CURRENT_KEY);
+    for (auto it_chunks = chunks.rbegin(); it_chunks != chunks.rend(); ++it_chunks)
+    {
+        for (auto& detectData: *it_chunks)
+        {
+            if (!currentKey.isEmpty() && detectKey(detectData) == currentKey)
+            {
+                result.currentPosition = static_cast<qsizetype>(result.detected.size());
+            }
+
+            result.detected.push_back(std::move(detectData));
+        }
+    }
+
+    qInfo() << "Session restore:" << result.detected.size() << "event(s) for" << timer.elapsed() << "ms";
+
+    return result;
+}
+
+void SessionStore::append(const QByteArray &record)
+{
+    Q_ASSERT(!record.isEmpty());
+
+    if (static_cast<quint64>(_tailRecords.size()) >= CHUNK_SIZE)
+    {
+        flush();
+
+        ++_tail;
+        _tailRecords.clear();
+
+        while (_tail - _head >= MAX_CHUNKS)
+        {
+            removeHead();
+        }
+
+        saveIndex();
+    }
+
+    _tailRecords.push_back(QString::fromLatin1(record));
+    _isTailChanged = true;
+
+    //при потоке событий блок перезаписывается один раз за FLUSH_DELAY, а не на каждое событие
+    if (!_flushTimer.isActive())
+    {
+        _flushTimer.start();
+    }
+}
+
+void SessionStore::flush()
+{
+    _flushTimer.stop();
+
+    if (_isTailChanged)
+    {
+        _isTailChanged = false;
+
+        saveTail();
+    }
+
+    if (_isCurrentChanged)
+    {
+        _isCurrentChanged = false;
+
+        saveValue(*CURRENT_KEY, _current);
+    }
+}
+
+void SessionStore::setCurrent(const TradingCatCommon::Detector::PKLineDetectData &detectData)
+{
+    Q_CHECK_PTR(detectData);
+
+    //выбор меняется на каждый клик и шаг по серии, поэтому записывается вместе с текущим блоком
+    _current = detectKey(detectData);
+    _isCurrentChanged = true;
+
+    if (!_flushTimer.isActive())
+    {
+        _flushTimer.start();
+    }
+}
+
+QString SessionStore::detectKey(const TradingCatCommon::Detector::PKLineDetectData &detectData)
+{
+    const auto& kline = detectData->history->front();
+
+    return QString("%1:%2:%3").arg(detectData->stockExchangeId.name).arg(kline->id.symbol.name).arg(kline->closeTime);
+}
+
+QByteArray SessionStore::encode(const TradingCatCommon::Detector::PKLineDetectData &detectData)
+{
+    QByteArray data;
+    {
+        QDataStream stream(&data, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_6_0);
+
+        stream << RECORD_VERSION << detectData->stockExchangeId.name
+               << static_cast<double>(detectData->delta) << static_cast<double>(detectData->volume);
+
+        writeKLines(stream, detectData->history);
+        writeKLines(stream, detectData->reviewHistory);
+    }
+
+    return qCompress(data).toBase64();
+}
+
+TradingCatCommon::Detector::PKLineDetectData SessionStore::decode(const QByteArray &data)
+{
+    const auto uncompressData = qUncompress(QByteArray::fromBase64(data));
+    if (uncompressData.isEmpty())
+    {
+        return nullptr;
+    }
+
+    QDataStream stream(uncompressData);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint8 version = 0;
+    stream >> version;
+
+    QString stockExchangeName;
+    double delta = 0.0;
+    double volume = 0.0;
+    stream >> stockExchangeName >> delta >> volume;
+
+    if (stream.status() != QDataStream::Ok || version != RECORD_VERSION || stockExchangeName.isEmpty())
+    {
+        return nullptr;
+    }
+
+    auto detectData = std::make_shared<Detector::KLineDetectData>();
+    detectData->stockExchangeId = StockExchangeID(stockExchangeName);
+    detectData->delta = delta;
+    detectData->volume = volume;
+    detectData->history = readKLines(stream);
+    detectData->reviewHistory = readKLines(stream);
+
+    if (!detectData->history || !detectData->reviewHistory)
+    {
+        return nullptr;
+    }
+
+    return detectData;
+}
+
+void SessionStore::saveTail()
+{
+    const auto chunk = _tailRecords.join(*RECORD_SEPARATOR);
+
+    //при переполнении квоты освобождаем место за счет самых старых блоков
+    while (!saveValue(CHUNK_KEY->arg(_tail), chunk))
+    {
+        if (_head == _tail)
+        {
+            qWarning() << "Session store: localStorage quota exceeded. Event is not saved";
+
+            return;
+        }
+
+        removeHead();
+        saveIndex();
+    }
+}
+
+void SessionStore::removeHead()
+{
+    Q_ASSERT(_head < _tail);
+
+    removeValue(CHUNK_KEY->arg(_head));
+    ++_head;
+}
+
+void SessionStore::saveIndex()
+{
+    saveValue(*INDEX_KEY, QString("%1:%2").arg(_head).arg(_tail));
+}
+
+bool SessionStore::saveValue(const QString &key, const QString &value)
+{
+    const std::string keyString = key.toStdString();
+    const std::string valueString = value.toStdString();
+
+    return sessionStoreSetItem(keyString.c_str(), valueString.c_str()) != 0;
+}
+
+QString SessionStore::loadValue(const QString &key)
+{
+    const std::string keyString = key.toStdString();
+    const emscripten::val value = _localStorage.call<val>("getItem", keyString);
+    if (value.isNull())
+    {
+        return "";
+    }
+
+    return QString::fromStdString(value.as<std::string>());
+}
+
+void SessionStore::removeValue(const QString &key)
+{
+    const std::string keyString = key.toStdString();
+    _localStorage.call<void>("removeItem", keyString);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+//STL
+#include <vector>
+
+//Qt
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QTimer>
+
+//EM
+#include <emscripten.h>
+#include <emscripten/html5.h>
+#include <emscripten/val.h>
+
+//My
+#include <TradingCatCommon/detector.h>
+
+/*!
+    Хранилище событий текущей сессии в localStorage браузера. События дописываются в конец журнала
+    небольшими блоками (chunk), поэтому каждая запись перезаписывает только последний блок, а не весь журнал.
+    Текущий блок записывается отложенно, одной записью на серию событий, и при закрытии страницы.
+    Журнал ограничен MAX_EVENTS событиями - самые старые блоки удаляются целиком.
+*/
+class SessionStore
+{
+public:
+    struct RestoreResult
+    {
+        std::vector<TradingCatCommon::Detector::PKLineDetectData> detected; ///< восстановленные события в порядке поступления
+        qsizetype currentPosition = -1;                                       ///< позиция выбранного события в detected или -1
+    };
+
+public:
+    /*!
+        Кодирует событие в сжатую запись base64. Используется также журналом событий
+        @param detectData - событие
+        @return запись события
+    */
+    static QByteArray encode(const TradingCatCommon::Detector::PKLineDetectData& detectData);
+
+    /*!
+        @param data - запись события, полученная encode()
+        @return событие или nullptr, если запись повреждена
+    */
+    static TradingCatCommon::Detector::PKLineDetectData decode(const QByteArray& data);
+
+public:
+    SessionStore();
+    ~SessionStore();
+
+    /*!
+        Восстанавливает события из localStorage начиная с самых новых
+        @param timeBudget - максимальное время восстановления, мс. Блоки не уложившиеся в бюджет пропускаются
+        @return восстановленные события
+    */
+    RestoreResult restore(qint64 timeBudget);
+
+    /*!
+        Дописывает событие в конец журнала
+        @param record - запись события, полученная encode(). Та же запись передается журналу событий
+    */
+    void append(const QByteArray& record);
+
+    /*!
+        Записывает в localStorage отложенные события и выбранное событие
+    */
+    void flush();
+
+    /*!
+        Запоминает выбранное пользователем событие. Записывается отложенно, как и текущий блок
+        @param detectData - событие
+    */
+    void setCurrent(const TradingCatCommon::Detector::PKLineDetectData& detectData);
+
+private:
+    Q_DISABLE_COPY_MOVE(SessionStore);
+
+    static QString detectKey(const TradingCatCommon::Detector::PKLineDetectData& detectData);
+    static const char* beforeUnload(int eventType, const void* reserved, void* userData);
+
+    void saveTail();
+    void removeHead();
+    void saveIndex();
+
+    bool saveValue(const QString& key, const QString& value);
+    QString loadValue(const QString& key);
+    void removeValue(const QString& key);
+
+private:
+    emscripten::val _localStorage;
+
+    quint64 _head = 0;        ///< номер самого старого сохраненного блока
+    quint64 _tail = 0;        ///< номер текущего (дописываемого) блока
+    QStringList _tailRecords; ///< записи текущего блока
+    bool _isTailChanged = false;     ///< текущий блок еще не записан
+
+    QString _current;                ///< ключ выбранного события
+    bool _isCurrentChanged = false;  ///< выбранное событие еще не записано
+
+    QTimer _flushTimer;       ///< таймер отложенной записи текущего блока и выбранного события
+
+};
@@ -0,0 +1,127 @@
+//STL
+#include <algorithm>
+
+//Qt
+#include <QGridLayout>
+#include <QDateTime>
+#include <QStringList>
+
+#include "statisticswidget.h"
+
+constexpr static const int UPDATE_INTERVAL = 1000; //ms
+constexpr static const qsizetype BAR_WIDTH = 30;   ///< длина самого длинного столбца гистограммы, символов
+
+StatisticsWidget::StatisticsWidget(DetectStatistics &detectStatistics, ExchangeRegistry &exchangeRegistry, QWidget *parent)
+    : QWidget(parent)
+    , _detectStatistics(detectStatistics)
+    , _exchangeRegistry(exchangeRegistry)
+{
+    Q_CHECK_PTR(parent);
+
+    setStyleSheet("QLabel { color: white; font-family: monospace; }");
+
+    auto layout = new QGridLayout(this);
+    layout->setHorizontalSpacing(24);
+
+    for (quint8 window = 0; window < static_cast<quint8>(DetectStatistics::EWindow::COUNT); ++window)
+    {
+        auto title = new QLabel(QString("Last %1").arg(DetectStatistics::windowName(static_cast<DetectStatistics::EWindow>(window))), this);
+        layout->addWidget(title, 0, window);
+
+        auto label = new QLabel(this);
+        label->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+        layout->addWidget(label, 1, window);
+
+        _labels[window] = label;
+    }
+
+    layout->setRowStretch(1, 1);
+
+    _updateTimer = new QTimer(this);
+    _updateTimer->setInterval(UPDATE_INTERVAL);
+
+    QObject::connect(_updateTimer, SIGNAL(timeout()), SLOT(updateTimerTimeout()));
+}
+
+void StatisticsWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+
+    updateTimerTimeout();
+
+    _updateTimer->start();
+}
+
+void StatisticsWidget::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+
+    _updateTimer->stop();
+}
+
+void StatisticsWidget::updateTimerTimeout()
+{
+    //без новых детектирований окна сдвигаются только здесь
+    _detectStatistics.advance(QDateTime::currentMSecsSinceEpoch());
+
+    for (quint8 window = 0; window < static_cast<quint8>(DetectStatistics::EWindow::COUNT); ++window)
+    {
+        _labels[window]->setText(makeText(_detectStatistics.statistic(static_cast<DetectStatistics::EWindow>(window))));
+    }
+}
+
+QString StatisticsWidget::makeText(const DetectStatistics::Statistic &statistic)
+{
+    QStringList lines;
+    lines.push_back(QString("Detections: %1").arg(statistic.total));
+
+    lines.push_back("");
+    lines.push_back("Stock exchanges:");
+    for (size_t stockExchangeId = 0; stockExchangeId < statistic.stockExchanges.size(); ++stockExchangeId)
+    {
+        const auto count = statistic.stockExchanges[stockExchangeId];
+        if (count == 0)
+        {
+            continue;
+        }
+
+        lines.push_back(QString("  %1 %2")
+                            .arg(_exchangeRegistry.info(static_cast<InternTable::ID>(stockExchangeId)).displayName, -16)
+                            .arg(count, 8));
+    }
+
+    lines.push_back("");
+    lines.push_back(QString("Top %1 symbols:").arg(DetectStatistics::TOP_COUNT));
+
+    const auto& internTable = InternTable::instance();
+    for (const auto& topSymbol: statistic.top)
+    {
+        lines.push_back(QString("  %1 %2 %3")
+                            .arg(_exchangeRegistry.info(topSymbol.stockExchangeId).displayName, -16)
+                            .arg(internTable.symbolName(topSymbol.symbolId), -16)
+                            .arg(topSymbol.count, 8));
+    }
+
+    const auto addHistogram = [&lines](const QString& title, const auto& histogram, const auto& bucketName)
+    {
+        const auto maxCount = std::max<quint32>(1, *std::max_element(histogram.begin(), histogram.end()));
+
+        lines.push_back("");
+        lines.push_back(title);
+        for (size_t bucket = 0; bucket < histogram.size(); ++bucket)
+        {
+            const auto count = histogram[bucket];
+            const auto barWidth = static_cast<qsizetype>(static_cast<quint64>(count) * BAR_WIDTH / maxCount);
+
+            lines.push_back(QString("  %1 %2 %3")
+                                .arg(bucketName(static_cast<qsizetype>(bucket)), -8)
+                                .arg(count, 8)
+                                .arg(QString(barWidth, QChar(0x2588))));
+        }
+    };
+
+    addHistogram("Delta:", statistic.delta, DetectStatistics::deltaBucketName);
+    addHistogram("Volume:", statistic.volume, DetectStatistics::volumeBucketName);
+
+    return lines.join('\n');
+}
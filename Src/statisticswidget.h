@@ -0,0 +1,55 @@
+#pragma once
+
+//STL
+#include <array>
+
+//Qt
+#include <QWidget>
+#include <QLabel>
+#include <QTimer>
+
+//My
+#include "detectstatistics.h"
+#include "exchangeregistry.h"
+
+/*!
+    Содержимое вкладки статистики детектирований: по колонке на каждое окно DetectStatistics с количеством
+    детектирований по биржам, самыми частыми символами и гистограммами дельты и объема.
+    Статистика перечитывается по таймеру только пока вкладка видна
+*/
+class StatisticsWidget
+    : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /*!
+        Конструктор
+        @param detectStatistics - статистика детектирований. Должна существовать все время жизни виджета
+        @param exchangeRegistry - справочник бирж. Должен существовать все время жизни виджета
+        @param parent - родительский виджет
+    */
+    StatisticsWidget(DetectStatistics& detectStatistics, ExchangeRegistry& exchangeRegistry, QWidget* parent);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private slots:
+    void updateTimerTimeout();
+
+private:
+    StatisticsWidget() = delete;
+    Q_DISABLE_COPY_MOVE(StatisticsWidget);
+
+    QString makeText(const DetectStatistics::Statistic& statistic);
+
+private:
+    DetectStatistics& _detectStatistics;
+    ExchangeRegistry& _exchangeRegistry;
+
+    std::array<QLabel*, static_cast<size_t>(DetectStatistics::EWindow::COUNT)> _labels = {};
+
+    QTimer* _updateTimer = nullptr;  ///< таймер обновления статистики
+
+};
@@ -0,0 +1,68 @@
+#include "stockexchangelistmodel.h"
+
+StockExchangeListModel::StockExchangeListModel(const QString& allName, ExchangeRegistry& exchangeRegistry, QObject* parent /* = nullptr */)
+    : QAbstractListModel(parent)
+    , _allName(allName)
+    , _exchangeRegistry(exchangeRegistry)
+{
+}
+
+int StockExchangeListModel::rowCount(const QModelIndex &parent /* = QModelIndex() */) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+
+    return static_cast<int>(_stockExchanges.size()) + 1;
+}
+
+QVariant StockExchangeListModel::data(const QModelIndex &index, int role /* = Qt::DisplayRole */) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+    {
+        return QVariant();
+    }
+
+    const auto row = index.row();
+    if (row == 0)
+    {
+        return role == Qt::DisplayRole || role == Qt::EditRole || role == STOCK_EXCHANGE_NAME_ROLE ? QVariant(_allName) : QVariant();
+    }
+
+    const auto& info = _exchangeRegistry.info(_stockExchanges[row - 1]);
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return info.displayName;
+    case STOCK_EXCHANGE_NAME_ROLE:
+        return info.name;
+    case Qt::DecorationRole:
+        return info.icon;
+    case STOCK_EXCHANGE_ID_ROLE:
+        return QVariant::fromValue(info.id);
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+void StockExchangeListModel::update()
+{
+    beginResetModel();
+
+    _stockExchanges = _exchangeRegistry.available();
+
+    endResetModel();
+}
+
+void StockExchangeListModel::clear()
+{
+    beginResetModel();
+
+    _stockExchanges.clear();
+
+    endResetModel();
+}
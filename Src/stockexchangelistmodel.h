@@ -0,0 +1,54 @@
+#pragma once
+
+//STL
+#include <vector>
+
+//Qt
+#include <QAbstractListModel>
+#include <QString>
+
+//My
+#include "exchangeregistry.h"
+
+/*!
+    Общий для всех строк таблиц фильтров список доступных бирж. Первая строка - "все биржи"
+*/
+class StockExchangeListModel
+    : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int STOCK_EXCHANGE_ID_ROLE = Qt::UserRole;        ///< ИД биржи в InternTable. Для первой строки - пустое значение
+    static constexpr int STOCK_EXCHANGE_NAME_ROLE = Qt::UserRole + 1;  ///< имя биржи как его передает сервер или allName для первой строки
+
+public:
+    /*!
+        Конструктор
+        @param allName - текст первой строки "все биржи"
+        @param exchangeRegistry - справочник бирж. Должен существовать все время жизни модели
+        @param parent - родительский объект
+    */
+    StockExchangeListModel(const QString& allName, ExchangeRegistry& exchangeRegistry, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /*!
+        Перечитывает список доступных бирж из справочника
+    */
+    void update();
+
+    void clear();
+
+private:
+    StockExchangeListModel() = delete;
+    Q_DISABLE_COPY_MOVE(StockExchangeListModel);
+
+private:
+    const QString _allName;
+    ExchangeRegistry& _exchangeRegistry;
+
+    std::vector<InternTable::ID> _stockExchanges;  ///< ИД бирж в порядке сортировки имен
+
+};
@@ -0,0 +1,139 @@
+//STL
+#include <algorithm>
+
+//My
+#include <TradingCatCommon/kline.h>
+
+#include "symbollistmodel.h"
+
+using namespace TradingCatCommon;
+
+static QString makeDisplayName(InternTable::ID symbolId)
+{
+    return KLineID(Symbol(InternTable::instance().symbolName(symbolId)), KLineType::MIN1).baseName();
+}
+
+SymbolListModel::SymbolListModel(const QString& allName, QObject* parent /* = nullptr */)
+    : QAbstractListModel(parent)
+    , _allName(allName)
+{
+}
+
+int SymbolListModel::rowCount(const QModelIndex &parent /* = QModelIndex() */) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+
+    return static_cast<int>(_symbols.size()) + 1;
+}
+
+QVariant SymbolListModel::data(const QModelIndex &index, int role /* = Qt::DisplayRole */) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+    {
+        return QVariant();
+    }
+
+    const auto row = index.row();
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return row == 0 ? _allName : _displayNames[row - 1];
+    case SYMBOL_NAME_ROLE:
+        return row == 0 ? _allName : InternTable::instance().symbolName(_symbols[row - 1]);
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+void SymbolListModel::setSymbols(const std::vector<InternTable::ID> &symbols)
+{
+    auto& internTable = InternTable::instance();
+
+    beginResetModel();
+
+    //отмечаем доступные символы и берем их в порядке сортировки таблицы интернирования без повторной сортировки строк
+    _rows.assign(internTable.symbolsCount(), -1);
+    for (const auto symbolId: symbols)
+    {
+        _rows[symbolId] = 0;
+    }
+
+    _symbols.clear();
+    _displayNames.clear();
+    _symbols.reserve(symbols.size());
+    _displayNames.reserve(symbols.size());
+
+    for (const auto symbolId: internTable.sortedSymbols())
+    {
+        if (_rows[symbolId] == -1)
+        {
+            continue;
+        }
+
+        _symbols.push_back(symbolId);
+        _displayNames.push_back(makeDisplayName(symbolId));
+        _rows[symbolId] = static_cast<int>(_symbols.size());
+    }
+
+    endResetModel();
+}
+
+int SymbolListModel::ensureSymbol(InternTable::ID symbolId)
+{
+    auto& internTable = InternTable::instance();
+
+    if (symbolId < _rows.size() && _rows[symbolId] != -1)
+    {
+        return _rows[symbolId];
+    }
+
+    if (symbolId >= _rows.size())
+    {
+        _rows.resize(internTable.symbolsCount(), -1);
+    }
+
+    const auto& symbolName = internTable.symbolName(symbolId);
+    const auto it_symbols = std::lower_bound(_symbols.begin(), _symbols.end(), symbolName,
+                                             [&internTable](InternTable::ID id, const QString& name)
+                                             {
+                                                 return internTable.symbolName(id) < name;
+                                             });
+    const auto position = static_cast<int>(std::distance(_symbols.begin(), it_symbols));
+    const auto row = position + 1;
+
+    beginInsertRows(QModelIndex(), row, row);
+
+    _symbols.insert(it_symbols, symbolId);
+    _displayNames.insert(_displayNames.begin() + position, makeDisplayName(symbolId));
+
+    for (auto index = position; index < static_cast<int>(_symbols.size()); ++index)
+    {
+        _rows[_symbols[index]] = index + 1;
+    }
+
+    endInsertRows();
+
+    return row;
+}
+
+void SymbolListModel::clear()
+{
+    beginResetModel();
+
+    _symbols.clear();
+    _displayNames.clear();
+    _rows.clear();
+
+    endResetModel();
+}
+
+const QString &SymbolListModel::allName() const noexcept
+{
+    return _allName;
+}
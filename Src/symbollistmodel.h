@@ -0,0 +1,65 @@
+#pragma once
+
+//STL
+#include <vector>
+
+//Qt
+#include <QAbstractListModel>
+#include <QString>
+
+//My
+#include "interntable.h"
+
+/*!
+    Общий для всех строк таблиц фильтров каталог символов MIN1 свечей всех бирж без повторов, отсортированный по имени.
+    Первая строка - "все символы". Строится один раз при обновлении каталога, редакторы строк таблиц
+    используют эту модель без копирования
+*/
+class SymbolListModel
+    : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int SYMBOL_NAME_ROLE = Qt::UserRole;  ///< имя символа или allName() для первой строки
+
+public:
+    /*!
+        Конструктор
+        @param allName - текст первой строки "все символы"
+        @param parent - родительский объект
+    */
+    explicit SymbolListModel(const QString& allName, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /*!
+        Заменяет каталог символов
+        @param symbols - ИД символов без повторов в любом порядке
+    */
+    void setSymbols(const std::vector<InternTable::ID>& symbols);
+
+    /*!
+        Добавляет символ, если его еще нет в каталоге (например, символ из сохраненного черного списка)
+        @param symbolId - ИД символа
+        @return номер строки символа
+    */
+    int ensureSymbol(InternTable::ID symbolId);
+
+    void clear();
+
+    const QString& allName() const noexcept;
+
+private:
+    SymbolListModel() = delete;
+    Q_DISABLE_COPY_MOVE(SymbolListModel);
+
+private:
+    const QString _allName;
+
+    std::vector<InternTable::ID> _symbols;    ///< ИД символов в порядке сортировки имен
+    std::vector<QString> _displayNames;       ///< отображаемые имена символов
+    std::vector<int> _rows;                   ///< номер строки по ИД символа. -1 - символа нет в каталоге
+
+};
@@ -1,4 +1,4 @@
-QT = core network gui charts
+QT = core network gui widgets
 
 TARGET = TradingCatClient
 TEMPLATE = app
@@ -11,15 +11,67 @@ VERSION = 0.1
 HEADERS += \
     $$PWD/Src/localconfig.h \
     $$PWD/Src/mainwindow.h \
+    Src/candlestickchart.h \
+    Src/chartdatacache.h \
+    Src/correlationgrouper.h \
+    Src/detectexporter.h \
+    Src/detectjournal.h \
+    Src/detectrules.h \
+    Src/detectstatistics.h \
+    Src/eventfiltermodel.h \
+    Src/eventlistdelegate.h \
     Src/eventlistmenu.h \
-    Src/networkcore.h
+    Src/eventlistmodel.h \
+    Src/eventsearchindex.h \
+    Src/exchangeregistry.h \
+    Src/fontloader.h \
+    Src/indicatorengine.h \
+    Src/interntable.h \
+    Src/journallistmodel.h \
+    Src/journalwidget.h \
+    Src/klinebuffer.h \
+    Src/multipanechart.h \
+    Src/networkcore.h \
+    Src/profiler.h \
+    Src/profileroverlay.h \
+    Src/repeatdetector.h \
+    Src/sessionstore.h \
+    Src/statisticswidget.h \
+    Src/stockexchangelistmodel.h \
+    Src/symbollistmodel.h
 
 SOURCES += \
     $$PWD/Src/main.cpp \
     $$PWD/Src/localconfig.cpp \
     $$PWD/Src/mainwindow.cpp \
+    Src/candlestickchart.cpp \
+    Src/chartdatacache.cpp \
+    Src/correlationgrouper.cpp \
+    Src/detectexporter.cpp \
+    Src/detectjournal.cpp \
+    Src/detectrules.cpp \
+    Src/detectstatistics.cpp \
+    Src/eventfiltermodel.cpp \
+    Src/eventlistdelegate.cpp \
     Src/eventlistmenu.cpp \
-    Src/networkcore.cpp
+    Src/eventlistmodel.cpp \
+    Src/eventsearchindex.cpp \
+    Src/exchangeregistry.cpp \
+    Src/fontloader.cpp \
+    Src/indicatorengine.cpp \
+    Src/interntable.cpp \
+    Src/journallistmodel.cpp \
+    Src/journalwidget.cpp \
+    Src/klinebuffer.cpp \
+    Src/multipanechart.cpp \
+    Src/networkcore.cpp \
+    Src/profiler.cpp \
+    Src/profileroverlay.cpp \
+    Src/repeatdetector.cpp \
+    Src/sessionstore.cpp \
+    Src/statisticswidget.cpp \
+    Src/stockexchangelistmodel.cpp \
+    Src/symbollistmodel.cpp
 
 FORMS += \
     $$PWD/Src/mainwindow.ui \
@@ -28,6 +80,13 @@ FORMS += \
 RESOURCES += \
     $$PWD/Src/resurce.qrc
 
+#CJK font is loaded at runtime from the font directory next to the application page (see FontLoader)
+CJK_FONT = $$PWD/Src/font/NotoSansCJK-Regular.ttc
+!exists($$CJK_FONT): warning("$$CJK_FONT not found. CJK symbol names will be shown with the default font")
+cjkfont.files = $$CJK_FONT
+cjkfont.path = $$OUT_PWD/font
+COPIES += cjkfont
+
 QMAKE_CXXFLAGS += -oz -flto -fexceptions
 QMAKE_LFLAGS += -flto -fexceptions
 